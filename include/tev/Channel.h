@@ -9,11 +9,17 @@
 #include <nanogui/vector.h>
 
 #include <future>
+#include <memory>
 #include <string>
 #include <vector>
 
 namespace tev {
 
+enum EPixelFormat : int {
+    F32 = 0,
+    F16,
+};
+
 class Channel {
 public:
     static std::pair<std::string, std::string> split(const std::string& fullChannel);
@@ -26,21 +32,49 @@ public:
 
     static nanogui::Color color(std::string fullChannel);
 
-    Channel(const std::string& name, const nanogui::Vector2i& size);
+    static bool halfPrecisionStorage();
+    static void setHalfPrecisionStorage(bool value);
+
+    // A lazily created channel records only metadata; its zero-filled pixel
+    // buffer is allocated by materialize() on the first write, while reads
+    // through eval() yield zero until then.
+    Channel(const std::string& name, const nanogui::Vector2i& size, EPixelFormat format = EPixelFormat::F32, bool lazy = false);
 
     const std::string& name() const {
         return mName;
     }
 
+    EPixelFormat format() const {
+        return mFormat;
+    }
+
+    // Only valid for channels with float storage. Half-precision channels
+    // must be read through eval()/at() or promoted via ensureFloatStorage().
     const std::vector<float>& data() const {
-        return mData;
+        return *mData;
+    }
+
+    // Mutable buffer access detaches copy-on-write storage first; see
+    // shareDataFrom().
+    std::vector<float>& data() {
+        detach();
+        return *mData;
+    }
+
+    std::vector<uint16_t>& halfData() {
+        detach();
+        return *mDataHalf;
+    }
+
+    const std::vector<uint16_t>& halfData() const {
+        return *mDataHalf;
     }
 
     float eval(size_t index) const {
-        if (index >= mData.size()) {
+        if (index >= numPixels()) {
             return 0;
         }
-        return mData[index];
+        return at(index);
     }
 
     float eval(nanogui::Vector2i index) const {
@@ -49,15 +83,22 @@ public:
             return 0;
         }
 
-        return mData[index.x() + index.y() * mSize.x()];
+        // Checked against the buffer size rather than via at(): an evicted
+        // image keeps its size metadata but has no pixel data.
+        return eval((size_t)index.x() + index.y() * mSize.x());
     }
 
+    // Mutable access requires float storage that is not shared with another
+    // channel; ensureFloatStorage() establishes both.
     float& at(size_t index) {
-        return mData[index];
+        return (*mData)[index];
     }
 
     float at(size_t index) const {
-        return mData[index];
+        if (mFormat == EPixelFormat::F16) {
+            return halfToFloat((*mDataHalf)[index]);
+        }
+        return (*mData)[index];
     }
 
     float& at(nanogui::Vector2i index) {
@@ -69,41 +110,106 @@ public:
     }
 
     size_t numPixels() const {
-        return mData.size();
+        return mFormat == EPixelFormat::F16 ? mDataHalf->size() : mData->size();
+    }
+
+    size_t memoryUsage() const {
+        return mData->capacity() * sizeof(float) + mDataHalf->capacity() * sizeof(uint16_t);
+    }
+
+    // Releases the pixel buffers while keeping name, size, and format, e.g.
+    // when the owning image is evicted from memory.
+    void dropPixelData() {
+        mData = std::make_shared<std::vector<float>>();
+        mDataHalf = std::make_shared<std::vector<uint16_t>>();
+    }
+
+    // Aliases `other`'s pixel buffer instead of copying it. The share is
+    // copy-on-write: the next mutating access to either channel detaches.
+    void shareDataFrom(const Channel& other) {
+        TEV_ASSERT(mSize == other.mSize, "Can only share pixel data between equally sized channels.");
+        mFormat = other.mFormat;
+        mData = other.mData;
+        mDataHalf = other.mDataHalf;
+    }
+
+    // Whether the pixel buffers are allocated. Lazily created channels and
+    // channels of evicted images are unmaterialized; they read as zero.
+    bool materialized() const {
+        return numPixels() == (size_t)mSize.x() * mSize.y();
+    }
+
+    void materialize() {
+        if (materialized()) {
+            return;
+        }
+
+        detach();
+
+        size_t n = (size_t)mSize.x() * mSize.y();
+        if (mFormat == EPixelFormat::F16) {
+            mDataHalf->resize(n);
+        } else {
+            mData->resize(n);
+        }
     }
 
     const nanogui::Vector2i& size() const {
         return mSize;
     }
 
-    std::tuple<float, float, float> minMaxMean() const {
-        float min = std::numeric_limits<float>::infinity();
-        float max = -std::numeric_limits<float>::infinity();
-        float mean = 0;
-        for (float f : mData) {
-            mean += f;
-            if (f < min) {
-                min = f;
-            }
-            if (f > max) {
-                max = f;
-            }
-        }
-        return {min, max, mean/numPixels()};
+    // Parallel reduction over all pixels. Each task sweeps a contiguous slice
+    // and accumulates its sum with compensation, so the mean does not drift on
+    // channels with tens of millions of pixels.
+    Task<std::tuple<float, float, float>> minMaxMeanAsync(int priority) const;
+
+    std::tuple<float, float, float> minMaxMean(int priority = std::numeric_limits<int>::max()) const {
+        return minMaxMeanAsync(priority).get();
     }
 
     Task<void> divideByAsync(const Channel& other, int priority);
 
     Task<void> multiplyWithAsync(const Channel& other, int priority);
 
-    void setZero() { memset(mData.data(), 0, mData.size()*sizeof(float)); }
+    // Converts half-precision storage to float storage in place.
+    // Must be called before mutating a channel through at()/data().
+    void ensureFloatStorage();
 
-    void updateTile(int x, int y, int width, int height, const std::vector<float>& newData);
+    void setZero() {
+        detach();
+        if (mFormat == EPixelFormat::F16) {
+            memset(mDataHalf->data(), 0, mDataHalf->size()*sizeof(uint16_t));
+        } else {
+            memset(mData->data(), 0, mData->size()*sizeof(float));
+        }
+    }
+
+    // Copies a tile of pixels into the channel. The source pointer must
+    // already be offset to the tile's first pixel; successive pixels are
+    // `stride` elements apart, allowing reads directly from interleaved data.
+    void updateTile(int x, int y, int width, int height, const float* newData, int64_t stride = 1);
 
 private:
+    // Unshares the pixel buffers if they are aliased by another channel.
+    void detach() {
+        if (mData.use_count() > 1) {
+            mData = std::make_shared<std::vector<float>>(*mData);
+        }
+        if (mDataHalf.use_count() > 1) {
+            mDataHalf = std::make_shared<std::vector<uint16_t>>(*mDataHalf);
+        }
+    }
+
+    static bool sHalfPrecisionStorage;
+
     std::string mName;
     nanogui::Vector2i mSize;
-    std::vector<float> mData;
+    EPixelFormat mFormat;
+
+    // Pixel buffers are refcounted so that channels derived from one another
+    // (see shareDataFrom()) alias a single allocation until written to.
+    std::shared_ptr<std::vector<float>> mData;
+    std::shared_ptr<std::vector<uint16_t>> mDataHalf;
 };
 
 }
@@ -12,6 +12,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstring>
 #include <filesystem>
 #include <functional>
 #include <string>
@@ -201,6 +202,89 @@ inline float swapBytes(float value) {
     return result;
 }
 
+// Conversion between IEEE 754 binary16 (as stored, e.g., by half-precision EXR files)
+// and binary32. Conversions to half round to nearest, ties to even, and overflow to infinity,
+// matching the behavior of Imath's half type.
+inline float halfToFloat(uint16_t half) {
+    uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1f;
+    uint32_t mantissa = half & 0x3ff;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            // Signed zero
+            bits = sign;
+        } else {
+            // Subnormal half; normalize it for the wider float exponent range
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x400) == 0) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            mantissa &= 0x3ff;
+            bits = sign | (exponent << 23) | (mantissa << 13);
+        }
+    } else if (exponent == 0x1f) {
+        // Infinity or NaN
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+inline uint16_t floatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int32_t exponent = (int32_t)((bits >> 23) & 0xff) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    if (((bits >> 23) & 0xff) == 0xff) {
+        // Infinity or NaN; preserve NaN-ness in the (truncated) mantissa
+        return (uint16_t)(sign | 0x7c00 | (mantissa ? 0x200 : 0));
+    }
+
+    if (exponent >= 0x1f) {
+        // Magnitude too large for half; overflow to infinity
+        return (uint16_t)(sign | 0x7c00);
+    }
+
+    if (exponent <= 0) {
+        if (exponent < -10) {
+            // Magnitude too small even for a subnormal half; underflow to zero
+            return (uint16_t)sign;
+        }
+
+        mantissa |= 0x800000;
+        uint32_t shift = (uint32_t)(14 - exponent);
+        uint16_t result = (uint16_t)(sign | (mantissa >> shift));
+
+        uint32_t rest = mantissa & ((1u << shift) - 1);
+        if (rest > (1u << (shift - 1)) || (rest == (1u << (shift - 1)) && (result & 1))) {
+            ++result;
+        }
+
+        return result;
+    }
+
+    uint16_t result = (uint16_t)(sign | (exponent << 10) | (mantissa >> 13));
+
+    // If rounding overflows the mantissa, it carries into the exponent, which happens
+    // to be exactly the desired behavior (including a potential overflow to infinity).
+    uint32_t rest = mantissa & 0x1fff;
+    if (rest > 0x1000 || (rest == 0x1000 && (result & 1))) {
+        ++result;
+    }
+
+    return result;
+}
+
 inline int codePointLength(char first) {
     if ((first & 0xf8) == 0xf0) {
         return 4;
@@ -321,6 +405,20 @@ std::vector<std::string> split(std::string text, const std::string& delim);
 std::string toLower(std::string str);
 std::string toUpper(std::string str);
 
+// A selector compiled once for matching against many candidates: the filter
+// is lowercased and tokenized up front, so each match only lowercases the
+// candidate and runs substring searches. Use this instead of matchesFuzzy()
+// when the same selector applies to every channel of a load.
+class FuzzyMatcher {
+public:
+    explicit FuzzyMatcher(const std::string& filter);
+
+    bool matches(const std::string& text, size_t* matchedPartId = nullptr) const;
+
+private:
+    std::vector<std::string> mWords;
+};
+
 bool matchesFuzzy(std::string text, std::string filter, size_t* matchedPartId = nullptr);
 bool matchesRegex(std::string text, std::string filter);
 inline bool matchesFuzzyOrRegex(const std::string& text, const std::string& filter, bool isRegex) {
@@ -371,6 +469,17 @@ enum ETonemap : int {
 
 ETonemap toTonemap(std::string name);
 
+// Colormap used by the false-color tonemap; see tev/FalseColor.h for the data.
+enum EColorMap : int {
+    Turbo = 0,
+    Viridis,
+    Inferno,
+
+    // This enum value should never be used directly.
+    // It facilitates looping over all members of this enum.
+    NumColorMaps,
+};
+
 enum EMetric : int {
     Error = 0,
     AbsoluteError,
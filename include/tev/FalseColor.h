@@ -5,15 +5,17 @@
 
 #include <tev/Common.h>
 
-#include <deque>
-#include <mutex>
-#include <condition_variable>
+#include <array>
 
 namespace tev {
 
 namespace colormap {
-    const std::vector<float>& turbo();
-    const std::vector<float>& viridis();
+    // Each map is sampled at 256 points with 4 floats (RGBA) per sample —
+    // exactly the layout of the 1D LUT textures sampled by UberShader.
+    constexpr size_t NumColorMapSamples = 256;
+    using ColorMapData = std::array<float, 4 * NumColorMapSamples>;
+
+    const ColorMapData& data(EColorMap map);
 }
 
 }
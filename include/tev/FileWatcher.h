@@ -0,0 +1,82 @@
+// This file was developed by Thomas Müller <thomas94@gmx.net>.
+// It is published under the BSD 3-Clause License within the LICENSE file.
+
+#pragma once
+
+#include <tev/Common.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace tev {
+
+// Watches directories for changes using the platform's native filesystem
+// event API -- inotify on Linux, kqueue on macOS/BSD, ReadDirectoryChangesW
+// on Windows -- rather than periodic re-enumeration. The callback is invoked
+// on a background thread with the directory in which a change occurred.
+// Events may be dropped or coalesced under load, so a callback means "rescan
+// this directory", never a precise delta.
+class FileWatcher {
+public:
+    using Callback = std::function<void(const fs::path&)>;
+
+    // Returns nullptr if the platform has no native backend (or setting it up
+    // failed), in which case the caller should fall back to polling.
+    static std::unique_ptr<FileWatcher> create(Callback callback);
+
+    ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    // Subscribes to changes within `dir` and, if `recursive`, within its
+    // current and future subdirectories.
+    void watch(const fs::path& dir, bool recursive);
+
+private:
+    FileWatcher(Callback callback);
+
+    void watcherLoop();
+
+    Callback mCallback;
+    std::thread mThread;
+    std::atomic<bool> mShallShutdown{false};
+
+#if defined(_WIN32)
+    struct DirectoryWatch {
+        HANDLE handle = INVALID_HANDLE_VALUE;
+        OVERLAPPED overlapped = {};
+        alignas(DWORD) char buffer[32 * 1024];
+        fs::path path;
+        bool recursive = false;
+    };
+
+    void issueRead(DirectoryWatch& watch);
+
+    HANDLE mIocp = nullptr;
+    std::mutex mWatchMutex;
+    std::vector<std::unique_ptr<DirectoryWatch>> mWatches;
+#elif defined(__linux__)
+    void addWatch(const fs::path& dir, bool recursive);
+
+    int mInotifyFd = -1;
+    int mWakeupFds[2] = {-1, -1};
+    std::mutex mWatchMutex;
+    std::map<int, std::pair<fs::path, bool>> mWatches; // watch descriptor -> (path, recursive)
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+    void addWatch(const fs::path& dir, bool recursive);
+
+    int mKqueueFd = -1;
+    std::mutex mWatchMutex;
+    std::map<int, std::pair<fs::path, bool>> mWatches; // directory fd -> (path, recursive)
+    std::set<fs::path> mWatchedPaths;
+#endif
+};
+
+}
@@ -5,6 +5,7 @@
 
 #include <tev/Box.h>
 #include <tev/Channel.h>
+#include <tev/FileWatcher.h>
 #include <tev/SharedQueue.h>
 #include <tev/ThreadPool.h>
 #include <tev/VectorGraphics.h>
@@ -12,11 +13,13 @@
 #include <nanogui/texture.h>
 
 #include <atomic>
+#include <chrono>
 #include <istream>
 #include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace tev {
@@ -30,6 +33,11 @@ struct ImageData {
 
     std::vector<Channel> channels;
     std::vector<std::string> layers;
+
+    // Index into `channels` by name. Built by rebuildChannelIndex() once the
+    // channel set is final; images with hundreds of AOVs would otherwise pay
+    // for a linear scan with full string comparisons on every lookup.
+    std::unordered_map<std::string, size_t> channelIndex;
     nanogui::Matrix4f toRec709 = nanogui::Matrix4f{1.0f}; // Identity by default
     bool hasPremultipliedAlpha;
 
@@ -54,6 +62,11 @@ struct ImageData {
 
     Task<void> convertToRec709(int priority);
 
+    // Fused load-time post-processing: applies the toRec709 matrix and the
+    // alpha premultiplication in a single sweep over each pixel tuple, and
+    // skips the sweep entirely when there is nothing to do.
+    Task<void> convertToRec709AndPremultiply(int priority);
+
     void alphaOperation(const std::function<void(Channel&, const Channel&)>& func);
 
     Task<void> multiplyAlpha(int priority);
@@ -66,6 +79,12 @@ struct ImageData {
     }
 
     const Channel* channel(const std::string& channelName) const {
+        if (channelIndex.size() == channels.size()) {
+            auto it = channelIndex.find(channelName);
+            return it != std::end(channelIndex) ? &channels[it->second] : nullptr;
+        }
+
+        // During loading, before the index exists, fall back to a linear scan.
         auto it = std::find_if(
             std::begin(channels),
             std::end(channels),
@@ -80,16 +99,14 @@ struct ImageData {
     }
 
     Channel* mutableChannel(const std::string& channelName) {
-        auto it = std::find_if(
-            std::begin(channels),
-            std::end(channels),
-            [&channelName](const Channel& c) { return c.name() == channelName; }
-        );
+        return const_cast<Channel*>(channel(channelName));
+    }
 
-        if (it != std::end(channels)) {
-            return &(*it);
-        } else {
-            return nullptr;
+    void rebuildChannelIndex() {
+        channelIndex.clear();
+        channelIndex.reserve(channels.size());
+        for (size_t i = 0; i < channels.size(); ++i) {
+            channelIndex.emplace(channels[i].name(), i);
         }
     }
 };
@@ -107,9 +124,30 @@ struct ImageTexture {
     nanogui::ref<nanogui::Texture> nanoguiTexture;
     std::vector<std::string> channels;
     bool mipmapDirty;
+    // True while the staging buffer is being interleaved on the thread pool;
+    // the texture holds no data yet and must not be drawn or sub-updated.
+    bool staging;
+    // Bounding box of channel updates not yet uploaded to the texture.
+    // Extended per incoming IPC tile and flushed in one sub-region upload
+    // when the texture is next drawn.
+    Box2i dirtyRegion;
+    // When the mip chain was last regenerated; see Image::texture() for the
+    // rate limiting applied while updates are streaming in.
+    std::chrono::steady_clock::time_point lastMipmapGeneration = {};
 };
 
-class Image {
+// A texture covering a sub-region of the image at a power-of-two downsampling,
+// used when the image is too large to upload in one piece. Tiles are uploaded
+// on demand and evicted least-recently-used once their combined size exceeds
+// the cache budget.
+struct ImageTile {
+    nanogui::ref<nanogui::Texture> nanoguiTexture;
+    std::vector<std::string> channels;
+    size_t sizeInBytes;
+    uint64_t lastUsed;
+};
+
+class Image : public std::enable_shared_from_this<Image> {
 public:
     Image(const fs::path& path, fs::file_time_type fileLastModified, ImageData&& data, const std::string& channelSelector);
     virtual ~Image();
@@ -144,10 +182,30 @@ public:
         return mData.channel(channelName);
     }
 
+    // Batched lookup for callers that resolve whole channel groups at once.
+    // Entries of the result are null where no channel of the given name exists.
+    std::vector<const Channel*> channels(const std::vector<std::string>& channelNames) const {
+        std::vector<const Channel*> result;
+        result.reserve(channelNames.size());
+        for (const auto& channelName : channelNames) {
+            result.push_back(mData.channel(channelName));
+        }
+        return result;
+    }
+
+    // Returns the texture for the given channels, or null while its staging
+    // buffer is still being interleaved on the thread pool — the caller draws
+    // a placeholder and is redrawn once the upload has landed.
     nanogui::Texture* texture(const std::string& channelGroupName);
     nanogui::Texture* texture(const std::vector<std::string>& channelNames);
 
-    std::vector<std::string> channelsInGroup(const std::string& groupName) const;
+    // Texture for the pixels in [region.min, region.max), which must lie
+    // within the image, downsampled by `stride` (a power of two; each texel
+    // box-averages stride×stride pixels). Uploaded on first use and cached;
+    // see ImageTile.
+    nanogui::Texture* tileTexture(const std::vector<std::string>& channelNames, const Box2i& region, int stride);
+
+    const std::vector<std::string>& channelsInGroup(const std::string& groupName) const;
     void decomposeChannelGroup(const std::string& groupName);
 
     std::vector<std::string> getSortedChannels(const std::string& layerName) const;
@@ -198,7 +256,59 @@ public:
         return sId++;
     }
 
-    void updateChannel(const std::string& channelName, int x, int y, int width, int height, const std::vector<float>& data);
+    void updateChannel(const std::string& channelName, int x, int y, int width, int height, const float* data, int64_t stride = 1);
+
+    // Compares `replacement`'s pixels against this image's and copies over
+    // only the tiles that differ, keeping the existing textures alive so that
+    // just the changed regions are re-uploaded. Returns false if the two
+    // images are not laid out identically (size, channels, or pixel formats
+    // differ), in which case the caller must swap in `replacement` wholesale.
+    bool tryApplyDifferentialUpdate(const Image& replacement);
+
+    // Total CPU and GPU memory footprint of the image's pixel data and
+    // textures.
+    size_t memoryUsage() const;
+
+    // Drops the pixel data and textures while keeping metadata (name, channel
+    // layout, groups), such that the image can be transparently reloaded from
+    // its path on next access. Main thread only, since textures are freed.
+    void evict();
+
+    bool isEvicted() const {
+        return mIsEvicted;
+    }
+
+    // Whether a thread-pool task is still interleaving this image's channel
+    // data into a staging buffer; eviction must wait for it.
+    bool hasStagingTextures() const {
+        for (const auto& kv : mTextures) {
+            if (kv.second.staging) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    // Deduplicates reloads of an evicted image: the first access schedules
+    // one and later accesses see it pending.
+    bool evictionReloadScheduled() const {
+        return mEvictionReloadScheduled;
+    }
+
+    void setEvictionReloadScheduled() {
+        mEvictionReloadScheduled = true;
+    }
+
+    // Monotonic counter of when the image was last viewed; the least recently
+    // used images are evicted first when over the memory budget.
+    uint64_t lastUsed() const {
+        return mLastUsed;
+    }
+
+    void setLastUsed(uint64_t value) {
+        mLastUsed = value;
+    }
 
     void updateVectorGraphics(bool append, const std::vector<VgCommand>& commands);
 
@@ -206,6 +316,14 @@ public:
         return mVgCommands;
     }
 
+    // Retained tessellation of mVgCommands, maintained incrementally by
+    // updateVectorGraphics(). When supported() it is drawn through
+    // VectorGraphicsShader; otherwise the command list above is replayed
+    // through NanoVG.
+    const VgBatch& vgBatch() const {
+        return mVgBatch;
+    }
+
     void setStaleIdCallback(const std::function<void(int)>& callback) {
         mStaleIdCallback = callback;
     }
@@ -219,8 +337,25 @@ private:
         return mData.mutableChannel(channelName);
     }
 
+    // Uploads a finished staging buffer to its texture. Main thread only.
+    void finishStagedUpload(const std::string& lookup, const uint8_t* data);
+
+    // Interleaves and uploads the texture's dirty region in a single
+    // sub-region upload. Main thread only.
+    void flushTextureUpdates(ImageTexture& imageTexture);
+
+    // Records that `channelName`'s pixels within the given region changed:
+    // drops cached tile textures and extends the dirty regions of affected
+    // full textures.
+    void markChannelRegionUpdated(const std::string& channelName, int x, int y, int width, int height);
+
     std::vector<ChannelGroup> getGroupedChannels(const std::string& layerName) const;
 
+    // mChannelGroups only changes structurally in the constructor and in
+    // decomposeChannelGroup, so the lookup index is rebuilt there and group
+    // resolution on the per-frame path is a single hash lookup.
+    void rebuildChannelGroupIndex();
+
     fs::path mPath;
     fs::file_time_type mFileLastModified;
 
@@ -230,11 +365,26 @@ private:
 
     std::map<std::string, ImageTexture> mTextures;
 
+    std::map<std::string, ImageTile> mTileTextures;
+    uint64_t mTileUseCounter = 0;
+
+    // Staging buffers for flushTextureUpdates(), reused across updates. They
+    // grow to the largest flushed region; reallocating per streamed IPC tile
+    // was measurable churn.
+    std::vector<float> mUpdateStagingBuffer;
+    std::vector<uint16_t> mUpdateStagingBufferHalf;
+
     ImageData mData;
 
+    bool mIsEvicted = false;
+    bool mEvictionReloadScheduled = false;
+    uint64_t mLastUsed = 0;
+
     std::vector<ChannelGroup> mChannelGroups;
+    std::unordered_map<std::string, size_t> mChannelGroupIndex;
 
     std::vector<VgCommand> mVgCommands;
+    VgBatch mVgBatch;
 
     std::function<void(int)> mStaleIdCallback;
 
@@ -251,12 +401,6 @@ struct ImageAddition {
     bool shallSelect;
     std::vector<std::shared_ptr<Image>> images;
     std::shared_ptr<Image> toReplace;
-
-    struct Comparator {
-        bool operator()(const ImageAddition& a, const ImageAddition& b) {
-            return a.loadId > b.loadId;
-        }
-    };
 };
 
 struct PathAndChannelSelector {
@@ -288,14 +432,22 @@ public:
         mRecursiveDirectories = value;
     }
 
+    bool hasNativeFileWatcher() const {
+        return mFileWatcher != nullptr;
+    }
+
 private:
-    SharedQueue<ImageAddition> mLoadedImages;
+    void watchDirectory(const fs::path& dir);
+    void scanDirectoryForNewFiles(const fs::path& dir, const std::set<std::string>& channelSelectors);
+
+    // Lock-free handoff to the UI thread: popping never contends with the
+    // loader threads publishing finished images.
+    MpscQueue<ImageAddition> mLoadedImages;
 
-    std::priority_queue<
-        ImageAddition,
-        std::vector<ImageAddition>,
-        ImageAddition::Comparator
-    > mPendingLoadedImages;
+    // Finished loads waiting for their predecessors (by load id) to finish,
+    // such that images are published in the order they were requested. Only
+    // loader threads touch this, never the UI thread.
+    std::map<int, ImageAddition> mPendingLoadedImages;
     std::mutex mPendingLoadedImagesMutex;
 
     std::atomic<int> mLoadCounter{0};
@@ -304,6 +456,14 @@ private:
     bool mRecursiveDirectories = false;
     std::map<fs::path, std::set<std::string>> mDirectories;
     std::set<PathAndChannelSelector> mFilesFoundInDirectories;
+
+    // Native filesystem-event watching. While it is active, only directories
+    // with actual events get rescanned; if it is unavailable, the periodic
+    // full poll remains.
+    std::unique_ptr<FileWatcher> mFileWatcher;
+    bool mFileWatcherFailed = false;
+    std::mutex mDirtyDirectoriesMutex;
+    std::set<fs::path> mDirtyDirectories;
 };
 
 }
@@ -0,0 +1,31 @@
+// This file was developed by Thomas Müller <thomas94@gmx.net>.
+// It is published under the BSD 3-Clause License within the LICENSE file.
+
+#pragma once
+
+#include <tev/Common.h>
+
+#include <nanogui/widget.h>
+
+namespace tev {
+
+// Vertical list of uniformly sized ImageButtons that scales to thousands of
+// entries. A generic BoxLayout measures the preferred size of every child on
+// each layout pass (a text-bounds computation per button), and nanogui draws
+// every child even when a scroll panel clips all but a screenful of them.
+// This container instead measures a single button, positions the rest
+// arithmetically, and culls children that fall outside the screen when
+// drawing, so layout and draw cost scale with the visible window rather than
+// with the session's image count.
+class ImageButtonContainer : public nanogui::Widget {
+public:
+    ImageButtonContainer(nanogui::Widget* parent);
+
+    nanogui::Vector2i preferred_size(NVGcontext* ctx) const override;
+
+    void perform_layout(NVGcontext* ctx) override;
+
+    void draw(NVGcontext* ctx) override;
+};
+
+}
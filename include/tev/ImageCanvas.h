@@ -6,6 +6,7 @@
 #include <tev/UberShader.h>
 #include <tev/Image.h>
 #include <tev/Lazy.h>
+#include <tev/VectorGraphicsShader.h>
 
 #include <nanogui/canvas.h>
 
@@ -17,9 +18,11 @@ struct CanvasStatistics {
     float mean;
     float maximum;
     float minimum;
+    // Raw per-channel bin counts in symmetric-log space over
+    // [minimum, maximum], finer than displayed; MultiGraph re-bins them
+    // under the current exposure/offset.
     std::vector<float> histogram;
     int nChannels;
-    int histogramZero;
 };
 
 class ImageCanvas : public nanogui::Canvas {
@@ -81,9 +84,18 @@ public:
         mTonemap = tonemap;
     }
 
-    static nanogui::Vector3f applyTonemap(const nanogui::Vector3f& value, float gamma, ETonemap tonemap);
+    static nanogui::Vector3f applyTonemap(const nanogui::Vector3f& value, float gamma, ETonemap tonemap, EColorMap colorMap);
     nanogui::Vector3f applyTonemap(const nanogui::Vector3f& value) const {
-        return applyTonemap(value, mGamma, mTonemap);
+        return applyTonemap(value, mGamma, mTonemap, mColorMap);
+    }
+
+    EColorMap colorMap() const {
+        return mColorMap;
+    }
+
+    void setColorMap(EColorMap colorMap) {
+        mColorMap = colorMap;
+        mShader->setColorMap(colorMap);
     }
 
     EMetric metric() const {
@@ -118,32 +130,101 @@ public:
         return mClipToLdr;
     }
 
+    // When enabled, canvas statistics are computed over (a quantized superset of)
+    // the currently visible region rather than the entire image.
+    void setStatisticsOnVisibleRegion(bool value) {
+        mStatisticsOnVisibleRegion = value;
+    }
+
+    bool statisticsOnVisibleRegion() const {
+        return mStatisticsOnVisibleRegion;
+    }
+
     std::vector<float> getHdrImageData(bool divideAlpha, int priority) const;
-    std::vector<char> getLdrImageData(bool divideAlpha, int priority) const;
 
-    void saveImage(const fs::path& filename) const;
+    // `dither` applies ordered dithering during 8-bit quantization, which
+    // hides banding in smooth gradients at the cost of faint noise.
+    std::vector<char> getLdrImageData(bool divideAlpha, int priority, bool dither = true) const;
+
+    // Streaming counterparts of the above for savers that write incrementally:
+    // the returned callback interleaves (and for LDR, tonemaps) the requested
+    // scanline batch on the fly, so no full-image staging copy is needed.
+    // Returns a null callback if no image is displayed.
+    std::function<void(float*, int, int)> getHdrImageDataRowSource(bool divideAlpha, int priority) const;
+    std::function<void(char*, int, int)> getLdrImageDataRowSource(bool divideAlpha, int priority, bool dither = true) const;
+
+    // Stateless variant of getLdrImageDataRowSource for callers without a
+    // canvas — notably the headless batch mode in main.cpp. All display state
+    // is passed explicitly instead of being read from the widget.
+    static std::function<void(char*, int, int)> ldrImageDataRowSource(
+        std::shared_ptr<Image> image,
+        std::shared_ptr<Image> reference,
+        const std::string& requestedChannelGroup,
+        EMetric metric,
+        float exposure,
+        float offset,
+        float gamma,
+        ETonemap tonemap,
+        EColorMap colorMap,
+        bool divideAlpha,
+        int priority,
+        bool dither = true
+    );
+
+    // Runs the export — channel flattening, tonemapping, encoding, and the
+    // disk write — on the I/O thread pool, so the UI keeps rendering while
+    // the save is in flight. Queued saves run one after another.
+    Task<void> saveImage(fs::path filename) const;
 
     std::shared_ptr<Lazy<std::shared_ptr<CanvasStatistics>>> canvasStatistics();
 
     void purgeCanvasStatistics(int imageId);
 
-private:
-    static std::vector<Channel> channelsFromImages(
+    // A sampleStride of 1 computes exact statistics; larger strides evaluate a
+    // stratified subsample keeping every sampleStride-th pixel along each axis.
+    // Static and GL-free, so the headless batch mode uses it directly.
+    static Task<std::shared_ptr<CanvasStatistics>> computeCanvasStatistics(
         std::shared_ptr<Image> image,
         std::shared_ptr<Image> reference,
         const std::string& requestedChannelGroup,
         EMetric metric,
-        int priority
+        const Box2i& region,
+        int sampleStride,
+        int priority,
+        CancellationToken cancel = {}
     );
 
-    static Task<std::shared_ptr<CanvasStatistics>> computeCanvasStatistics(
+private:
+    static std::vector<Channel> channelsFromImages(
         std::shared_ptr<Image> image,
         std::shared_ptr<Image> reference,
         const std::string& requestedChannelGroup,
         EMetric metric,
-        int priority
+        const Box2i& region,
+        int sampleStride,
+        int priority,
+        CancellationToken cancel = {}
     );
 
+    // The region of the current image that is visible on screen, quantized
+    // outward to a coarse tile grid such that small pans map to the same region.
+    Box2i visibleStatisticsRegion();
+
+    // Whether the image is too large to be drawn through a single texture.
+    static bool shouldDrawTiled(const Image* image);
+
+    // Draws the image (and optionally a reference) as a grid of tiles whose
+    // textures are uploaded on demand; see Image::tileTexture().
+    void drawTiled(Image* image, Image* reference);
+
+    // The body of draw_contents(): image, reference, or checkerboard.
+    void drawImageAndReference();
+
+    // Draws the retained vector graphics batches of the current image and
+    // reference through VectorGraphicsShader. Command lists the batch cannot
+    // represent are instead replayed through NanoVG in draw().
+    void drawRetainedVectorGraphics();
+
     void drawPixelValuesAsText(NVGcontext *ctx);
     void drawCoordinateSystem(NVGcontext *ctx);
     void drawEdgeShadows(NVGcontext *ctx);
@@ -162,6 +243,7 @@ private:
     float mGamma = 2.2f;
 
     bool mClipToLdr = false;
+    bool mStatisticsOnVisibleRegion = false;
 
     std::shared_ptr<Image> mImage;
     std::shared_ptr<Image> mReference;
@@ -172,10 +254,41 @@ private:
 
     std::unique_ptr<UberShader> mShader;
 
+    // One shader instance per slot: each retains the GPU vertex buffers of
+    // the batch it most recently drew, so steady-state frames re-upload
+    // nothing.
+    std::unique_ptr<VectorGraphicsShader> mVgShaderImage;
+    std::unique_ptr<VectorGraphicsShader> mVgShaderReference;
+
     ETonemap mTonemap = SRGB;
+    EColorMap mColorMap = Turbo;
     EMetric mMetric = Error;
 
+    // Formatted strings of the zoomed-in pixel-value overlay, cached across
+    // frames; drawPixelValuesAsText() rebuilds them only when the displayed
+    // values can have changed, not when the view pans or zooms.
+    struct {
+        int imageId = -1;
+        int referenceId = -1;
+        std::string group;
+        EMetric metric = Error;
+        bool hex = false;
+        Box2i region;
+        std::vector<std::string> strings;
+    } mPixelTextCache;
+
     std::map<std::string, std::shared_ptr<Lazy<std::shared_ptr<CanvasStatistics>>>> mCanvasStatistics;
+
+    // Instant stratified-subsample estimates for huge regions. An entry here is
+    // served by canvasStatistics() only until the exact result under the same
+    // key in mCanvasStatistics becomes ready.
+    std::map<std::string, std::shared_ptr<Lazy<std::shared_ptr<CanvasStatistics>>>> mApproxCanvasStatistics;
+
+    // Cancellation handles for statistics computations that may still be in flight.
+    // Canceled entries of mCanvasStatistics hold partial results and are recomputed
+    // upon the next lookup of their key.
+    std::map<std::string, CancellationToken> mPendingCanvasStatistics;
+
     std::map<int, std::vector<std::string>> mImageIdToCanvasStatisticsKey;
 };
 
@@ -6,6 +6,7 @@
 #include <tev/HelpWindow.h>
 #include <tev/Image.h>
 #include <tev/ImageButton.h>
+#include <tev/ImageButtonContainer.h>
 #include <tev/ImageCanvas.h>
 #include <tev/Lazy.h>
 #include <tev/MultiGraph.h>
@@ -20,6 +21,7 @@
 #include <chrono>
 #include <memory>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 namespace tev {
@@ -74,7 +76,7 @@ public:
         const std::string& channel,
         int x, int y,
         int width, int height,
-        const std::vector<float>& imageData
+        const float* imageData, int64_t stride
     );
 
     void updateImageVectorGraphics(const std::string& imageName, bool shallSelect, bool append, const std::vector<VgCommand>& commands);
@@ -113,6 +115,12 @@ public:
 
     void setTonemap(ETonemap tonemap);
 
+    EColorMap colorMap() const {
+        return mImageCanvas->colorMap();
+    }
+
+    void setColorMap(EColorMap colorMap);
+
     EMetric metric() const {
         return mImageCanvas->metric();
     }
@@ -133,6 +141,11 @@ public:
     bool watchFilesForChanges() const;
     void setWatchFilesForChanges(bool value);
 
+    // Memory budget for loaded images in bytes; 0 disables eviction.
+    void setMemoryBudget(size_t bytes) {
+        mMemoryBudget = bytes;
+    }
+
     void maximize();
     bool isMaximized();
     void toggleMaximized();
@@ -177,6 +190,19 @@ private:
     std::shared_ptr<Image> nthVisibleImage(size_t n);
     std::shared_ptr<Image> imageByName(const std::string& imageName);
 
+    // Kicks off texture interleaving for the images next to the current one,
+    // such that stepping through a sequence hits already-warm textures. During
+    // playback, the window deepens ahead of the playhead to act as a
+    // decode-ahead ring in front of memory-budget eviction.
+    void prefetchNeighboringImages();
+
+    // While over the memory budget, evicts the least recently viewed images'
+    // pixel data and textures; they reload transparently on next access.
+    void enforceMemoryBudget();
+
+    // Bumps `image`'s LRU stamp and, if it was evicted, schedules its reload.
+    void touchImage(const std::shared_ptr<Image>& image);
+
     bool canDragSidebarFrom(const nanogui::Vector2i& p) {
         return mSidebar->visible() && p.x() - mSidebar->fixed_width() < 10 && p.x() - mSidebar->fixed_width() > -5;
     }
@@ -213,6 +239,8 @@ private:
     nanogui::Slider* mGammaSlider;
 
     nanogui::Widget* mTonemapButtonContainer;
+    // Null until constructed; setTonemap() runs once before it exists.
+    nanogui::Widget* mColorMapButtonContainer = nullptr;
     nanogui::Widget* mMetricButtonContainer;
 
     std::shared_ptr<BackgroundImagesLoader> mImagesLoader;
@@ -222,6 +250,11 @@ private:
 
     std::vector<std::shared_ptr<Image>> mImages;
 
+    // Name → image for constant-time resolution of IPC packets (UpdateImage,
+    // ReloadImage, CloseImage), which address their target by name. Kept in
+    // sync with mImages by insertImage/removeImage/removeAllImages.
+    std::unordered_map<std::string, std::shared_ptr<Image>> mImagesByName;
+
     MultiGraph* mHistogram;
     std::set<std::shared_ptr<Image>> mToBump;
 
@@ -231,6 +264,9 @@ private:
     nanogui::Button* mWatchFilesForChangesButton;
     std::chrono::steady_clock::time_point mLastFileChangesCheckTime = {};
 
+    size_t mMemoryBudget = 0;
+    uint64_t mImageUseCounter = 0;
+
     // Buttons which require a current image to be meaningful.
     std::vector<nanogui::Button*> mCurrentImageButtons;
 
@@ -241,7 +277,7 @@ private:
     nanogui::IntBox<int>* mFpsTextBox;
     std::chrono::steady_clock::time_point mLastPlaybackFrameTime = {};
 
-    nanogui::Widget* mImageButtonContainer;
+    ImageButtonContainer* mImageButtonContainer;
     nanogui::Widget* mScrollContent;
     nanogui::VScrollPanel* mImageScrollContainer;
 
@@ -6,7 +6,19 @@
 #include <tev/Common.h>
 #include <tev/VectorGraphics.h>
 
+#ifndef _WIN32
+#   include <sys/select.h>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
 #include <list>
+#include <map>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <type_traits>
 #include <vector>
 
 namespace tev {
@@ -22,15 +34,27 @@ struct IpcPacketReloadImage {
     bool grabFocus;
 };
 
+// Unlike the other interpreted packets, the update references memory owned
+// by the IpcPacket it was interpreted from rather than copying every
+// channel's pixel block: names are views into the payload and the pixel data
+// is a span of the strided block. The packet must outlive this struct.
 struct IpcPacketUpdateImage {
-    std::string imageName;
+    std::string_view imageName;
     bool grabFocus;
     int32_t nChannels;
-    std::vector<std::string> channelNames;
+    std::vector<std::string_view> channelNames;
     std::vector<int64_t> channelOffsets;
     std::vector<int64_t> channelStrides;
     int32_t x, y, width, height;
-    std::vector<std::vector<float>> imageData; // One set of data per channel
+    std::span<const float> stridedImageData; // Shared by all channels; indexed via the offsets and strides above.
+
+    // Set for UpdateImageShm packets, whose pixel block lives in a same-host
+    // shared-memory ring rather than in the packet. stridedImageData is empty
+    // in that case; the receiver resolves the ring by name and reads shmSize
+    // bytes at shmOffset.
+    std::string_view shmRingName;
+    uint64_t shmOffset = 0;
+    uint64_t shmSize = 0;
 };
 
 struct IpcPacketCloseImage {
@@ -53,6 +77,62 @@ struct IpcPacketVectorGraphics {
     std::vector<VgCommand> commands;
 };
 
+// A single-producer, single-consumer ring buffer in a named shared-memory
+// segment through which same-host clients push pixel blocks, leaving only
+// tiny control messages on the socket. Offsets handed to the consumer are
+// monotonically increasing byte counters; consumption must happen in push
+// order, which holds because both the socket's control messages and the UI
+// thread's task queue are FIFO.
+class SharedMemoryRing {
+public:
+    // Both return nullptr on failure (e.g. unsupported platform, name
+    // collision, or the segment having gone away), in which case callers fall
+    // back to the socket transport.
+    static std::unique_ptr<SharedMemoryRing> create(const std::string& name, size_t capacity);
+    static std::unique_ptr<SharedMemoryRing> open(const std::string& name);
+
+    ~SharedMemoryRing();
+
+    const std::string& name() const {
+        return mName;
+    }
+
+    // Producer: copies `size` bytes into the ring and yields their offset.
+    // Returns false when there is not enough free space.
+    bool push(const void* data, size_t size, uint64_t& offset);
+
+    // Consumer: pointer to previously pushed data, or nullptr when the range
+    // is out of bounds.
+    const char* at(uint64_t offset, size_t size) const;
+
+    // Consumer: releases everything up to and including [offset, offset + size).
+    void pop(uint64_t offset, size_t size);
+
+private:
+    // Lives at the start of the shared segment, followed by the data area.
+    // The atomics must be lock-free to be usable across processes.
+    struct Header {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t capacity;
+        std::atomic<uint64_t> head; // written by the producer
+        std::atomic<uint64_t> tail; // written by the consumer
+    };
+
+    SharedMemoryRing() = default;
+
+    std::string mName;
+    Header* mHeader = nullptr;
+    char* mData = nullptr;
+    bool mOwner = false;
+
+#ifdef _WIN32
+    HANDLE mFileMapping = NULL;
+#else
+    size_t mMappedSize = 0;
+#endif
+};
+
 class IpcPacket {
 public:
     enum EType : char {
@@ -65,6 +145,8 @@ public:
         UpdateImageV3 = 6, // Adds custom striding/offset support
         OpenImageV2 = 7, // Explicit separation of image name and channel selector
         VectorGraphics = 8,
+        UpdateImageShm = 9, // Like UpdateImageV3, but the pixel block lives in a same-host shared-memory ring
+        CompressedPacket = 10, // Envelope holding another, deflate-compressed packet; used on remote connections
     };
 
     IpcPacket() = default;
@@ -78,6 +160,13 @@ public:
         return mPayload.size();
     }
 
+    // An optional out-of-band segment that follows the serialized payload on
+    // the wire without ever being copied into it; see setUpdateImage(). The
+    // referenced memory must stay alive until the packet has been sent.
+    std::span<const char> auxiliaryPayload() const {
+        return mAuxiliaryPayload;
+    }
+
     EType type() const {
         // The first 4 bytes encode the message size.
         return (EType)mPayload[4];
@@ -96,6 +185,18 @@ public:
     void setCreateImage(const std::string& imageName, bool grabFocus, int32_t width, int32_t height, int32_t nChannels, const std::vector<std::string>& channelNames);
     void setVectorGraphics(const std::string& imageName, bool grabFocus, bool append, const std::vector<VgCommand>& commands);
 
+    // Derives a small UpdateImageShm control packet that references this
+    // packet's auxiliary pixel block at the given offset within a
+    // shared-memory ring instead of carrying it inline.
+    IpcPacket toShmReference(const std::string& ringName, uint64_t ringOffset) const;
+
+    // Envelopes this packet (including its auxiliary segment) in a
+    // CompressedPacket, and recovers the original from such an envelope.
+    // Remote clients use this to trade a little CPU for effective bandwidth;
+    // float pixel data typically shrinks several-fold.
+    IpcPacket compress() const;
+    IpcPacket decompress() const;
+
     IpcPacketOpenImage interpretAsOpenImage() const;
     IpcPacketReloadImage interpretAsReloadImage() const;
     IpcPacketCloseImage interpretAsCloseImage() const;
@@ -105,6 +206,7 @@ public:
 
 private:
     std::vector<char> mPayload;
+    std::span<const char> mAuxiliaryPayload;
 
     class IStream {
     public:
@@ -126,16 +228,23 @@ private:
             return *this;
         }
 
-        IStream& operator>>(std::string& var) {
-            std::vector<char> buffer;
+        // Strings are null-terminated in the payload, so they can be handed
+        // out as views into it without any temporary buffer.
+        IStream& operator>>(std::string_view& var) {
+            size_t begin = mIdx;
             do {
                 if (mData.size() < mIdx + 1) {
                     throw std::runtime_error{"Trying to read string beyond the bounds of the IPC packet payload."};
                 }
-
-                buffer.push_back(mData[mIdx]);
             } while (mData[mIdx++] != '\0');
-            var = buffer.data();
+            var = std::string_view{&mData[begin], mIdx - begin - 1};
+            return *this;
+        }
+
+        IStream& operator>>(std::string& var) {
+            std::string_view view;
+            *this >> view;
+            var = view;
             return *this;
         }
 
@@ -178,19 +287,45 @@ private:
             *this << (uint32_t)0;
         }
 
+        // Reserves capacity for `additionalBytes` more payload such that
+        // callers that know their serialized size up front (see
+        // setUpdateImage()) pay for at most one allocation.
+        void reserve(size_t additionalBytes) {
+            mData.reserve(mIdx + additionalBytes);
+        }
+
         template <typename T>
         OStream& operator<<(const std::vector<T>& var) {
-            for (auto&& elem : var) {
-                *this << elem;
+            if constexpr (std::is_trivially_copyable_v<T>) {
+                size_t bytes = var.size() * sizeof(T);
+                if (mData.size() < mIdx + bytes) {
+                    mData.resize(mIdx + bytes);
+                }
+
+                if (bytes > 0) {
+                    std::memcpy(&mData[mIdx], var.data(), bytes);
+                }
+
+                mIdx += bytes;
+                updateSize();
+            } else {
+                for (auto&& elem : var) {
+                    *this << elem;
+                }
             }
             return *this;
         }
 
         OStream& operator<<(const std::string& var) {
-            for (auto&& character : var) {
-                *this << character;
+            size_t bytes = var.size() + 1;
+            if (mData.size() < mIdx + bytes) {
+                mData.resize(mIdx + bytes);
             }
-            *this << '\0';
+
+            std::memcpy(&mData[mIdx], var.data(), var.size());
+            mData[mIdx + var.size()] = '\0';
+            mIdx += bytes;
+            updateSize();
             return *this;
         }
 
@@ -244,9 +379,29 @@ public:
     bool attemptToBecomePrimaryInstance();
 
     void sendToPrimaryInstance(const IpcPacket& message);
-    void receiveFromSecondaryInstance(std::function<void(const IpcPacket&)> callback);
+
+    // The callback receives each packet by value such that it can take
+    // ownership; interpreted updates reference the packet's payload.
+    void receiveFromSecondaryInstance(std::function<void(IpcPacket)> callback);
+
+    // Blocks until a new connection arrives or an existing connection has data
+    // to read, but no longer than the given timeout. Lets the IPC thread sleep
+    // in the kernel rather than polling on a fixed interval, and records which
+    // sockets are readable such that the next receiveFromSecondaryInstance()
+    // call only services those.
+    void waitForData(std::chrono::milliseconds timeout);
+
+    // Resolves (and caches) the shared-memory ring a same-host client
+    // announced in an UpdateImageShm packet. Returns nullptr if the ring
+    // cannot be opened, in which case the update is dropped.
+    SharedMemoryRing* openShmRing(const std::string& name);
 
 private:
+    // Shared memory is only usable when both instances run on the same host.
+    bool isLoopback() const {
+        return mIp == "127.0.0.1" || mIp == "localhost" || mIp == "::1";
+    }
+
     bool mIsPrimaryInstance;
     socket_t mSocketFd;
 
@@ -261,12 +416,16 @@ private:
     public:
         SocketConnection(Ipc::socket_t fd, const std::string& name);
 
-        void service(std::function<void(const IpcPacket&)> callback);
+        void service(std::function<void(IpcPacket)> callback);
 
         void close();
 
         bool isClosed() const;
 
+        Ipc::socket_t fd() const {
+            return mSocketFd;
+        }
+
     private:
         Ipc::socket_t mSocketFd;
         std::string mName;
@@ -281,6 +440,20 @@ private:
 
     std::list<SocketConnection> mSocketConnections;
 
+    // Readiness information from the last waitForData() call; only valid
+    // until the next receiveFromSecondaryInstance() call consumes it.
+    fd_set mReadyFds;
+    bool mReadinessValid = false;
+
+    // Producer side: the ring through which a secondary instance pushes pixel
+    // blocks to a same-host primary instance. Created lazily on first use.
+    std::unique_ptr<SharedMemoryRing> mShmRing;
+    bool mShmRingCreationFailed = false;
+
+    // Consumer side: rings announced by clients, keyed by name. A null entry
+    // records that opening failed so we don't retry (and warn) per packet.
+    std::map<std::string, std::unique_ptr<SharedMemoryRing>> mOpenedShmRings;
+
     std::string mIp;
     std::string mPort;
     std::string mLockName;
@@ -9,6 +9,9 @@
 
 #include <nanogui/widget.h>
 
+#include <cmath>
+#include <vector>
+
 namespace tev {
 
 class MultiGraph : public nanogui::Widget {
@@ -33,11 +36,34 @@ public:
     const nanogui::Color &textColor() const { return mTextColor; }
     void setTextColor(const nanogui::Color &textColor) { mTextColor = textColor; }
 
-    const std::vector<float> &values() const { return mValues; }
-    std::vector<float> &values() { return mValues; }
-    void setValues(const std::vector<float> &values) { mValues = values; }
+    // The histogram is supplied as raw per-channel bin counts at a finer
+    // resolution than is displayed, binned in symmetric-log space over
+    // [minimum, maximum]; see ImageCanvas::computeCanvasStatistics. draw()
+    // re-bins them under the current display transform, so exposure and
+    // offset changes update the graph without touching any pixels.
+    void setHistogram(std::vector<float> baseHistogram, int nChannels, float minimum, float maximum) {
+        // Callers push the current statistics every frame; keep the cached
+        // re-binning and geometry when nothing actually changed.
+        if (nChannels == mNChannels && minimum == mHistogramMin && maximum == mHistogramMax && baseHistogram == mBaseHistogram) {
+            return;
+        }
+
+        mBaseHistogram = std::move(baseHistogram);
+        mNChannels = nChannels;
+        mHistogramMin = minimum;
+        mHistogramMax = maximum;
+        mHistogramDirty = true;
+    }
 
-    void setNChannels(int nChannels) { mNChannels = nChannels; }
+    // Cheap to call every frame; only marks the cached re-binning dirty when
+    // the transform actually changed.
+    void setDisplayTransform(float exposure, float offset) {
+        if (exposure != mExposure || offset != mOffset) {
+            mExposure = exposure;
+            mOffset = offset;
+            mHistogramDirty = true;
+        }
+    }
 
     virtual nanogui::Vector2i preferred_size(NVGcontext *ctx) const override;
     virtual void draw(NVGcontext *ctx) override;
@@ -54,17 +80,40 @@ public:
         mMaximum = maximum;
     }
 
-    void setZero(int zeroBin) {
-        mZeroBin = zeroBin;
+protected:
+    // Re-bins mBaseHistogram into mValues/mZeroBin if dirty.
+    void updateHistogram();
+
+    // Rebuilds the cached screen-space graph vertices if the histogram or
+    // the widget size changed.
+    void updateGeometry();
+
+    float displayedValue(float value) const {
+        return std::pow(2.0f, mExposure) * value + mOffset;
     }
 
-protected:
     std::string mCaption, mHeader, mFooter;
     nanogui::Color mBackgroundColor, mForegroundColor, mTextColor;
-    std::vector<float> mValues;
+
+    std::vector<float> mBaseHistogram;
     int mNChannels = 1;
-    float mMinimum = 0, mMean = 0, mMaximum = 0;
+    float mHistogramMin = 0, mHistogramMax = 0;
+    float mExposure = 0, mOffset = 0;
+    bool mHistogramDirty = true;
+
+    // Cached display-resolution histogram under the current transform.
+    std::vector<float> mValues;
     int mZeroBin = 0;
+
+    // Graph vertices cached per (histogram, widget size) state, relative to
+    // the widget origin: one x per pixel column shared by all channels, and
+    // one y per column per channel.
+    std::vector<float> mVertexX;
+    std::vector<float> mVertexY;
+    nanogui::Vector2i mCachedSize = {0, 0};
+    bool mGeometryDirty = true;
+
+    float mMinimum = 0, mMean = 0, mMaximum = 0;
 };
 
 }
@@ -5,6 +5,7 @@
 
 #include <tev/Common.h>
 
+#include <atomic>
 #include <condition_variable>
 #include <deque>
 #include <mutex>
@@ -63,4 +64,56 @@ private:
     std::condition_variable mDataCondition;
 };
 
+// Lock-free multi-producer single-consumer FIFO after Dmitry Vyukov's
+// intrusive MPSC queue. push() is a single atomic exchange and never blocks;
+// tryPop() must only ever be called from one thread at a time (in tev's case:
+// the UI thread popping what background loaders produced).
+template <typename T>
+class MpscQueue {
+public:
+    MpscQueue() {
+        Node* stub = new Node{};
+        mHead.store(stub, std::memory_order_relaxed);
+        mTail = stub;
+    }
+
+    MpscQueue(const MpscQueue& other) = delete;
+    MpscQueue& operator=(const MpscQueue& other) = delete;
+
+    ~MpscQueue() {
+        while (tryPop()) {}
+        delete mTail;
+    }
+
+    void push(T newElem) {
+        Node* node = new Node{std::move(newElem)};
+        Node* prev = mHead.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    std::optional<T> tryPop() {
+        Node* next = mTail->next.load(std::memory_order_acquire);
+        if (!next) {
+            return {};
+        }
+
+        std::optional<T> result = std::move(next->value);
+        delete mTail;
+        mTail = next;
+        return result;
+    }
+
+private:
+    struct Node {
+        Node() = default;
+        Node(T&& val) : value{std::move(val)} {}
+
+        std::atomic<Node*> next{nullptr};
+        T value = {};
+    };
+
+    std::atomic<Node*> mHead;
+    Node* mTail;
+};
+
 }
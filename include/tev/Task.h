@@ -17,9 +17,61 @@
 #include <future>
 #include <mutex>
 #include <semaphore>
+#include <span>
 
 namespace tev {
 
+// Recycles coroutine frames (and other small task-related blocks) in per-thread
+// freelists bucketed by power-of-two size classes. Task-heavy operations, such as
+// image loads, allocate hundreds of short-lived frames; recycling them avoids
+// malloc contention on the hot path. Blocks may be freed on a different thread
+// than they were allocated on; they then simply join that thread's freelist.
+class CoroutineFramePool {
+public:
+    static void* alloc(size_t size);
+    static void free(void* ptr) noexcept;
+};
+
+// Mix-in that routes a promise type's frame allocation through the pool.
+struct PooledPromise {
+    void* operator new(size_t size) {
+        return CoroutineFramePool::alloc(size);
+    }
+
+    void operator delete(void* ptr) noexcept {
+        CoroutineFramePool::free(ptr);
+    }
+};
+
+// Cooperative cancellation for task graphs. Copies of a token share state, so
+// a token handed to a computation can later be tripped from the outside; the
+// computation is expected to poll canceled() at convenient chunk boundaries
+// and bail out early. A default-constructed token can never be canceled and
+// costs nothing beyond a null check.
+class CancellationToken {
+public:
+    CancellationToken() = default;
+
+    static CancellationToken create() {
+        CancellationToken token;
+        token.mCanceled = std::make_shared<std::atomic<bool>>(false);
+        return token;
+    }
+
+    void cancel() noexcept {
+        if (mCanceled) {
+            *mCanceled = true;
+        }
+    }
+
+    bool canceled() const noexcept {
+        return mCanceled && *mCanceled;
+    }
+
+private:
+    std::shared_ptr<std::atomic<bool>> mCanceled;
+};
+
 class Latch {
 public:
     Latch(int val) : mCounter{val} {}
@@ -48,7 +100,7 @@ void waitAll(std::vector<T>& futures) {
 }
 
 struct DetachedTask {
-    struct promise_type {
+    struct promise_type : public PooledPromise {
         DetachedTask get_return_object() noexcept {
             return {};
         }
@@ -93,13 +145,23 @@ protected:
     std::promise<void> mPromise;
 };
 
+// Join state shared between whenAll() and the tasks it awaits: one atomic
+// countdown for the whole group in place of a per-task continuation, such
+// that the joining coroutine is resumed exactly once, by whichever task
+// finishes last.
+struct TaskGroup {
+    std::atomic<int> counter{0};
+    COROUTINE_NAMESPACE::coroutine_handle<> continuation = nullptr;
+};
+
 struct TaskSharedState {
     COROUTINE_NAMESPACE::coroutine_handle<> continuation = nullptr;
+    TaskGroup* group = nullptr;
     Latch latch{2};
 };
 
 template <typename future_t, typename data_t>
-class TaskPromise : public TaskPromiseBase<data_t> {
+class TaskPromise : public TaskPromiseBase<data_t>, public PooledPromise {
 public:
     future_t get_return_object() noexcept {
         return {COROUTINE_NAMESPACE::coroutine_handle<TaskPromise<future_t, data_t>>::from_promise(*this), this->mPromise.get_future(), mState};
@@ -116,23 +178,43 @@ public:
     auto final_suspend() noexcept {
         class Awaiter {
         public:
-            Awaiter(COROUTINE_NAMESPACE::coroutine_handle<> continuation) : mContinuation{continuation} {}
+            Awaiter(COROUTINE_NAMESPACE::coroutine_handle<> continuation, TaskGroup* group) : mContinuation{continuation}, mGroup{group} {}
 
-            bool await_ready() noexcept { return !mContinuation; }
+            bool await_ready() noexcept { return !mContinuation && !mGroup; }
             void await_resume() noexcept {}
 
             // Returning the continuation has the effect of continuing execution where the parent co_await'ed us.
             // It's the parent's job to call destroy on this coroutine's handle.
-            COROUTINE_NAMESPACE::coroutine_handle<> await_suspend(COROUTINE_NAMESPACE::coroutine_handle<TaskPromise<future_t, data_t>>) noexcept {
+            COROUTINE_NAMESPACE::coroutine_handle<> await_suspend(COROUTINE_NAMESPACE::coroutine_handle<TaskPromise<future_t, data_t>> handle) noexcept {
+                if (mGroup) {
+                    // Group-joined tasks free their own frame: whenAll() cannot
+                    // know which of its children finishes last, so no child may
+                    // rely on the joining coroutine for cleanup. The group
+                    // outlives the frame (and hence this awaiter, which lives
+                    // inside the frame), so copy the pointer out first.
+                    TaskGroup* group = mGroup;
+                    handle.destroy();
+                    if (--group->counter == 0) {
+                        return group->continuation;
+                    }
+
+                    return COROUTINE_NAMESPACE::noop_coroutine();
+                }
+
                 return mContinuation;
             }
 
         private:
             COROUTINE_NAMESPACE::coroutine_handle<> mContinuation;
+            TaskGroup* mGroup;
         };
 
         bool isLast = mState->latch.countDown();
-        return Awaiter{isLast ? mState->continuation : nullptr};
+        if (!isLast) {
+            return Awaiter{nullptr, nullptr};
+        }
+
+        return Awaiter{mState->continuation, mState->group};
     }
 
 private:
@@ -224,10 +306,79 @@ public:
         return shallSuspend;
     }
 
+    // Hands this task's completion off to `group` in place of a regular
+    // continuation and relinquishes the coroutine frame, which group-joined
+    // tasks free themselves (see final_suspend() above). Returns false if the
+    // task had already finished, in which case the caller must count the
+    // group down on the task's behalf. Used by whenAll().
+    bool joinGroup(TaskGroup& group) noexcept {
+        if (!mHandle) {
+            tlog::error() << "Cannot co_await/get() a task multiple times.";
+            std::terminate();
+        }
+
+        mHandle = nullptr;
+        mState->group = &group;
+        return !mState->latch.countDown();
+    }
+
+    // Retrieves the result of a task that was previously handed off via
+    // joinGroup(), rethrowing its exception if it failed.
+    T groupResult() {
+        return mFuture.get();
+    }
+
 private:
     COROUTINE_NAMESPACE::coroutine_handle<promise_type> mHandle;
     std::future<T> mFuture;
     std::shared_ptr<TaskSharedState> mState;
 };
 
+// Joins a span of tasks through one shared atomic countdown: the awaiting
+// coroutine suspends at most once and is resumed exactly once, by whichever
+// task finishes last, rather than bouncing through one suspension and
+// resumption per task as a sequential co_await loop does. No memory beyond
+// the awaiter itself is allocated. Exceptions of failed tasks are rethrown
+// (in span order, first one wins) once all of them have finished; the span
+// must stay alive until the co_await completes.
+inline auto whenAll(std::span<Task<void>> tasks) {
+    class Awaiter {
+    public:
+        Awaiter(std::span<Task<void>> tasks) : mTasks{tasks} {}
+
+        bool await_ready() const noexcept { return mTasks.empty(); }
+
+        bool await_suspend(COROUTINE_NAMESPACE::coroutine_handle<> coroutine) noexcept {
+            mGroup.continuation = coroutine;
+
+            // The extra count is a guard that keeps tasks finishing while we
+            // are still registering from resuming `coroutine` under our feet.
+            mGroup.counter = (int)mTasks.size() + 1;
+            for (auto& task : mTasks) {
+                if (!task.joinGroup(mGroup)) {
+                    // Already finished; count down on the task's behalf.
+                    --mGroup.counter;
+                }
+            }
+
+            // Dropping the guard count last makes the decrement to zero — and
+            // with it the resumption of `coroutine` — happen exactly once: here
+            // if every task has already finished, on the final task otherwise.
+            return --mGroup.counter != 0;
+        }
+
+        void await_resume() {
+            for (auto& task : mTasks) {
+                task.groupResult();
+            }
+        }
+
+    private:
+        std::span<Task<void>> mTasks;
+        TaskGroup mGroup;
+    };
+
+    return Awaiter{tasks};
+}
+
 }
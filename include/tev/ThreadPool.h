@@ -7,8 +7,10 @@
 #include <tev/Task.h>
 
 #include <atomic>
+#include <deque>
 #include <functional>
 #include <future>
+#include <memory>
 #include <queue>
 #include <thread>
 #include <vector>
@@ -27,6 +29,14 @@ public:
         return pool;
     }
 
+    // Dedicated pool for blocking file I/O. Disk reads do not benefit from one
+    // thread per core, and routing them here keeps them from occupying the
+    // compute pool's workers while conversion and statistics tasks queue up.
+    static ThreadPool& globalIo() {
+        static ThreadPool pool{4};
+        return pool;
+    }
+
     template<class F>
     auto enqueueTask(F&& f, int priority) {
         using return_type = std::invoke_result_t<decltype(f)>;
@@ -37,15 +47,20 @@ public:
 
         auto res = task->get_future();
 
-        {
-            std::lock_guard<std::mutex> lock{mTaskQueueMutex};
-            mTaskQueue.push({priority, [task]() { (*task)(); }});
-        }
-
-        mWorkerCondition.notify_one();
+        push({priority, [task]() { (*task)(); }});
         return res;
     }
 
+    // Fire-and-forget counterpart of enqueueTask: no future, no packaged_task,
+    // and hence no shared-state allocation. Callables small enough for
+    // std::function's inline storage (such as a coroutine handle) make this
+    // path entirely allocation-free.
+    template<class F>
+    void enqueueTaskDetached(F&& f, int priority) {
+        ++mNumTasksInSystem;
+        push({priority, std::forward<F>(f)});
+    }
+
     inline auto enqueueCoroutine(int priority) noexcept {
         class Awaiter {
         public:
@@ -56,7 +71,7 @@ public:
 
             // Suspend and enqueue coroutine continuation onto the threadpool
             void await_suspend(COROUTINE_NAMESPACE::coroutine_handle<> coroutine) noexcept {
-                mPool->enqueueTask(coroutine, mPriority);
+                mPool->enqueueTaskDetached([coroutine]() { coroutine.resume(); }, mPriority);
             }
 
             void await_resume() const noexcept {}
@@ -72,6 +87,10 @@ public:
     void startThreads(size_t num);
     void shutdownThreads(size_t num);
 
+    size_t numThreads() const {
+        return mNumThreads;
+    }
+
     size_t numTasksInSystem() const {
         return mNumTasksInSystem;
     }
@@ -81,7 +100,7 @@ public:
     void flushQueue();
 
     template <typename Int, typename F>
-    Task<void> parallelForAsync(Int start, Int end, F body, int priority) {
+    Task<void> parallelForAsync(Int start, Int end, F body, int priority, CancellationToken cancel = {}) {
         Int range = end - start;
         Int nTasks = std::min((Int)mNumThreads, range);
 
@@ -91,28 +110,71 @@ public:
             Int taskEnd = start + (range * (i+1) / nTasks);
             TEV_ASSERT(taskStart != taskEnd, "Should not produce tasks with empty range.");
 
-            tasks.emplace_back([](Int start, Int end, F body, int priority, ThreadPool* pool) -> Task<void> {
+            tasks.emplace_back([](Int start, Int end, F body, int priority, CancellationToken cancel, ThreadPool* pool) -> Task<void> {
                 co_await pool->enqueueCoroutine(priority);
                 for (Int j = start; j < end; ++j) {
+                    // Poll for cancellation only every so often; an atomic
+                    // load per element would hurt the tightest loops.
+                    if (((j - start) & 1023) == 0 && cancel.canceled()) {
+                        co_return;
+                    }
+
                     body(j);
                 }
-            }(taskStart, taskEnd, body, priority, this));
+            }(taskStart, taskEnd, body, priority, cancel, this));
+        }
+
+        co_await whenAll(tasks);
+    }
+
+    template <typename Int, typename F>
+    void parallelFor(Int start, Int end, F body, int priority, CancellationToken cancel = {}) {
+        parallelForAsync(start, end, body, priority, cancel).get();
+    }
+
+    // Variant of parallelForAsync for imbalanced workloads: rather than statically
+    // slicing [start, end) into one contiguous range per thread, workers grab small
+    // blocks from a shared atomic index. Slightly more overhead per element, but no
+    // core idles while another is stuck with the most expensive slice.
+    template <typename Int, typename F>
+    Task<void> parallelForDynamicAsync(Int start, Int end, F body, int priority, CancellationToken cancel = {}) {
+        Int range = end - start;
+        Int nTasks = std::min((Int)mNumThreads, range);
+        if (nTasks <= 0) {
+            co_return;
         }
 
-        for (auto& task : tasks) {
-            co_await task;
+        // Small enough to balance well, large enough to amortize the atomic increment.
+        Int blockSize = std::max((Int)1, (Int)(range / (16 * nTasks)));
+        std::atomic<Int> nextBlock{start};
+
+        std::vector<Task<void>> tasks;
+        for (Int i = 0; i < nTasks; ++i) {
+            tasks.emplace_back([](std::atomic<Int>* nextBlock, Int end, Int blockSize, F body, int priority, CancellationToken cancel, ThreadPool* pool) -> Task<void> {
+                co_await pool->enqueueCoroutine(priority);
+                while (!cancel.canceled()) {
+                    Int blockStart = nextBlock->fetch_add(blockSize);
+                    if (blockStart >= end) {
+                        break;
+                    }
+
+                    Int blockEnd = std::min(end, blockStart + blockSize);
+                    for (Int j = blockStart; j < blockEnd; ++j) {
+                        body(j);
+                    }
+                }
+            }(&nextBlock, end, blockSize, body, priority, cancel, this));
         }
+
+        co_await whenAll(tasks);
     }
 
     template <typename Int, typename F>
-    void parallelFor(Int start, Int end, F body, int priority) {
-        parallelForAsync(start, end, body, priority).get();
+    void parallelForDynamic(Int start, Int end, F body, int priority, CancellationToken cancel = {}) {
+        parallelForDynamicAsync(start, end, body, priority, cancel).get();
     }
 
 private:
-    size_t mNumThreads = 0;
-    std::vector<std::thread> mThreads;
-
     struct QueuedTask {
         int priority;
         std::function<void()> fun;
@@ -124,8 +186,30 @@ private:
         };
     };
 
-    std::priority_queue<QueuedTask, std::vector<QueuedTask>, QueuedTask::Comparator> mTaskQueue;
-    std::mutex mTaskQueueMutex;
+    // Each worker owns one of these queues. Tasks enqueued from a worker thread
+    // go into that worker's own queue; tasks from other threads are distributed
+    // round-robin. Workers that run dry steal from their neighbors, so the
+    // common enqueue/pop path only ever touches one uncontended mutex.
+    // Priorities are preserved within each queue, i.e., at coarse granularity.
+    struct WorkerQueue {
+        std::priority_queue<QueuedTask, std::vector<QueuedTask>, QueuedTask::Comparator> tasks;
+        std::mutex mutex;
+    };
+
+    void push(QueuedTask&& task);
+    bool tryPop(size_t workerId, QueuedTask& task);
+
+    size_t mNumThreads = 0;
+    std::vector<std::thread> mThreads;
+
+    // std::deque, because it does not invalidate references
+    // to existing elements upon growth.
+    std::deque<WorkerQueue> mWorkerQueues;
+    std::atomic<size_t> mNextQueue{0};
+
+    std::atomic<size_t> mNumPendingTasks{0};
+    std::atomic<size_t> mNumSleepingWorkers{0};
+    std::mutex mWakeupMutex;
     std::condition_variable mWorkerCondition;
 
     std::atomic<size_t> mNumTasksInSystem;
@@ -0,0 +1,60 @@
+// This file was developed by Thomas Müller <thomas94@gmx.net>.
+// It is published under the BSD 3-Clause License within the LICENSE file.
+
+#pragma once
+
+#include <tev/Common.h>
+
+#include <chrono>
+
+namespace tev {
+
+// Lightweight scoped tracing of tev's hot paths. While enabled, every `Span`
+// records a wall-clock begin/end event on the thread that runs it; the
+// recording can then be dumped in Chrome's trace event JSON format and
+// inspected in chrome://tracing or https://ui.perfetto.dev. While disabled
+// (the default), a span costs a single relaxed atomic load.
+namespace trace {
+
+bool enabled();
+void setEnabled(bool enabled);
+
+// Discards all events recorded so far.
+void clear();
+
+// Records one event if tracing is enabled. `name` must point to storage that
+// outlives the tracing session; in practice, pass a string literal.
+void record(const char* name, std::chrono::steady_clock::time_point begin, std::chrono::steady_clock::time_point end);
+
+// Writes the recorded events to `path` in Chrome's trace event JSON format.
+void dumpToFile(const fs::path& path);
+
+// Records the time from construction to destruction as one event. A span
+// living in a coroutine frame measures wall time including suspension and is
+// attributed to the thread that ends it.
+class Span {
+public:
+    Span(const char* name) {
+        if (enabled()) {
+            mName = name;
+            mBegin = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~Span() {
+        if (mName) {
+            record(mName, mBegin, std::chrono::steady_clock::now());
+        }
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+private:
+    const char* mName = nullptr;
+    std::chrono::steady_clock::time_point mBegin;
+};
+
+}
+
+}
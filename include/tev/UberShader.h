@@ -3,10 +3,15 @@
 
 #pragma once
 
+#include <tev/Box.h>
+
 #include <nanogui/shader.h>
 #include <nanogui/texture.h>
 #include <nanogui/vector.h>
 
+#include <array>
+#include <map>
+
 namespace tev {
 
 class UberShader {
@@ -46,6 +51,38 @@ public:
         EMetric metric
     );
 
+    // Variants of the above that restrict the drawn quad to the given
+    // rectangle in [-1, 1] clip coordinates rather than covering the whole
+    // canvas. Used by the tiled path for images too large for one texture.
+    void draw(
+        const nanogui::Vector2f& pixelSize,
+        const nanogui::Vector2f& checkerSize,
+        const Box2f& ndcRect,
+        nanogui::Texture* textureImage,
+        const nanogui::Matrix3f& transformImage,
+        float exposure,
+        float offset,
+        float gamma,
+        bool clipToLdr,
+        ETonemap tonemap
+    );
+
+    void draw(
+        const nanogui::Vector2f& pixelSize,
+        const nanogui::Vector2f& checkerSize,
+        const Box2f& ndcRect,
+        nanogui::Texture* textureImage,
+        const nanogui::Matrix3f& transformImage,
+        nanogui::Texture* textureReference,
+        const nanogui::Matrix3f& transformReference,
+        float exposure,
+        float offset,
+        float gamma,
+        bool clipToLdr,
+        ETonemap tonemap,
+        EMetric metric
+    );
+
     const nanogui::Color& backgroundColor() {
         return mBackgroundColor;
     }
@@ -54,7 +91,23 @@ public:
         mBackgroundColor = color;
     }
 
+    EColorMap colorMap() const {
+        return mColorMap;
+    }
+
+    // Selects the colormap used by the false-color tonemap. All maps are
+    // resident as LUT textures, so switching costs nothing at draw time.
+    void setColorMap(EColorMap colorMap) {
+        mColorMap = colorMap;
+    }
+
 private:
+    // Returns the shader specialized for the given combination of tonemap,
+    // metric, and reference presence, compiling it on first use. On the GL
+    // backends each combination is baked into its own branch-free variant;
+    // on Metal a single runtime-branching shader is shared by all of them.
+    nanogui::Shader* variantShader(ETonemap tonemap, EMetric metric, bool hasReference);
+
     void bindCheckerboardData(const nanogui::Vector2f& pixelSize, const nanogui::Vector2f& checkerSize);
 
     void bindImageData(
@@ -72,8 +125,17 @@ private:
         EMetric metric
     );
 
+    nanogui::RenderPass* mRenderPass;
+
+    // Compiled shader variants by specialization key.
+    std::map<int, nanogui::ref<nanogui::Shader>> mShaders;
+
+    // The variant most recently selected by draw().
     nanogui::ref<nanogui::Shader> mShader;
-    nanogui::ref<nanogui::Texture> mColorMap;
+
+    // One 256x1 LUT texture per colormap, all uploaded once at startup.
+    std::array<nanogui::ref<nanogui::Texture>, EColorMap::NumColorMaps> mColorMaps;
+    EColorMap mColorMap = EColorMap::Turbo;
 
     nanogui::Color mBackgroundColor = nanogui::Color(0, 0, 0, 0);
 };
@@ -5,6 +5,8 @@
 
 #include <tev/Common.h>
 
+#include <array>
+
 namespace tev {
 
 struct VgCommand {
@@ -118,4 +120,113 @@ struct VgCommand {
     std::vector<float> data;
 };
 
+// A retained tessellation of a vector graphics command stream. The bulk
+// primitives of typical annotation streams — polyline strokes, filled and
+// stroked rectangles and circles, filled ellipses — are flattened once, on
+// change, into vertex arrays that VectorGraphicsShader draws in a handful
+// of draw calls, rather than being replayed through immediate-mode NanoVG
+// every frame. Coordinates stay in display-window space; view-dependent
+// work (pan/zoom transform, constant-width stroke expansion) happens in
+// the vertex shader, so the arrays survive any camera motion.
+//
+// Commands outside the retained subset (arcs, beziers, free-form path
+// fills, ...) mark the batch unsupported, in which case the caller falls
+// back to replaying the full command list through NanoVG.
+class VgBatch {
+public:
+    VgBatch();
+
+    void clear();
+
+    // Tessellates `commands` onto the end of the batch. Color and path state
+    // carries over between calls, so incremental `append = true` updates of
+    // Image::updateVectorGraphics only pay for the new commands.
+    void append(const std::vector<VgCommand>& commands);
+
+    // False once a command outside the retained subset was encountered;
+    // the command list must then be drawn through NanoVG instead.
+    bool supported() const {
+        return mSupported;
+    }
+
+    bool empty() const {
+        return mSegmentA.empty() && mTrianglePos.empty() && mCircleCenter.empty();
+    }
+
+    // Changes whenever the vertex arrays do; unique across all batches, so
+    // the shader can skip re-uploading buffers it already holds.
+    size_t generation() const {
+        return mGeneration;
+    }
+
+    // Constant-width line segments, 6 vertices each. Both endpoints are
+    // attributes of every vertex; the shader expands them perpendicular to
+    // the screen-space direction by half the stroke width.
+    const std::vector<float>& segmentA() const { return mSegmentA; }          // 2 floats per vertex
+    const std::vector<float>& segmentB() const { return mSegmentB; }          // 2 floats per vertex
+    const std::vector<float>& segmentParam() const { return mSegmentParam; }  // side in {-1,1}, end in {0,1}
+    const std::vector<float>& segmentColor() const { return mSegmentColor; }  // 4 floats per vertex
+
+    // Solid triangles (filled rectangles), 6 vertices per rectangle.
+    const std::vector<float>& trianglePos() const { return mTrianglePos; }     // 2 floats per vertex
+    const std::vector<float>& triangleColor() const { return mTriangleColor; } // 4 floats per vertex
+
+    // Circles and ellipses as quads (6 vertices each) whose coverage — disc
+    // or constant-width ring — is evaluated in the fragment shader.
+    const std::vector<float>& circleCenter() const { return mCircleCenter; } // 2 floats per vertex
+    const std::vector<float>& circleRadius() const { return mCircleRadius; } // 2 floats per vertex
+    const std::vector<float>& circleCorner() const { return mCircleCorner; } // 2 floats per vertex, in {-1,1}^2
+    const std::vector<float>& circleRing() const { return mCircleRing; }     // 1 float per vertex; 0 = fill, 1 = ring
+    const std::vector<float>& circleColor() const { return mCircleColor; }   // 4 floats per vertex
+
+private:
+    using Color = std::array<float, 4>;
+
+    void emitSegment(const VgCommand::Pos& a, const VgCommand::Pos& b, const Color& color);
+    void emitTriangle(const VgCommand::Pos& a, const VgCommand::Pos& b, const VgCommand::Pos& c, const Color& color);
+    void emitCircle(const VgCommand::Pos& center, float rx, float ry, bool ring, const Color& color);
+
+    // Drops the vertex arrays and routes this command list to the NanoVG
+    // fallback for good.
+    void markUnsupported();
+
+    void bumpGeneration();
+
+    std::vector<float> mSegmentA;
+    std::vector<float> mSegmentB;
+    std::vector<float> mSegmentParam;
+    std::vector<float> mSegmentColor;
+
+    std::vector<float> mTrianglePos;
+    std::vector<float> mTriangleColor;
+
+    std::vector<float> mCircleCenter;
+    std::vector<float> mCircleRadius;
+    std::vector<float> mCircleCorner;
+    std::vector<float> mCircleRing;
+    std::vector<float> mCircleColor;
+
+    // Tessellation state carried across append() calls. An alpha of -1
+    // marks "color never set"; the shader substitutes the per-image default
+    // at draw time, which lets one batch serve both the image and the
+    // reference slot.
+    Color mFillColor;
+    Color mStrokeColor;
+    std::vector<std::pair<Color, Color>> mColorStack;
+
+    struct Subpath {
+        std::vector<VgCommand::Pos> points;
+        bool closed = false;
+    };
+
+    // The current path, kept as the primitives that formed it so that Fill
+    // and Stroke can tessellate each of them appropriately.
+    std::vector<Subpath> mPathPolylines;
+    std::vector<std::array<float, 4>> mPathRects;   // x, y, width, height
+    std::vector<std::array<float, 4>> mPathCircles; // center x, center y, radius x, radius y
+
+    bool mSupported = true;
+    size_t mGeneration = 0;
+};
+
 }
@@ -0,0 +1,58 @@
+// This file was developed by Thomas Müller <thomas94@gmx.net>.
+// It is published under the BSD 3-Clause License within the LICENSE file.
+
+#pragma once
+
+#include <tev/VectorGraphics.h>
+
+#include <nanogui/shader.h>
+#include <nanogui/vector.h>
+
+namespace tev {
+
+// Draws a VgBatch — the retained tessellation of an image's vector graphics
+// overlay — in at most three draw calls: line segments, solid triangles, and
+// circle/ellipse quads. The vertex data lives in display-window space and is
+// uploaded only when the batch changes; pan, zoom, and constant-width stroke
+// expansion are applied in the vertex shaders, so steady-state frames bind
+// the existing buffers and issue the draws without touching any vertices.
+class VectorGraphicsShader {
+public:
+    VectorGraphicsShader(nanogui::RenderPass* renderPass);
+    virtual ~VectorGraphicsShader();
+
+    // Draws `batch` with the given display-window-to-clip-space transform
+    // (the canvas transform has no rotation, so a scale and an offset
+    // suffice). `canvasSize` is the canvas size in logical pixels and
+    // `strokeWidth` the screen-space stroke width, matching the NanoVG
+    // replay path. `defaultColor` substitutes for primitives whose command
+    // stream never set a color.
+    void draw(
+        const VgBatch& batch,
+        const nanogui::Vector2f& transformScale,
+        const nanogui::Vector2f& transformOffset,
+        const nanogui::Vector2f& canvasSize,
+        float strokeWidth,
+        const nanogui::Color& defaultColor
+    );
+
+private:
+    // Re-uploads the vertex buffers if `batch` differs from what the
+    // shaders currently hold.
+    void uploadIfChanged(const VgBatch& batch);
+
+    nanogui::RenderPass* mRenderPass;
+
+    nanogui::ref<nanogui::Shader> mSegmentShader;
+    nanogui::ref<nanogui::Shader> mTriangleShader;
+    nanogui::ref<nanogui::Shader> mCircleShader;
+
+    // Generation of the batch whose buffers are currently uploaded, along
+    // with the then-current vertex counts. 0 matches no batch.
+    size_t mBoundGeneration = 0;
+    size_t mNumSegmentVertices = 0;
+    size_t mNumTriangleVertices = 0;
+    size_t mNumCircleVertices = 0;
+};
+
+}
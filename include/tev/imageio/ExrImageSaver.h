@@ -9,10 +9,26 @@
 
 namespace tev {
 
+enum EExrCompression : int {
+    Zip = 0,
+    Piz,
+    Dwaa,
+};
+
 class ExrImageSaver : public TypedImageSaver<float> {
 public:
+    // The DWA quality only applies to lossy Dwaa compression; higher values
+    // compress more aggressively. 45 is OpenEXR's own default.
+    ExrImageSaver(EExrCompression compression = EExrCompression::Zip, float dwaQuality = 45.0f)
+    : mCompression{compression}, mDwaQuality{dwaQuality} {}
+
     void save(std::ostream& oStream, const fs::path& path, const std::vector<float>& data, const nanogui::Vector2i& imageSize, int nChannels) const override;
 
+    // Streaming save: pulls scanline batches through `rowSource` right before
+    // they are compressed, so peak memory stays at one batch rather than the
+    // whole interleaved image.
+    void save(std::ostream& oStream, const fs::path& path, const RowSource& rowSource, const nanogui::Vector2i& imageSize, int nChannels) const override;
+
     bool hasPremultipliedAlpha() const override {
         return true;
     }
@@ -20,6 +36,10 @@ public:
     virtual bool canSaveFile(const std::string& extension) const override {
         return toLower(extension) == ".exr";
     }
+
+private:
+    EExrCompression mCompression;
+    float mDwaQuality;
 };
 
 }
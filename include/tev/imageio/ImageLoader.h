@@ -29,7 +29,7 @@ public:
     static const std::vector<std::unique_ptr<ImageLoader>>& getLoaders();
 
 protected:
-    static std::vector<Channel> makeNChannels(int numChannels, const nanogui::Vector2i& size);
+    static std::vector<Channel> makeNChannels(int numChannels, const nanogui::Vector2i& size, EPixelFormat format = EPixelFormat::F32);
 };
 
 }
@@ -7,6 +7,7 @@
 
 #include <nanogui/vector.h>
 
+#include <functional>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -33,7 +34,22 @@ public:
 template <typename T>
 class TypedImageSaver : public ImageSaver {
 public:
+    // Fills `data` with `numRows` rows of interleaved pixel data, starting at
+    // row `beginRow` of the image. Batches are pulled strictly in order.
+    using RowSource = std::function<void(T* data, int beginRow, int numRows)>;
+
     virtual void save(std::ostream& oStream, const fs::path& path, const std::vector<T>& data, const nanogui::Vector2i& imageSize, int nChannels) const = 0;
+
+    // Streaming variant of the above: savers that can write incrementally
+    // override this to pull scanline batches through `rowSource` as they go,
+    // keeping peak memory at one batch rather than the whole interleaved
+    // image. The default implementation materializes everything for savers
+    // whose underlying codec needs the full image up front.
+    virtual void save(std::ostream& oStream, const fs::path& path, const RowSource& rowSource, const nanogui::Vector2i& imageSize, int nChannels) const {
+        std::vector<T> data((size_t)imageSize.x() * imageSize.y() * nChannels);
+        rowSource(data.data(), 0, imageSize.y());
+        save(oStream, path, data, imageSize, nChannels);
+    }
 };
 
 }
@@ -50,12 +50,82 @@ Color Channel::color(string channel) {
     return Color(1.0f, 1.0f);
 }
 
-Channel::Channel(const std::string& name, const nanogui::Vector2i& size)
-: mName{name}, mSize{size} {
-    mData.resize((size_t)mSize.x() * mSize.y());
+bool Channel::sHalfPrecisionStorage = false;
+
+bool Channel::halfPrecisionStorage() {
+    return sHalfPrecisionStorage;
+}
+
+void Channel::setHalfPrecisionStorage(bool value) {
+    sHalfPrecisionStorage = value;
+}
+
+Channel::Channel(const std::string& name, const nanogui::Vector2i& size, EPixelFormat format, bool lazy)
+: mName{name}, mSize{size}, mFormat{format},
+mData{make_shared<vector<float>>()}, mDataHalf{make_shared<vector<uint16_t>>()} {
+    if (!lazy) {
+        materialize();
+    }
+}
+
+Task<tuple<float, float, float>> Channel::minMaxMeanAsync(int priority) const {
+    size_t n = numPixels();
+
+    // An unmaterialized channel reads as zero everywhere.
+    if (n == 0) {
+        co_return tuple{0.0f, 0.0f, 0.0f};
+    }
+
+    // One cache-line padded partial per task such that the reduction never
+    // bounces shared state between cores. The per-slice loops are plain
+    // data-parallel sweeps that compilers vectorize; the running sum carries a
+    // compensation term (Kahan) so precision does not degrade with pixel count.
+    struct alignas(64) Partial {
+        float minimum = numeric_limits<float>::infinity();
+        float maximum = -numeric_limits<float>::infinity();
+        float sum = 0;
+        float compensation = 0;
+    };
+
+    size_t nTasks = clamp(n / 65536, (size_t)1, ThreadPool::global().numThreads());
+    vector<Partial> partials(nTasks);
+
+    co_await ThreadPool::global().parallelForAsync<size_t>(0, nTasks, [&](size_t t) {
+        size_t taskBegin = n * t / nTasks;
+        size_t taskEnd = n * (t + 1) / nTasks;
+
+        auto& partial = partials[t];
+        for (size_t i = taskBegin; i < taskEnd; ++i) {
+            float val = at(i);
+            partial.minimum = min(partial.minimum, val);
+            partial.maximum = max(partial.maximum, val);
+
+            float y = val - partial.compensation;
+            float sum = partial.sum + y;
+            partial.compensation = (sum - partial.sum) - y;
+            partial.sum = sum;
+        }
+    }, priority);
+
+    float minimum = numeric_limits<float>::infinity();
+    float maximum = -numeric_limits<float>::infinity();
+    float sum = 0;
+    for (const auto& partial : partials) {
+        minimum = min(minimum, partial.minimum);
+        maximum = max(maximum, partial.maximum);
+        sum += partial.sum;
+    }
+
+    co_return tuple{minimum, maximum, sum / n};
 }
 
 Task<void> Channel::divideByAsync(const Channel& other, int priority) {
+    // An unmaterialized channel is all zero and stays all zero when divided.
+    if (!materialized()) {
+        co_return;
+    }
+
+    ensureFloatStorage();
     co_await ThreadPool::global().parallelForAsync<size_t>(0, other.numPixels(), [&](size_t i) {
         if (other.at(i) != 0) {
             at(i) /= other.at(i);
@@ -66,20 +136,50 @@ Task<void> Channel::divideByAsync(const Channel& other, int priority) {
 }
 
 Task<void> Channel::multiplyWithAsync(const Channel& other, int priority) {
+    // An unmaterialized channel is all zero and stays all zero when scaled.
+    if (!materialized()) {
+        co_return;
+    }
+
+    ensureFloatStorage();
     co_await ThreadPool::global().parallelForAsync<size_t>(0, other.numPixels(), [&](size_t i) {
         at(i) *= other.at(i);
     }, priority);
 }
 
-void Channel::updateTile(int x, int y, int width, int height, const vector<float>& newData) {
+void Channel::ensureFloatStorage() {
+    if (mFormat == EPixelFormat::F32) {
+        detach();
+        return;
+    }
+
+    // Convert straight out of the (possibly shared) half buffer into a fresh
+    // float buffer rather than detaching first, which would copy twice.
+    const auto& half = *mDataHalf;
+    auto floatData = make_shared<vector<float>>(half.size());
+    for (size_t i = 0; i < half.size(); ++i) {
+        (*floatData)[i] = halfToFloat(half[i]);
+    }
+
+    mData = std::move(floatData);
+    mDataHalf = make_shared<vector<uint16_t>>();
+    mFormat = EPixelFormat::F32;
+}
+
+void Channel::updateTile(int x, int y, int width, int height, const float* newData, int64_t stride) {
     if (x < 0 || y < 0 || x + width > size().x() || y + height > size().y()) {
         tlog::warning() << "Tile [" << x << "," << y << "," << width << "," << height << "] could not be updated because it does not fit into the channel's size " << size();
         return;
     }
 
+    ensureFloatStorage();
+    materialize();
+
     for (int posY = 0; posY < height; ++posY) {
+        float* dst = &at({x, y + posY});
+        const float* src = newData + (int64_t)posY * width * stride;
         for (int posX = 0; posX < width; ++posX) {
-            at({x + posX, y + posY}) = newData[posX + posY * width];
+            dst[posX] = src[posX * stride];
         }
     }
 }
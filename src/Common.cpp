@@ -93,32 +93,29 @@ string toUpper(string str) {
     return str;
 }
 
-bool matchesFuzzy(string text, string filter, size_t* matchedPartId) {
+FuzzyMatcher::FuzzyMatcher(const string& filter) {
+    // Perform matching on lowercase strings
+    mWords = split(toLower(filter), ", ");
+    // We don't want people entering multiple spaces in a row to match everything.
+    mWords.erase(remove(begin(mWords), end(mWords), ""), end(mWords));
+}
+
+bool FuzzyMatcher::matches(const string& text, size_t* matchedPartId) const {
     if (matchedPartId) {
         // Default value of 0. Is actually returned when the filter
         // is empty or when there is no match.
         *matchedPartId = 0;
     }
 
-    if (filter.empty()) {
+    if (mWords.empty()) {
         return true;
     }
 
-    // Perform matching on lowercase strings
-    text = toLower(text);
-    filter = toLower(filter);
-
-    auto words = split(filter, ", ");
-    // We don't want people entering multiple spaces in a row to match everything.
-    words.erase(remove(begin(words), end(words), ""), end(words));
-
-    if (words.empty()) {
-        return true;
-    }
+    string lowerText = toLower(text);
 
     // Match every word of the filter separately.
-    for (size_t i = 0; i < words.size(); ++i) {
-        if (text.find(words[i]) != string::npos) {
+    for (size_t i = 0; i < mWords.size(); ++i) {
+        if (lowerText.find(mWords[i]) != string::npos) {
             if (matchedPartId) {
                 *matchedPartId = i;
             }
@@ -129,6 +126,10 @@ bool matchesFuzzy(string text, string filter, size_t* matchedPartId) {
     return false;
 }
 
+bool matchesFuzzy(string text, string filter, size_t* matchedPartId) {
+    return FuzzyMatcher{filter}.matches(text, matchedPartId);
+}
+
 bool matchesRegex(string text, string filter) {
     if (filter.empty()) {
         return true;
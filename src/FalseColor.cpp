@@ -8,9 +8,11 @@ using namespace std;
 namespace tev {
 
 namespace colormap {
-    const vector<float>& turbo() {
-        // "turbo" colormap data generated with scripts/sample-colormap.py
-        static const vector<float> data = {
+    // The tables are constexpr such that they live in the binary's read-only
+    // data section; nothing is constructed or copied at startup.
+
+    // "turbo" colormap data generated with scripts/sample-colormap.py
+    static constexpr ColorMapData TURBO = {
             0.18995f, 0.07176f, 0.23217f, 1.0f,
             0.19483f, 0.08339f, 0.26149f, 1.0f,
             0.19956f, 0.09498f, 0.29024f, 1.0f,
@@ -44,40 +46,40 @@ namespace colormap {
             0.27509f, 0.40072f, 0.86692f, 1.0f,
             0.27576f, 0.41097f, 0.87936f, 1.0f,
             0.27628f, 0.42118f, 0.89123f, 1.0f,
-            0.27667f, 0.43133999999999995f, 0.9025399999999999f, 1.0f,
+            0.27667f, 0.43134f, 0.90254f, 1.0f,
             0.27691f, 0.44145f, 0.91328f, 1.0f,
             0.27701f, 0.45152f, 0.92347f, 1.0f,
             0.27698f, 0.46153f, 0.93309f, 1.0f,
-            0.2768f, 0.47150999999999993f, 0.9421399999999999f, 1.0f,
+            0.2768f, 0.47151f, 0.94214f, 1.0f,
             0.27648f, 0.48144f, 0.95064f, 1.0f,
             0.27603f, 0.49132f, 0.95857f, 1.0f,
             0.27543f, 0.50115f, 0.96594f, 1.0f,
-            0.27469f, 0.5109399999999998f, 0.97275f, 1.0f,
+            0.27469f, 0.51094f, 0.97275f, 1.0f,
             0.27381f, 0.52069f, 0.97899f, 1.0f,
             0.27273f, 0.5304f, 0.98461f, 1.0f,
             0.27106f, 0.54015f, 0.9893f, 1.0f,
-            0.26878f, 0.5499499999999999f, 0.99303f, 1.0f,
+            0.26878f, 0.54995f, 0.99303f, 1.0f,
             0.26592f, 0.55979f, 0.99583f, 1.0f,
             0.26252f, 0.56967f, 0.99773f, 1.0f,
             0.25862f, 0.57958f, 0.99876f, 1.0f,
-            0.25425000000000003f, 0.5894999999999999f, 0.99896f, 1.0f,
+            0.25425f, 0.5895f, 0.99896f, 1.0f,
             0.24946f, 0.59943f, 0.99835f, 1.0f,
             0.24427f, 0.60937f, 0.99697f, 1.0f,
             0.23874f, 0.61931f, 0.99485f, 1.0f,
-            0.23288000000000003f, 0.6292299999999998f, 0.99202f, 1.0f,
+            0.23288f, 0.62923f, 0.99202f, 1.0f,
             0.22676f, 0.63913f, 0.98851f, 1.0f,
             0.22039f, 0.64901f, 0.98436f, 1.0f,
             0.21382f, 0.65886f, 0.97959f, 1.0f,
-            0.20708000000000004f, 0.6686599999999999f, 0.97423f, 1.0f,
+            0.20708f, 0.66866f, 0.97423f, 1.0f,
             0.20021f, 0.67842f, 0.96833f, 1.0f,
             0.19326f, 0.68812f, 0.9619f, 1.0f,
             0.18625f, 0.69775f, 0.95498f, 1.0f,
-            0.17923000000000006f, 0.7073199999999998f, 0.94761f, 1.0f,
+            0.17923f, 0.70732f, 0.94761f, 1.0f,
             0.17223f, 0.7168f, 0.93981f, 1.0f,
             0.16529f, 0.7262f, 0.93161f, 1.0f,
             0.15844f, 0.73551f, 0.92305f, 1.0f,
             0.15173f, 0.74472f, 0.91416f, 1.0f,
-            0.1451900000000001f, 0.7538099999999999f, 0.9049600000000001f, 1.0f,
+            0.14519f, 0.75381f, 0.90496f, 1.0f,
             0.13886f, 0.76279f, 0.8955f, 1.0f,
             0.13278f, 0.77165f, 0.8858f, 1.0f,
             0.12698f, 0.78037f, 0.8759f, 1.0f,
@@ -85,7 +87,7 @@ namespace colormap {
             0.11639f, 0.7974f, 0.85559f, 1.0f,
             0.11167f, 0.80569f, 0.84525f, 1.0f,
             0.10738f, 0.81381f, 0.83484f, 1.0f,
-            0.10357000000000005f, 0.8217699999999999f, 0.8243700000000002f, 1.0f,
+            0.10357f, 0.82177f, 0.82437f, 1.0f,
             0.10026f, 0.82955f, 0.81389f, 1.0f,
             0.0975f, 0.83714f, 0.80342f, 1.0f,
             0.09532f, 0.84455f, 0.79299f, 1.0f,
@@ -93,7 +95,7 @@ namespace colormap {
             0.09287f, 0.85875f, 0.7724f, 1.0f,
             0.09267f, 0.86554f, 0.7623f, 1.0f,
             0.0932f, 0.87211f, 0.75237f, 1.0f,
-            0.09450999999999998f, 0.8784399999999999f, 0.7426500000000001f, 1.0f,
+            0.09451f, 0.87844f, 0.74265f, 1.0f,
             0.09662f, 0.88454f, 0.73316f, 1.0f,
             0.09958f, 0.8904f, 0.72393f, 1.0f,
             0.10342f, 0.896f, 0.715f, 1.0f,
@@ -101,7 +103,7 @@ namespace colormap {
             0.11374f, 0.90673f, 0.69651f, 1.0f,
             0.12014f, 0.91193f, 0.6866f, 1.0f,
             0.12733f, 0.91701f, 0.67627f, 1.0f,
-            0.13525999999999988f, 0.9219699999999998f, 0.6655600000000002f, 1.0f,
+            0.13526f, 0.92197f, 0.66556f, 1.0f,
             0.14391f, 0.9268f, 0.65448f, 1.0f,
             0.15323f, 0.93151f, 0.64308f, 1.0f,
             0.16319f, 0.93609f, 0.63137f, 1.0f,
@@ -109,7 +111,7 @@ namespace colormap {
             0.18491f, 0.94484f, 0.60713f, 1.0f,
             0.19659f, 0.94901f, 0.59466f, 1.0f,
             0.20877f, 0.95304f, 0.58199f, 1.0f,
-            0.22141999999999984f, 0.95692f, 0.5691400000000002f, 1.0f,
+            0.22142f, 0.95692f, 0.56914f, 1.0f,
             0.23449f, 0.96065f, 0.55614f, 1.0f,
             0.24797f, 0.96423f, 0.54303f, 1.0f,
             0.2618f, 0.96765f, 0.52981f, 1.0f,
@@ -117,7 +119,7 @@ namespace colormap {
             0.29042f, 0.97403f, 0.50321f, 1.0f,
             0.30513f, 0.97697f, 0.48987f, 1.0f,
             0.32006f, 0.97974f, 0.47654f, 1.0f,
-            0.3351699999999998f, 0.98234f, 0.46325000000000016f, 1.0f,
+            0.33517f, 0.98234f, 0.46325f, 1.0f,
             0.35043f, 0.98477f, 0.45002f, 1.0f,
             0.36581f, 0.98702f, 0.43688f, 1.0f,
             0.38127f, 0.98909f, 0.42386f, 1.0f,
@@ -125,7 +127,7 @@ namespace colormap {
             0.41229f, 0.99268f, 0.39826f, 1.0f,
             0.42778f, 0.99419f, 0.38575f, 1.0f,
             0.44321f, 0.99551f, 0.37345f, 1.0f,
-            0.4585399999999998f, 0.99663f, 0.36140000000000017f, 1.0f,
+            0.45854f, 0.99663f, 0.3614f, 1.0f,
             0.47375f, 0.99755f, 0.34963f, 1.0f,
             0.48879f, 0.99828f, 0.33816f, 1.0f,
             0.50362f, 0.99879f, 0.32701f, 1.0f,
@@ -133,7 +135,7 @@ namespace colormap {
             0.53255f, 0.99919f, 0.30581f, 1.0f,
             0.54658f, 0.99907f, 0.29581f, 1.0f,
             0.56026f, 0.99873f, 0.28623f, 1.0f,
-            0.5735699999999998f, 0.99817f, 0.2771200000000001f, 1.0f,
+            0.57357f, 0.99817f, 0.27712f, 1.0f,
             0.58646f, 0.99739f, 0.26849f, 1.0f,
             0.59891f, 0.99638f, 0.26038f, 1.0f,
             0.61088f, 0.99514f, 0.2528f, 1.0f,
@@ -143,7 +145,7 @@ namespace colormap {
             0.65394f, 0.98775f, 0.22835f, 1.0f,
             0.66428f, 0.98524f, 0.2237f, 1.0f,
             0.67462f, 0.98246f, 0.2196f, 1.0f,
-            0.6849399999999997f, 0.9794100000000001f, 0.2160200000000001f, 1.0f,
+            0.68494f, 0.97941f, 0.21602f, 1.0f,
             0.69525f, 0.9761f, 0.21294f, 1.0f,
             0.70553f, 0.97255f, 0.21032f, 1.0f,
             0.71577f, 0.96875f, 0.20815f, 1.0f,
@@ -159,7 +161,7 @@ namespace colormap {
             0.8141f, 0.91861f, 0.20552f, 1.0f,
             0.82333f, 0.91253f, 0.20663f, 1.0f,
             0.83241f, 0.90627f, 0.20788f, 1.0f,
-            0.8413299999999998f, 0.8998600000000002f, 0.20925999999999997f, 1.0f,
+            0.84133f, 0.89986f, 0.20926f, 1.0f,
             0.8501f, 0.89328f, 0.21074f, 1.0f,
             0.85868f, 0.88655f, 0.2123f, 1.0f,
             0.86709f, 0.87968f, 0.21391f, 1.0f,
@@ -175,7 +177,7 @@ namespace colormap {
             0.93909f, 0.80439f, 0.22744f, 1.0f,
             0.94489f, 0.79634f, 0.228f, 1.0f,
             0.95039f, 0.78823f, 0.22831f, 1.0f,
-            0.9555999999999999f, 0.7800500000000002f, 0.22836f, 1.0f,
+            0.9556f, 0.78005f, 0.22836f, 1.0f,
             0.96049f, 0.77181f, 0.22811f, 1.0f,
             0.96507f, 0.76352f, 0.22754f, 1.0f,
             0.96931f, 0.75519f, 0.22663f, 1.0f,
@@ -191,7 +193,7 @@ namespace colormap {
             0.99438f, 0.66386f, 0.19971f, 1.0f,
             0.99535f, 0.65341f, 0.19577f, 1.0f,
             0.99607f, 0.64277f, 0.19165f, 1.0f,
-            0.99654f, 0.6319300000000003f, 0.1873800000000001f, 1.0f,
+            0.99654f, 0.63193f, 0.18738f, 1.0f,
             0.99675f, 0.62093f, 0.18297f, 1.0f,
             0.99672f, 0.60977f, 0.17842f, 1.0f,
             0.99644f, 0.59846f, 0.17376f, 1.0f,
@@ -207,7 +209,7 @@ namespace colormap {
             0.98108f, 0.48104f, 0.12332f, 1.0f,
             0.97837f, 0.4692f, 0.11817f, 1.0f,
             0.97545f, 0.4574f, 0.11305f, 1.0f,
-            0.9723400000000001f, 0.4456500000000003f, 0.10797000000000014f, 1.0f,
+            0.97234f, 0.44565f, 0.10797f, 1.0f,
             0.96904f, 0.43399f, 0.10294f, 1.0f,
             0.96555f, 0.42241f, 0.09798f, 1.0f,
             0.96187f, 0.41093f, 0.0931f, 1.0f,
@@ -223,7 +225,7 @@ namespace colormap {
             0.91572f, 0.3053f, 0.05134f, 1.0f,
             0.91024f, 0.29599f, 0.04814f, 1.0f,
             0.90463f, 0.28696f, 0.04516f, 1.0f,
-            0.8988800000000001f, 0.2782400000000002f, 0.04243000000000008f, 1.0f,
+            0.89888f, 0.27824f, 0.04243f, 1.0f,
             0.89298f, 0.26981f, 0.03993f, 1.0f,
             0.88691f, 0.26152f, 0.03753f, 1.0f,
             0.88066f, 0.25334f, 0.03521f, 1.0f,
@@ -239,7 +241,7 @@ namespace colormap {
             0.80799f, 0.17753f, 0.0166f, 1.0f,
             0.79971f, 0.17055f, 0.0152f, 1.0f,
             0.79125f, 0.16368f, 0.01387f, 1.0f,
-            0.7826000000000002f, 0.15693000000000018f, 0.012640000000000035f, 1.0f,
+            0.7826f, 0.15693f, 0.01264f, 1.0f,
             0.77377f, 0.15028f, 0.01148f, 1.0f,
             0.76476f, 0.14374f, 0.01041f, 1.0f,
             0.75556f, 0.13731f, 0.00942f, 1.0f,
@@ -255,7 +257,7 @@ namespace colormap {
             0.65345f, 0.07902f, 0.00408f, 1.0f,
             0.64223f, 0.0738f, 0.00401f, 1.0f,
             0.63082f, 0.06868f, 0.00401f, 1.0f,
-            0.6192300000000003f, 0.06367000000000014f, 0.004099999999999998f, 1.0f,
+            0.61923f, 0.06367f, 0.0041f, 1.0f,
             0.60746f, 0.05878f, 0.00427f, 1.0f,
             0.5955f, 0.05399f, 0.00453f, 1.0f,
             0.58336f, 0.04931f, 0.00486f, 1.0f,
@@ -267,14 +269,10 @@ namespace colormap {
             0.50664f, 0.02354f, 0.00863f, 1.0f,
             0.49321f, 0.01963f, 0.00955f, 1.0f,
             0.4796f, 0.01583f, 0.01055f, 1.0f,
-        };
-
-        return data;
-    }
+    };
 
-    const vector<float>& viridis() {
-        // "viridis" colormap data generated with scripts/sample-colormap.py
-        static const vector<float> data = {
+    // "viridis" colormap data generated with scripts/sample-colormap.py
+    static constexpr ColorMapData VIRIDIS = {
             0.267004f, 0.004874f, 0.329415f, 1.0f,
             0.26851f, 0.009605f, 0.335427f, 1.0f,
             0.269944f, 0.014625f, 0.341379f, 1.0f,
@@ -531,9 +529,278 @@ namespace colormap {
             0.974417f, 0.90359f, 0.130215f, 1.0f,
             0.983868f, 0.904867f, 0.136897f, 1.0f,
             0.993248f, 0.906157f, 0.143936f, 1.0f,
-        };
+    };
+
+    // "inferno" colormap data sampled from the polynomial fit by Matt Zucker
+    // (https://www.shadertoy.com/view/WlfXRN), which matches matplotlib's
+    // table to within ~1%; scripts/sample-colormap.py needs matplotlib at
+    // generation time.
+    static constexpr ColorMapData INFERNO = {
+            0.000219f, 0.001651f, 0.0f, 1.0f,
+            0.000813f, 0.003803f, 0.0f, 1.0f,
+            0.001748f, 0.005838f, 0.010404f, 1.0f,
+            0.003011f, 0.007764f, 0.02465f, 1.0f,
+            0.004588f, 0.009585f, 0.038452f, 1.0f,
+            0.006465f, 0.011308f, 0.051824f, 1.0f,
+            0.008629f, 0.012938f, 0.064781f, 1.0f,
+            0.011066f, 0.014481f, 0.077335f, 1.0f,
+            0.013765f, 0.015941f, 0.0895f, 1.0f,
+            0.016714f, 0.017323f, 0.101289f, 1.0f,
+            0.0199f, 0.018633f, 0.112714f, 1.0f,
+            0.023313f, 0.019875f, 0.123787f, 1.0f,
+            0.026942f, 0.021053f, 0.134521f, 1.0f,
+            0.030775f, 0.022172f, 0.144925f, 1.0f,
+            0.034804f, 0.023236f, 0.155011f, 1.0f,
+            0.039018f, 0.02425f, 0.16479f, 1.0f,
+            0.043407f, 0.025216f, 0.174272f, 1.0f,
+            0.047962f, 0.026139f, 0.183465f, 1.0f,
+            0.052675f, 0.027023f, 0.192381f, 1.0f,
+            0.057537f, 0.027871f, 0.201027f, 1.0f,
+            0.062539f, 0.028686f, 0.209414f, 1.0f,
+            0.067673f, 0.029473f, 0.217548f, 1.0f,
+            0.072933f, 0.030232f, 0.225439f, 1.0f,
+            0.07831f, 0.030969f, 0.233094f, 1.0f,
+            0.083797f, 0.031686f, 0.240521f, 1.0f,
+            0.089387f, 0.032384f, 0.247727f, 1.0f,
+            0.095075f, 0.033069f, 0.254718f, 1.0f,
+            0.100853f, 0.033741f, 0.261503f, 1.0f,
+            0.106716f, 0.034403f, 0.268087f, 1.0f,
+            0.112657f, 0.035058f, 0.274476f, 1.0f,
+            0.118671f, 0.035707f, 0.280676f, 1.0f,
+            0.124753f, 0.036354f, 0.286692f, 1.0f,
+            0.130898f, 0.037f, 0.292531f, 1.0f,
+            0.137101f, 0.037647f, 0.298198f, 1.0f,
+            0.143356f, 0.038297f, 0.303696f, 1.0f,
+            0.149661f, 0.038951f, 0.309032f, 1.0f,
+            0.156009f, 0.039612f, 0.314209f, 1.0f,
+            0.162398f, 0.040281f, 0.319232f, 1.0f,
+            0.168824f, 0.04096f, 0.324104f, 1.0f,
+            0.175282f, 0.04165f, 0.32883f, 1.0f,
+            0.181769f, 0.042352f, 0.333413f, 1.0f,
+            0.188283f, 0.043068f, 0.337856f, 1.0f,
+            0.194819f, 0.043799f, 0.342164f, 1.0f,
+            0.201375f, 0.044546f, 0.346338f, 1.0f,
+            0.207949f, 0.045311f, 0.350383f, 1.0f,
+            0.214536f, 0.046094f, 0.354299f, 1.0f,
+            0.221136f, 0.046897f, 0.358092f, 1.0f,
+            0.227745f, 0.04772f, 0.361761f, 1.0f,
+            0.234362f, 0.048564f, 0.36531f, 1.0f,
+            0.240984f, 0.04943f, 0.368742f, 1.0f,
+            0.247609f, 0.05032f, 0.372057f, 1.0f,
+            0.254236f, 0.051232f, 0.375258f, 1.0f,
+            0.260863f, 0.052169f, 0.378346f, 1.0f,
+            0.267488f, 0.053131f, 0.381323f, 1.0f,
+            0.274111f, 0.054119f, 0.384191f, 1.0f,
+            0.280728f, 0.055132f, 0.38695f, 1.0f,
+            0.28734f, 0.056172f, 0.389603f, 1.0f,
+            0.293946f, 0.057239f, 0.392149f, 1.0f,
+            0.300543f, 0.058333f, 0.394591f, 1.0f,
+            0.307132f, 0.059455f, 0.396928f, 1.0f,
+            0.313711f, 0.060605f, 0.399162f, 1.0f,
+            0.320279f, 0.061784f, 0.401294f, 1.0f,
+            0.326837f, 0.062992f, 0.403324f, 1.0f,
+            0.333382f, 0.064228f, 0.405252f, 1.0f,
+            0.339916f, 0.065494f, 0.40708f, 1.0f,
+            0.346436f, 0.06679f, 0.408807f, 1.0f,
+            0.352944f, 0.068115f, 0.410435f, 1.0f,
+            0.359438f, 0.06947f, 0.411962f, 1.0f,
+            0.365918f, 0.070856f, 0.41339f, 1.0f,
+            0.372385f, 0.072271f, 0.414719f, 1.0f,
+            0.378837f, 0.073717f, 0.415948f, 1.0f,
+            0.385275f, 0.075193f, 0.417078f, 1.0f,
+            0.391698f, 0.0767f, 0.418109f, 1.0f,
+            0.398107f, 0.078238f, 0.419041f, 1.0f,
+            0.404501f, 0.079806f, 0.419874f, 1.0f,
+            0.410881f, 0.081405f, 0.420607f, 1.0f,
+            0.417246f, 0.083035f, 0.421241f, 1.0f,
+            0.423597f, 0.084695f, 0.421776f, 1.0f,
+            0.429934f, 0.086387f, 0.422211f, 1.0f,
+            0.436257f, 0.088109f, 0.422546f, 1.0f,
+            0.442565f, 0.089863f, 0.422781f, 1.0f,
+            0.44886f, 0.091647f, 0.422917f, 1.0f,
+            0.455141f, 0.093463f, 0.422951f, 1.0f,
+            0.461408f, 0.09531f, 0.422886f, 1.0f,
+            0.467662f, 0.097187f, 0.42272f, 1.0f,
+            0.473904f, 0.099096f, 0.422453f, 1.0f,
+            0.480132f, 0.101036f, 0.422085f, 1.0f,
+            0.486347f, 0.103007f, 0.421615f, 1.0f,
+            0.49255f, 0.105009f, 0.421045f, 1.0f,
+            0.49874f, 0.107042f, 0.420373f, 1.0f,
+            0.504919f, 0.109107f, 0.419599f, 1.0f,
+            0.511085f, 0.111203f, 0.418724f, 1.0f,
+            0.51724f, 0.11333f, 0.417747f, 1.0f,
+            0.523383f, 0.115489f, 0.416668f, 1.0f,
+            0.529514f, 0.11768f, 0.415488f, 1.0f,
+            0.535635f, 0.119902f, 0.414205f, 1.0f,
+            0.541744f, 0.122155f, 0.412821f, 1.0f,
+            0.547841f, 0.124441f, 0.411336f, 1.0f,
+            0.553928f, 0.126759f, 0.409748f, 1.0f,
+            0.560004f, 0.129108f, 0.40806f, 1.0f,
+            0.566068f, 0.13149f, 0.40627f, 1.0f,
+            0.572122f, 0.133904f, 0.40438f, 1.0f,
+            0.578165f, 0.136351f, 0.402389f, 1.0f,
+            0.584196f, 0.13883f, 0.400297f, 1.0f,
+            0.590217f, 0.141343f, 0.398106f, 1.0f,
+            0.596226f, 0.143888f, 0.395816f, 1.0f,
+            0.602224f, 0.146467f, 0.393427f, 1.0f,
+            0.60821f, 0.14908f, 0.39094f, 1.0f,
+            0.614184f, 0.151726f, 0.388355f, 1.0f,
+            0.620147f, 0.154407f, 0.385673f, 1.0f,
+            0.626097f, 0.157122f, 0.382895f, 1.0f,
+            0.632034f, 0.159871f, 0.380022f, 1.0f,
+            0.637958f, 0.162656f, 0.377055f, 1.0f,
+            0.643869f, 0.165476f, 0.373994f, 1.0f,
+            0.649766f, 0.168332f, 0.370841f, 1.0f,
+            0.655649f, 0.171224f, 0.367597f, 1.0f,
+            0.661517f, 0.174152f, 0.364262f, 1.0f,
+            0.66737f, 0.177117f, 0.360839f, 1.0f,
+            0.673207f, 0.18012f, 0.357328f, 1.0f,
+            0.679027f, 0.18316f, 0.353731f, 1.0f,
+            0.68483f, 0.186238f, 0.35005f, 1.0f,
+            0.690615f, 0.189355f, 0.346285f, 1.0f,
+            0.696381f, 0.192511f, 0.342439f, 1.0f,
+            0.702128f, 0.195707f, 0.338514f, 1.0f,
+            0.707855f, 0.198942f, 0.33451f, 1.0f,
+            0.71356f, 0.202219f, 0.330431f, 1.0f,
+            0.719243f, 0.205536f, 0.326277f, 1.0f,
+            0.724903f, 0.208896f, 0.322051f, 1.0f,
+            0.73054f, 0.212297f, 0.317755f, 1.0f,
+            0.736151f, 0.215741f, 0.313392f, 1.0f,
+            0.741736f, 0.219229f, 0.308963f, 1.0f,
+            0.747294f, 0.222761f, 0.304471f, 1.0f,
+            0.752823f, 0.226337f, 0.299918f, 1.0f,
+            0.758323f, 0.229959f, 0.295307f, 1.0f,
+            0.763792f, 0.233626f, 0.290641f, 1.0f,
+            0.769229f, 0.23734f, 0.285922f, 1.0f,
+            0.774632f, 0.241102f, 0.281153f, 1.0f,
+            0.780001f, 0.244911f, 0.276338f, 1.0f,
+            0.785334f, 0.248768f, 0.271477f, 1.0f,
+            0.79063f, 0.252675f, 0.266576f, 1.0f,
+            0.795886f, 0.256632f, 0.261637f, 1.0f,
+            0.801103f, 0.260639f, 0.256663f, 1.0f,
+            0.806277f, 0.264698f, 0.251658f, 1.0f,
+            0.811409f, 0.268808f, 0.246625f, 1.0f,
+            0.816496f, 0.272971f, 0.241567f, 1.0f,
+            0.821536f, 0.277187f, 0.236488f, 1.0f,
+            0.826528f, 0.281458f, 0.231392f, 1.0f,
+            0.831471f, 0.285783f, 0.226283f, 1.0f,
+            0.836363f, 0.290164f, 0.221163f, 1.0f,
+            0.841202f, 0.2946f, 0.216037f, 1.0f,
+            0.845986f, 0.299094f, 0.21091f, 1.0f,
+            0.850715f, 0.303645f, 0.205784f, 1.0f,
+            0.855386f, 0.308254f, 0.200665f, 1.0f,
+            0.859997f, 0.312923f, 0.195556f, 1.0f,
+            0.864547f, 0.31765f, 0.190462f, 1.0f,
+            0.869034f, 0.322438f, 0.185386f, 1.0f,
+            0.873457f, 0.327287f, 0.180334f, 1.0f,
+            0.877814f, 0.332197f, 0.17531f, 1.0f,
+            0.882102f, 0.33717f, 0.170318f, 1.0f,
+            0.886321f, 0.342205f, 0.165363f, 1.0f,
+            0.890468f, 0.347304f, 0.160451f, 1.0f,
+            0.894543f, 0.352466f, 0.155584f, 1.0f,
+            0.898543f, 0.357693f, 0.150769f, 1.0f,
+            0.902466f, 0.362985f, 0.146011f, 1.0f,
+            0.906311f, 0.368342f, 0.141313f, 1.0f,
+            0.910077f, 0.373765f, 0.136682f, 1.0f,
+            0.913761f, 0.379255f, 0.132122f, 1.0f,
+            0.917362f, 0.384812f, 0.127639f, 1.0f,
+            0.920879f, 0.390436f, 0.123238f, 1.0f,
+            0.92431f, 0.396127f, 0.118923f, 1.0f,
+            0.927654f, 0.401887f, 0.114701f, 1.0f,
+            0.930908f, 0.407715f, 0.110576f, 1.0f,
+            0.934072f, 0.413612f, 0.106554f, 1.0f,
+            0.937145f, 0.419577f, 0.102641f, 1.0f,
+            0.940124f, 0.425612f, 0.098842f, 1.0f,
+            0.943009f, 0.431716f, 0.095162f, 1.0f,
+            0.945798f, 0.437889f, 0.091608f, 1.0f,
+            0.948491f, 0.444131f, 0.088184f, 1.0f,
+            0.951085f, 0.450443f, 0.084896f, 1.0f,
+            0.953581f, 0.456825f, 0.08175f, 1.0f,
+            0.955977f, 0.463276f, 0.078752f, 1.0f,
+            0.958272f, 0.469796f, 0.075907f, 1.0f,
+            0.960465f, 0.476385f, 0.073222f, 1.0f,
+            0.962556f, 0.483042f, 0.070701f, 1.0f,
+            0.964544f, 0.489769f, 0.068352f, 1.0f,
+            0.966429f, 0.496563f, 0.066178f, 1.0f,
+            0.968209f, 0.503425f, 0.064187f, 1.0f,
+            0.969884f, 0.510355f, 0.062385f, 1.0f,
+            0.971455f, 0.517351f, 0.060776f, 1.0f,
+            0.972921f, 0.524413f, 0.059367f, 1.0f,
+            0.974281f, 0.53154f, 0.058164f, 1.0f,
+            0.975537f, 0.538732f, 0.057172f, 1.0f,
+            0.976687f, 0.545987f, 0.056398f, 1.0f,
+            0.977733f, 0.553305f, 0.055846f, 1.0f,
+            0.978674f, 0.560685f, 0.055524f, 1.0f,
+            0.979512f, 0.568126f, 0.055437f, 1.0f,
+            0.980247f, 0.575625f, 0.05559f, 1.0f,
+            0.980879f, 0.583183f, 0.055989f, 1.0f,
+            0.98141f, 0.590798f, 0.05664f, 1.0f,
+            0.981841f, 0.598468f, 0.057549f, 1.0f,
+            0.982173f, 0.606191f, 0.058721f, 1.0f,
+            0.982407f, 0.613967f, 0.060162f, 1.0f,
+            0.982545f, 0.621792f, 0.061877f, 1.0f,
+            0.98259f, 0.629666f, 0.063873f, 1.0f,
+            0.982541f, 0.637586f, 0.066153f, 1.0f,
+            0.982403f, 0.64555f, 0.068725f, 1.0f,
+            0.982177f, 0.653557f, 0.071593f, 1.0f,
+            0.981866f, 0.661602f, 0.074762f, 1.0f,
+            0.981471f, 0.669685f, 0.078238f, 1.0f,
+            0.980998f, 0.677803f, 0.082026f, 1.0f,
+            0.980447f, 0.685952f, 0.086131f, 1.0f,
+            0.979824f, 0.69413f, 0.090558f, 1.0f,
+            0.97913f, 0.702334f, 0.095311f, 1.0f,
+            0.978371f, 0.710561f, 0.100396f, 1.0f,
+            0.97755f, 0.718807f, 0.105818f, 1.0f,
+            0.976671f, 0.727069f, 0.11158f, 1.0f,
+            0.975739f, 0.735344f, 0.117688f, 1.0f,
+            0.974758f, 0.743628f, 0.124146f, 1.0f,
+            0.973734f, 0.751917f, 0.130958f, 1.0f,
+            0.972672f, 0.760207f, 0.138128f, 1.0f,
+            0.971578f, 0.768493f, 0.145661f, 1.0f,
+            0.970457f, 0.776772f, 0.15356f, 1.0f,
+            0.969315f, 0.785039f, 0.16183f, 1.0f,
+            0.968159f, 0.79329f, 0.170473f, 1.0f,
+            0.966995f, 0.801518f, 0.179493f, 1.0f,
+            0.965831f, 0.80972f, 0.188894f, 1.0f,
+            0.964674f, 0.81789f, 0.198678f, 1.0f,
+            0.963531f, 0.826023f, 0.20885f, 1.0f,
+            0.962411f, 0.834113f, 0.219411f, 1.0f,
+            0.961322f, 0.842155f, 0.230365f, 1.0f,
+            0.960271f, 0.850142f, 0.241714f, 1.0f,
+            0.959269f, 0.858068f, 0.25346f, 1.0f,
+            0.958325f, 0.865927f, 0.265606f, 1.0f,
+            0.957448f, 0.873713f, 0.278153f, 1.0f,
+            0.956649f, 0.881418f, 0.291103f, 1.0f,
+            0.955937f, 0.889036f, 0.304458f, 1.0f,
+            0.955324f, 0.896559f, 0.318219f, 1.0f,
+            0.954821f, 0.90398f, 0.332387f, 1.0f,
+            0.954439f, 0.911291f, 0.346964f, 1.0f,
+            0.954191f, 0.918485f, 0.361949f, 1.0f,
+            0.954089f, 0.925552f, 0.377343f, 1.0f,
+            0.954145f, 0.932486f, 0.393147f, 1.0f,
+            0.954374f, 0.939277f, 0.409361f, 1.0f,
+            0.954788f, 0.945916f, 0.425983f, 1.0f,
+            0.955402f, 0.952395f, 0.443014f, 1.0f,
+            0.956231f, 0.958703f, 0.460452f, 1.0f,
+            0.957289f, 0.964832f, 0.478297f, 1.0f,
+            0.958592f, 0.970772f, 0.496547f, 1.0f,
+            0.960156f, 0.976511f, 0.515201f, 1.0f,
+            0.961997f, 0.982041f, 0.534256f, 1.0f,
+            0.964134f, 0.98735f, 0.55371f, 1.0f,
+            0.966582f, 0.992427f, 0.573561f, 1.0f,
+            0.96936f, 0.997261f, 0.593806f, 1.0f,
+            0.972487f, 1.0f, 0.614441f, 1.0f,
+            0.975981f, 1.0f, 0.635463f, 1.0f,
+            0.979863f, 1.0f, 0.656868f, 1.0f,
+    };
 
-        return data;
+    const ColorMapData& data(EColorMap map) {
+        switch (map) {
+            case EColorMap::Turbo: return TURBO;
+            case EColorMap::Viridis: return VIRIDIS;
+            case EColorMap::Inferno: return INFERNO;
+            default: throw runtime_error{"Invalid colormap."};
+        }
     }
 }
 
@@ -0,0 +1,380 @@
+// This file was developed by Thomas Müller <thomas94@gmx.net>.
+// It is published under the BSD 3-Clause License within the LICENSE file.
+
+#include <tev/FileWatcher.h>
+
+#if defined(__linux__)
+#   include <sys/inotify.h>
+#   include <sys/select.h>
+#   include <unistd.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+#   include <fcntl.h>
+#   include <sys/event.h>
+#   include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace tev {
+
+FileWatcher::FileWatcher(Callback callback)
+: mCallback{std::move(callback)} {
+}
+
+#if defined(_WIN32)
+
+unique_ptr<FileWatcher> FileWatcher::create(Callback callback) {
+    unique_ptr<FileWatcher> watcher{new FileWatcher{std::move(callback)}};
+
+    watcher->mIocp = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+    if (!watcher->mIocp) {
+        tlog::warning() << "Could not create I/O completion port: " << errorString(lastError());
+        return nullptr;
+    }
+
+    watcher->mThread = thread{[w = watcher.get()] { w->watcherLoop(); }};
+    return watcher;
+}
+
+FileWatcher::~FileWatcher() {
+    mShallShutdown = true;
+    if (mThread.joinable()) {
+        PostQueuedCompletionStatus(mIocp, 0, 0, nullptr);
+        mThread.join();
+    }
+
+    for (auto& watch : mWatches) {
+        CancelIo(watch->handle);
+        CloseHandle(watch->handle);
+    }
+
+    if (mIocp) {
+        CloseHandle(mIocp);
+    }
+}
+
+void FileWatcher::watch(const fs::path& dir, bool recursive) {
+    auto watch = make_unique<DirectoryWatch>();
+    watch->handle = CreateFileW(
+        dir.c_str(), FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED,
+        nullptr
+    );
+
+    if (watch->handle == INVALID_HANDLE_VALUE) {
+        tlog::warning() << fmt::format("Could not watch {}: {}", toString(dir), errorString(lastError()));
+        return;
+    }
+
+    watch->path = dir;
+    watch->recursive = recursive;
+
+    CreateIoCompletionPort(watch->handle, mIocp, (ULONG_PTR)watch.get(), 0);
+    issueRead(*watch);
+
+    lock_guard lock{mWatchMutex};
+    mWatches.emplace_back(std::move(watch));
+}
+
+void FileWatcher::issueRead(DirectoryWatch& watch) {
+    ReadDirectoryChangesW(
+        watch.handle, watch.buffer, sizeof(watch.buffer), watch.recursive,
+        FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+        nullptr, &watch.overlapped, nullptr
+    );
+}
+
+void FileWatcher::watcherLoop() {
+    while (true) {
+        DWORD numBytes = 0;
+        ULONG_PTR key = 0;
+        LPOVERLAPPED overlapped = nullptr;
+        BOOL success = GetQueuedCompletionStatus(mIocp, &numBytes, &key, &overlapped, INFINITE);
+
+        if (mShallShutdown) {
+            return;
+        }
+
+        if (!key) {
+            continue;
+        }
+
+        auto& watch = *(DirectoryWatch*)key;
+        if (success && numBytes > 0) {
+            size_t offset = 0;
+            while (true) {
+                const auto& info = *(const FILE_NOTIFY_INFORMATION*)(watch.buffer + offset);
+                wstring name{info.FileName, info.FileNameLength / sizeof(wchar_t)};
+                mCallback((watch.path / name).parent_path());
+
+                if (!info.NextEntryOffset) {
+                    break;
+                }
+
+                offset += info.NextEntryOffset;
+            }
+        } else {
+            // The change buffer overflowed; conservatively rescan the
+            // whole watched tree.
+            mCallback(watch.path);
+        }
+
+        issueRead(watch);
+    }
+}
+
+#elif defined(__linux__)
+
+unique_ptr<FileWatcher> FileWatcher::create(Callback callback) {
+    unique_ptr<FileWatcher> watcher{new FileWatcher{std::move(callback)}};
+
+    watcher->mInotifyFd = inotify_init1(IN_CLOEXEC);
+    if (watcher->mInotifyFd < 0) {
+        tlog::warning() << "Could not initialize inotify: " << errorString(lastError());
+        return nullptr;
+    }
+
+    if (pipe(watcher->mWakeupFds) < 0) {
+        tlog::warning() << "Could not create wakeup pipe: " << errorString(lastError());
+        return nullptr;
+    }
+
+    watcher->mThread = thread{[w = watcher.get()] { w->watcherLoop(); }};
+    return watcher;
+}
+
+FileWatcher::~FileWatcher() {
+    mShallShutdown = true;
+    if (mThread.joinable()) {
+        char wakeup = 0;
+        (void)write(mWakeupFds[1], &wakeup, 1);
+        mThread.join();
+    }
+
+    for (int fd : mWakeupFds) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    if (mInotifyFd >= 0) {
+        close(mInotifyFd);
+    }
+}
+
+void FileWatcher::watch(const fs::path& dir, bool recursive) {
+    addWatch(dir, recursive);
+
+    // inotify watches are not recursive, so subdirectories each get their
+    // own. Newly created ones are picked up in the watcher loop.
+    if (recursive) {
+        forEachFileInDir(true, dir, [&](auto const& entry) {
+            if (entry.is_directory()) {
+                addWatch(entry.path(), true);
+            }
+        });
+    }
+}
+
+void FileWatcher::addWatch(const fs::path& dir, bool recursive) {
+    int wd = inotify_add_watch(mInotifyFd, dir.c_str(), IN_CREATE | IN_CLOSE_WRITE | IN_MOVED_TO | IN_ONLYDIR);
+    if (wd < 0) {
+        tlog::warning() << fmt::format("Could not watch {}: {}", toString(dir), errorString(lastError()));
+        return;
+    }
+
+    lock_guard lock{mWatchMutex};
+    mWatches[wd] = {dir, recursive};
+}
+
+void FileWatcher::watcherLoop() {
+    while (!mShallShutdown) {
+        fd_set fds;
+        FD_ZERO(&fds);
+        FD_SET(mInotifyFd, &fds);
+        FD_SET(mWakeupFds[0], &fds);
+
+        if (select(max(mInotifyFd, mWakeupFds[0]) + 1, &fds, nullptr, nullptr, nullptr) <= 0) {
+            continue;
+        }
+
+        if (!FD_ISSET(mInotifyFd, &fds)) {
+            continue;
+        }
+
+        alignas(inotify_event) char buffer[16 * 1024];
+        ssize_t numBytes = read(mInotifyFd, buffer, sizeof(buffer));
+        if (numBytes <= 0) {
+            continue;
+        }
+
+        for (ssize_t offset = 0; offset < numBytes;) {
+            const auto& event = *(const inotify_event*)(buffer + offset);
+            offset += sizeof(inotify_event) + event.len;
+
+            if (event.mask & IN_Q_OVERFLOW) {
+                // The kernel dropped events; conservatively rescan everything.
+                lock_guard lock{mWatchMutex};
+                for (const auto& watch : mWatches) {
+                    mCallback(watch.second.first);
+                }
+
+                continue;
+            }
+
+            fs::path dir;
+            bool recursive = false;
+            {
+                lock_guard lock{mWatchMutex};
+                auto iter = mWatches.find(event.wd);
+                if (iter == end(mWatches)) {
+                    continue;
+                }
+
+                dir = iter->second.first;
+                recursive = iter->second.second;
+            }
+
+            if (recursive && (event.mask & IN_ISDIR) && (event.mask & (IN_CREATE | IN_MOVED_TO))) {
+                // A directory moved in wholesale may already contain a tree
+                // of its own; watch all of it.
+                watch(dir / event.name, true);
+            }
+
+            mCallback(dir);
+        }
+    }
+}
+
+#elif defined(__APPLE__) || defined(__FreeBSD__)
+
+unique_ptr<FileWatcher> FileWatcher::create(Callback callback) {
+    unique_ptr<FileWatcher> watcher{new FileWatcher{std::move(callback)}};
+
+    watcher->mKqueueFd = kqueue();
+    if (watcher->mKqueueFd < 0) {
+        tlog::warning() << "Could not initialize kqueue: " << errorString(lastError());
+        return nullptr;
+    }
+
+    // User event 0 doubles as the shutdown wakeup.
+    struct kevent wakeup;
+    EV_SET(&wakeup, 0, EVFILT_USER, EV_ADD | EV_CLEAR, 0, 0, nullptr);
+    kevent(watcher->mKqueueFd, &wakeup, 1, nullptr, 0, nullptr);
+
+    watcher->mThread = thread{[w = watcher.get()] { w->watcherLoop(); }};
+    return watcher;
+}
+
+FileWatcher::~FileWatcher() {
+    mShallShutdown = true;
+    if (mThread.joinable()) {
+        struct kevent wakeup;
+        EV_SET(&wakeup, 0, EVFILT_USER, 0, NOTE_TRIGGER, 0, nullptr);
+        kevent(mKqueueFd, &wakeup, 1, nullptr, 0, nullptr);
+        mThread.join();
+    }
+
+    for (const auto& watch : mWatches) {
+        close(watch.first);
+    }
+
+    if (mKqueueFd >= 0) {
+        close(mKqueueFd);
+    }
+}
+
+void FileWatcher::watch(const fs::path& dir, bool recursive) {
+    addWatch(dir, recursive);
+
+    // kqueue watches a single directory's entry list, so subdirectories each
+    // get their own. Newly created ones are picked up in the watcher loop.
+    if (recursive) {
+        forEachFileInDir(true, dir, [&](auto const& entry) {
+            if (entry.is_directory()) {
+                addWatch(entry.path(), true);
+            }
+        });
+    }
+}
+
+void FileWatcher::addWatch(const fs::path& dir, bool recursive) {
+    {
+        lock_guard lock{mWatchMutex};
+        if (mWatchedPaths.contains(dir)) {
+            return;
+        }
+    }
+
+#ifdef O_EVTONLY
+    int fd = open(dir.c_str(), O_EVTONLY);
+#else
+    int fd = open(dir.c_str(), O_RDONLY);
+#endif
+    if (fd < 0) {
+        tlog::warning() << fmt::format("Could not watch {}: {}", toString(dir), errorString(lastError()));
+        return;
+    }
+
+    struct kevent event;
+    EV_SET(&event, fd, EVFILT_VNODE, EV_ADD | EV_CLEAR, NOTE_WRITE | NOTE_EXTEND | NOTE_RENAME | NOTE_DELETE, 0, nullptr);
+    kevent(mKqueueFd, &event, 1, nullptr, 0, nullptr);
+
+    lock_guard lock{mWatchMutex};
+    mWatches[fd] = {dir, recursive};
+    mWatchedPaths.insert(dir);
+}
+
+void FileWatcher::watcherLoop() {
+    while (!mShallShutdown) {
+        struct kevent events[32];
+        int numEvents = kevent(mKqueueFd, nullptr, 0, events, 32, nullptr);
+
+        for (int i = 0; i < numEvents; ++i) {
+            if (events[i].filter != EVFILT_VNODE) {
+                continue;
+            }
+
+            fs::path dir;
+            bool recursive = false;
+            {
+                lock_guard lock{mWatchMutex};
+                auto iter = mWatches.find((int)events[i].ident);
+                if (iter == end(mWatches)) {
+                    continue;
+                }
+
+                dir = iter->second.first;
+                recursive = iter->second.second;
+            }
+
+            // kqueue only reports that the directory's entry list changed,
+            // not which entry; new subdirectories are found by scanning.
+            if (recursive) {
+                forEachFileInDir(false, dir, [&](auto const& entry) {
+                    if (entry.is_directory()) {
+                        watch(entry.path(), true);
+                    }
+                });
+            }
+
+            mCallback(dir);
+        }
+    }
+}
+
+#else
+
+unique_ptr<FileWatcher> FileWatcher::create(Callback) {
+    return nullptr;
+}
+
+FileWatcher::~FileWatcher() {}
+
+void FileWatcher::watch(const fs::path&, bool) {}
+
+#endif
+
+}
@@ -92,6 +92,7 @@ HelpWindow::HelpWindow(Widget* parent, bool supportsHdr, function<void()> closeC
     if (supportsHdr) {
         addRow(imageSelection, "L", "Display the image as if on an LDR screen");
     }
+    addRow(imageSelection, "T", "Restrict statistics to the visible region");
 
     addRow(imageSelection, "Shift+Right or Shift+D / Shift+Left or Shift+A", "Select next / previous tonemap");
 
@@ -4,12 +4,14 @@
 #include <tev/Image.h>
 #include <tev/imageio/ImageLoader.h>
 #include <tev/ThreadPool.h>
+#include <tev/Trace.h>
 
 #include <Iex.h>
 
 #include <GLFW/glfw3.h>
 
 #include <chrono>
+#include <cstring>
 #include <fstream>
 #include <istream>
 
@@ -36,6 +38,57 @@ vector<string> ImageData::channelsInLayer(string layerName) const {
     return result;
 }
 
+// The load-time color transform as a vectorized SoA kernel: the R/G/B
+// channel arrays are processed directly with the matrix hoisted into scalar
+// coefficients, so the loop compiles down to fused multiply-adds over whole
+// registers and runs at memory speed. Alpha premultiplication is fused in
+// where requested, with the alpha representation a template parameter such
+// that no per-pixel branch lands in the loop.
+enum class EAlphaKind {
+    None,
+    Float,
+    Half,
+};
+
+template <EAlphaKind A>
+static void applyColorMatrixToRow(
+    const Matrix4f& m, float* r, float* g, float* b,
+    const float* alphaFloat, const uint16_t* alphaHalf, size_t n
+) {
+    const float m00 = m.m[0][0], m10 = m.m[1][0], m20 = m.m[2][0], m30 = m.m[3][0];
+    const float m01 = m.m[0][1], m11 = m.m[1][1], m21 = m.m[2][1], m31 = m.m[3][1];
+    const float m02 = m.m[0][2], m12 = m.m[1][2], m22 = m.m[2][2], m32 = m.m[3][2];
+
+    for (size_t i = 0; i < n; ++i) {
+        float x = r[i], y = g[i], z = b[i];
+        float outR = m00 * x + m10 * y + m20 * z + m30;
+        float outG = m01 * x + m11 * y + m21 * z + m31;
+        float outB = m02 * x + m12 * y + m22 * z + m32;
+
+        if constexpr (A == EAlphaKind::Float) {
+            outR *= alphaFloat[i];
+            outG *= alphaFloat[i];
+            outB *= alphaFloat[i];
+        } else if constexpr (A == EAlphaKind::Half) {
+            float a = halfToFloat(alphaHalf[i]);
+            outR *= a;
+            outG *= a;
+            outB *= a;
+        }
+
+        r[i] = outR;
+        g[i] = outG;
+        b[i] = outB;
+    }
+}
+
+// The kernel above assumes an affine matrix. Projective matrices do not
+// occur for chromaticity conversions, but the exact homogeneous behavior is
+// kept as a scalar fallback just in case.
+static bool isAffine(const Matrix4f& m) {
+    return m.m[0][3] == 0 && m.m[1][3] == 0 && m.m[2][3] == 0 && m.m[3][3] == 1;
+}
+
 Task<void> ImageData::convertToRec709(int priority) {
     // No need to do anything for identity transforms
     if (toRec709 == Matrix4f{1.0f}) {
@@ -59,25 +112,135 @@ Task<void> ImageData::convertToRec709(int priority) {
 
         TEV_ASSERT(r && g && b, "RGB triplet of channels must exist.");
 
-        tasks.emplace_back(
-            ThreadPool::global().parallelForAsync<size_t>(0, r->numPixels(), [r, g, b, this](size_t i) {
-                auto rgb = toRec709 * Vector3f{r->at(i), g->at(i), b->at(i)};
-                r->at(i) = rgb.x();
-                g->at(i) = rgb.y();
-                b->at(i) = rgb.z();
-            }, priority)
-        );
-    }
+        r->ensureFloatStorage();
+        g->ensureFloatStorage();
+        b->ensureFloatStorage();
+
+        if (isAffine(toRec709)) {
+            size_t width = (size_t)r->size().x();
+            size_t numRows = r->numPixels() / width;
+            float* rd = r->data().data();
+            float* gd = g->data().data();
+            float* bd = b->data().data();
 
-    for (auto& task : tasks) {
-        co_await task;
+            tasks.emplace_back(
+                ThreadPool::global().parallelForAsync<size_t>(0, numRows, [rd, gd, bd, width, this](size_t y) {
+                    size_t o = y * width;
+                    applyColorMatrixToRow<EAlphaKind::None>(toRec709, rd + o, gd + o, bd + o, nullptr, nullptr, width);
+                }, priority)
+            );
+        } else {
+            tasks.emplace_back(
+                ThreadPool::global().parallelForAsync<size_t>(0, r->numPixels(), [r, g, b, this](size_t i) {
+                    auto rgb = toRec709 * Vector3f{r->at(i), g->at(i), b->at(i)};
+                    r->at(i) = rgb.x();
+                    g->at(i) = rgb.y();
+                    b->at(i) = rgb.z();
+                }, priority)
+            );
+        }
     }
 
+    co_await whenAll(tasks);
+
     // Since the image data is now in Rec709 space,
     // converting to Rec709 is the identity transform.
     toRec709 = Matrix4f{1.0f};
 }
 
+Task<void> ImageData::convertToRec709AndPremultiply(int priority) {
+    bool needsRec709 = toRec709 != Matrix4f{1.0f};
+    bool needsAlpha = !hasPremultipliedAlpha;
+
+    // Already-premultiplied Rec709 sources need no post-processing at all.
+    if (!needsRec709 && !needsAlpha) {
+        co_return;
+    }
+
+    vector<Task<void>> tasks;
+
+    for (const auto& layer : layers) {
+        Channel* r = nullptr;
+        Channel* g = nullptr;
+        Channel* b = nullptr;
+
+        bool hasRgb =
+            ((r = mutableChannel(layer + "R")) && (g = mutableChannel(layer + "G")) && (b = mutableChannel(layer + "B"))) ||
+            ((r = mutableChannel(layer + "r")) && (g = mutableChannel(layer + "g")) && (b = mutableChannel(layer + "b")));
+
+        if (!hasRgb) {
+            r = g = b = nullptr;
+        }
+
+        string alphaChannelName = layer + "A";
+        const Channel* alphaChannel = needsAlpha ? channel(alphaChannelName) : nullptr;
+
+        // The RGB triplet gets the fused kernel: the color-space matrix and
+        // the alpha premultiplication are both applied while the pixel tuple
+        // is in registers, so each channel is read and written only once.
+        if (hasRgb && (needsRec709 || alphaChannel)) {
+            r->ensureFloatStorage();
+            g->ensureFloatStorage();
+            b->ensureFloatStorage();
+
+            if (!needsRec709 || isAffine(toRec709)) {
+                size_t width = (size_t)r->size().x();
+                size_t numRows = r->numPixels() / width;
+                float* rd = r->data().data();
+                float* gd = g->data().data();
+                float* bd = b->data().data();
+                const float* alphaFloat = alphaChannel && alphaChannel->format() == EPixelFormat::F32 ? alphaChannel->data().data() : nullptr;
+                const uint16_t* alphaHalf = alphaChannel && alphaChannel->format() == EPixelFormat::F16 ? alphaChannel->halfData().data() : nullptr;
+
+                tasks.emplace_back(
+                    ThreadPool::global().parallelForAsync<size_t>(0, numRows, [rd, gd, bd, alphaFloat, alphaHalf, width, this](size_t y) {
+                        size_t o = y * width;
+                        if (alphaFloat) {
+                            applyColorMatrixToRow<EAlphaKind::Float>(toRec709, rd + o, gd + o, bd + o, alphaFloat + o, nullptr, width);
+                        } else if (alphaHalf) {
+                            applyColorMatrixToRow<EAlphaKind::Half>(toRec709, rd + o, gd + o, bd + o, nullptr, alphaHalf + o, width);
+                        } else {
+                            applyColorMatrixToRow<EAlphaKind::None>(toRec709, rd + o, gd + o, bd + o, nullptr, nullptr, width);
+                        }
+                    }, priority)
+                );
+            } else {
+                tasks.emplace_back(
+                    ThreadPool::global().parallelForAsync<size_t>(0, r->numPixels(), [r, g, b, alphaChannel, this](size_t i) {
+                        Vector3f rgb = toRec709 * Vector3f{r->at(i), g->at(i), b->at(i)};
+                        if (alphaChannel) {
+                            rgb = rgb * alphaChannel->at(i);
+                        }
+                        r->at(i) = rgb.x();
+                        g->at(i) = rgb.y();
+                        b->at(i) = rgb.z();
+                    }, priority)
+                );
+            }
+        }
+
+        // Whatever other channels the layer has still need the alpha
+        // premultiplication on its own.
+        if (alphaChannel) {
+            for (const auto& channelName : channelsInLayer(layer)) {
+                Channel* chan = mutableChannel(channelName);
+                if (channelName == alphaChannelName || chan == r || chan == g || chan == b) {
+                    continue;
+                }
+
+                tasks.emplace_back(chan->multiplyWithAsync(*alphaChannel, priority));
+            }
+        }
+    }
+
+    co_await whenAll(tasks);
+
+    // Since the image data is now in premultiplied Rec709 space, both
+    // operations become the identity from here on.
+    toRec709 = Matrix4f{1.0f};
+    hasPremultipliedAlpha = true;
+}
+
 void ImageData::alphaOperation(const function<void(Channel&, const Channel&)>& func) {
     for (const auto& layer : layers) {
         string alphaChannelName = layer + "A";
@@ -104,9 +267,7 @@ Task<void> ImageData::multiplyAlpha(int priority) {
     alphaOperation([&] (Channel& target, const Channel& alpha) {
         tasks.emplace_back(target.multiplyWithAsync(alpha, priority));
     });
-    for (auto& task : tasks) {
-        co_await task;
-    }
+    co_await whenAll(tasks);
 
     hasPremultipliedAlpha = true;
 }
@@ -120,9 +281,7 @@ Task<void> ImageData::unmultiplyAlpha(int priority) {
     alphaOperation([&] (Channel& target, const Channel& alpha) {
         tasks.emplace_back(target.divideByAsync(alpha, priority));
     });
-    for (auto& task : tasks) {
-        co_await task;
-    }
+    co_await whenAll(tasks);
 
     hasPremultipliedAlpha = false;
 }
@@ -151,10 +310,12 @@ Task<void> ImageData::ensureValid(const string& channelSelector, int taskPriorit
     }
 
     if (!channelSelector.empty()) {
+        FuzzyMatcher matcher{channelSelector};
+
         vector<pair<size_t, size_t>> matches;
         for (size_t i = 0; i < channels.size(); ++i) {
             size_t matchId;
-            if (matchesFuzzy(channels[i].name(), channelSelector, &matchId)) {
+            if (matcher.matches(channels[i].name(), &matchId)) {
                 matches.emplace_back(matchId, i);
             }
         }
@@ -174,6 +335,9 @@ Task<void> ImageData::ensureValid(const string& channelSelector, int taskPriorit
         }
     }
 
+    // The channel set does not change past this point; index it for O(1) lookup.
+    rebuildChannelIndex();
+
     if (layers.empty()) {
         set<string> layerNames;
         for (auto& c : channels) {
@@ -185,11 +349,10 @@ Task<void> ImageData::ensureValid(const string& channelSelector, int taskPriorit
         }
     }
 
-    if (!hasPremultipliedAlpha) {
-        co_await multiplyAlpha(taskPriority);
-    }
-
-    co_await convertToRec709(taskPriority);
+    // Alpha premultiplication and the color-space conversion each touch
+    // every pixel of every channel, so they run as one fused sweep rather
+    // than as back-to-back full-image passes.
+    co_await convertToRec709AndPremultiply(taskPriority);
 
     TEV_ASSERT(hasPremultipliedAlpha, "tev assumes an internal pre-multiplied-alpha representation.");
     TEV_ASSERT(toRec709 == Matrix4f{1.0f}, "tev assumes an images to be internally represented in sRGB/Rec709 space.");
@@ -205,13 +368,15 @@ Image::Image(const fs::path& path, fs::file_time_type fileLastModified, ImageDat
         auto groups = getGroupedChannels(l);
         mChannelGroups.insert(end(mChannelGroups), begin(groups), end(groups));
     }
+
+    rebuildChannelGroupIndex();
 }
 
 Image::~Image() {
     // Move the texture pointers to the main thread such that their reference count
     // hits zero there. This is required, because OpenGL calls must always happen
     // on the main thread.
-    scheduleToMainThread([textures = std::move(mTextures)] {});
+    scheduleToMainThread([textures = std::move(mTextures), tiles = std::move(mTileTextures)] {});
 
     if (mStaleIdCallback) {
         mStaleIdCallback(mId);
@@ -239,21 +404,64 @@ Texture* Image::texture(const string& channelGroupName) {
 }
 
 Texture* Image::texture(const vector<string>& channelNames) {
+    // An evicted image has no pixel data to interleave; the caller draws a
+    // placeholder until the transparent reload lands.
+    if (mIsEvicted) {
+        return nullptr;
+    }
+
     string lookup = join(channelNames, ",");
     auto iter = mTextures.find(lookup);
     if (iter != end(mTextures)) {
         auto& texture = iter->second;
+        if (texture.staging) {
+            // Still interleaving on the thread pool; the caller draws a
+            // placeholder in the meantime.
+            return nullptr;
+        }
+
+        if (texture.dirtyRegion.isValid()) {
+            flushTextureUpdates(texture);
+        }
+
         if (texture.mipmapDirty) {
-            texture.nanoguiTexture->generate_mipmap();
-            texture.mipmapDirty = false;
+            // Regenerating the full mip chain on every frame dominates GPU
+            // time when a renderer streams tiles into a large canvas viewed
+            // zoomed out. nanogui only exposes whole-chain regeneration, so
+            // the next best thing is rate limiting it: the full-resolution
+            // level is always current, and minified views trail the newest
+            // tiles by at most 150 ms while updates are streaming.
+            auto now = chrono::steady_clock::now();
+            if (now - texture.lastMipmapGeneration >= 150ms) {
+                texture.nanoguiTexture->generate_mipmap();
+                texture.mipmapDirty = false;
+                texture.lastMipmapGeneration = now;
+            } else {
+                // Ensure a later frame picks up the deferred regeneration
+                // even if no further updates arrive.
+                redrawWindow();
+            }
         }
         return texture.nanoguiTexture.get();
     }
 
+    // Match the texture precision to the channels that back it: uploading
+    // half-float data as float32 doubles VRAM use and upload bandwidth without
+    // gaining any displayed precision.
+    bool anyChannelExists = false;
+    bool allChannelsHalf = true;
+    for (size_t i = 0; i < channelNames.size() && i < 4; ++i) {
+        if (const auto* chan = channel(channelNames[i])) {
+            anyChannelExists = true;
+            allChannelsHalf &= chan->format() == EPixelFormat::F16;
+        }
+    }
+    bool useHalf = anyChannelExists && allChannelsHalf;
+
     mTextures.emplace(lookup, ImageTexture{
         new Texture{
             Texture::PixelFormat::RGBA,
-            Texture::ComponentFormat::Float32,
+            useHalf ? Texture::ComponentFormat::Float16 : Texture::ComponentFormat::Float32,
             {size().x(), size().y()},
             Texture::InterpolationMode::Trilinear,
             Texture::InterpolationMode::Nearest,
@@ -263,54 +471,247 @@ Texture* Image::texture(const vector<string>& channelNames) {
         },
         channelNames,
         false,
+        true,
     });
-    auto& texture = mTextures.at(lookup).nanoguiTexture;
 
-    auto numPixels = this->numPixels();
-    vector<float> data(numPixels * 4);
+    // Interleaving an 8K frame takes long enough to visibly freeze the UI, so
+    // it runs on the thread pool; only the upload itself touches the graphics
+    // API and is scheduled back to the main thread once the buffer is ready.
+    invokeTaskDetached([image = shared_from_this(), channelNames, lookup, useHalf]() -> Task<void> {
+        auto numPixels = image->numPixels();
+        vector<Task<void>> tasks;
+
+        if (useHalf) {
+            // All channels store raw half bits, so interleaving is a plain copy.
+            vector<uint16_t> data(numPixels * 4);
+            for (size_t i = 0; i < 4; ++i) {
+                uint16_t defaultVal = floatToHalf(i == 3 ? 1.0f : 0.0f);
+                const Channel* chan = i < channelNames.size() ? image->channel(channelNames[i]) : nullptr;
+                if (chan && !chan->materialized()) {
+                    // Unmaterialized channels have no buffer and read as zero.
+                    defaultVal = floatToHalf(0.0f);
+                    chan = nullptr;
+                }
 
-    vector<Task<void>> tasks;
-    for (size_t i = 0; i < 4; ++i) {
-        float defaultVal = i == 3 ? 1 : 0;
-        if (i < channelNames.size()) {
-            const auto* chan = channel(channelNames[i]);
-            if (!chan) {
-                tasks.emplace_back(
-                    ThreadPool::global().parallelForAsync<size_t>(0, numPixels, [&data, defaultVal, i](size_t j) {
-                        data[j * 4 + i] = defaultVal;
-                    }, std::numeric_limits<int>::max())
-                );
-            } else {
-                const auto& channelData = chan->data();
-                tasks.emplace_back(
-                    ThreadPool::global().parallelForAsync<size_t>(0, numPixels, [&channelData, &data, i](size_t j) {
-                        data[j * 4 + i] = channelData[j];
-                    }, std::numeric_limits<int>::max())
-                );
+                if (chan) {
+                    const auto& halfData = chan->halfData();
+                    tasks.emplace_back(
+                        ThreadPool::global().parallelForAsync<size_t>(0, numPixels, [&halfData, &data, i](size_t j) {
+                            data[j * 4 + i] = halfData[j];
+                        }, std::numeric_limits<int>::max())
+                    );
+                } else {
+                    tasks.emplace_back(
+                        ThreadPool::global().parallelForAsync<size_t>(0, numPixels, [&data, defaultVal, i](size_t j) {
+                            data[j * 4 + i] = defaultVal;
+                        }, std::numeric_limits<int>::max())
+                    );
+                }
             }
+
+            co_await whenAll(tasks);
+
+            scheduleToMainThread([image, lookup, data = std::move(data)] {
+                image->finishStagedUpload(lookup, (const uint8_t*)data.data());
+            });
         } else {
-            tasks.emplace_back(
-                ThreadPool::global().parallelForAsync<size_t>(0, numPixels, [&data, defaultVal, i](size_t j) {
-                    data[j * 4 + i] = defaultVal;
-                }, std::numeric_limits<int>::max())
-            );
+            vector<float> data(numPixels * 4);
+            for (size_t i = 0; i < 4; ++i) {
+                float defaultVal = i == 3 ? 1 : 0;
+                const Channel* chan = i < channelNames.size() ? image->channel(channelNames[i]) : nullptr;
+                if (chan && !chan->materialized()) {
+                    defaultVal = 0;
+                    chan = nullptr;
+                }
+
+                if (chan) {
+                    tasks.emplace_back(
+                        ThreadPool::global().parallelForAsync<size_t>(0, numPixels, [chan, &data, i](size_t j) {
+                            data[j * 4 + i] = chan->at(j);
+                        }, std::numeric_limits<int>::max())
+                    );
+                } else {
+                    tasks.emplace_back(
+                        ThreadPool::global().parallelForAsync<size_t>(0, numPixels, [&data, defaultVal, i](size_t j) {
+                            data[j * 4 + i] = defaultVal;
+                        }, std::numeric_limits<int>::max())
+                    );
+                }
+            }
+
+            co_await whenAll(tasks);
+
+            scheduleToMainThread([image, lookup, data = std::move(data)] {
+                image->finishStagedUpload(lookup, (const uint8_t*)data.data());
+            });
+        }
+    });
+
+    return nullptr;
+}
+
+void Image::finishStagedUpload(const string& lookup, const uint8_t* data) {
+    auto iter = mTextures.find(lookup);
+    if (iter == end(mTextures)) {
+        return;
+    }
+
+    auto& texture = iter->second;
+    {
+        trace::Span span{"image: texture upload"};
+        texture.nanoguiTexture->upload(data);
+        texture.nanoguiTexture->generate_mipmap();
+    }
+    texture.staging = false;
+
+    redrawWindow();
+}
+
+Texture* Image::tileTexture(const vector<string>& channelNames, const Box2i& region, int stride) {
+    string lookup = fmt::format(
+        "{}-{},{}-{},{}-{}",
+        join(channelNames, ","),
+        region.min.x(), region.min.y(),
+        region.max.x(), region.max.y(),
+        stride
+    );
+
+    auto iter = mTileTextures.find(lookup);
+    if (iter != end(mTileTextures)) {
+        iter->second.lastUsed = ++mTileUseCounter;
+        return iter->second.nanoguiTexture.get();
+    }
+
+    Vector2i texSize = {
+        (region.size().x() + stride - 1) / stride,
+        (region.size().y() + stride - 1) / stride,
+    };
+
+    // As in texture(): half-float channels gain nothing from a float32 tile.
+    bool anyChannelExists = false;
+    bool allChannelsHalf = true;
+    for (size_t i = 0; i < channelNames.size() && i < 4; ++i) {
+        if (const auto* chan = channel(channelNames[i])) {
+            anyChannelExists = true;
+            allChannelsHalf &= chan->format() == EPixelFormat::F16;
+        }
+    }
+    bool useHalf = anyChannelExists && allChannelsHalf;
+
+    nanogui::ref<Texture> texture = new Texture{
+        Texture::PixelFormat::RGBA,
+        useHalf ? Texture::ComponentFormat::Float16 : Texture::ComponentFormat::Float32,
+        texSize,
+        Texture::InterpolationMode::Trilinear,
+        Texture::InterpolationMode::Nearest,
+        Texture::WrapMode::ClampToEdge,
+        1, Texture::TextureFlags::ShaderRead,
+        true,
+    };
+
+    const Channel* chans[4] = {};
+    float chanFill[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+    for (size_t i = 0; i < channelNames.size() && i < 4; ++i) {
+        chans[i] = channel(channelNames[i]);
+
+        // Unmaterialized channels have no buffer and read as zero.
+        if (chans[i] && !chans[i]->materialized()) {
+            chanFill[i] = 0.0f;
+            chans[i] = nullptr;
         }
     }
-    waitAll(tasks);
 
-    texture->upload((uint8_t*)data.data());
+    auto numTexels = (size_t)texSize.x() * texSize.y();
+    vector<float> data(numTexels * 4);
+
+    ThreadPool::global().parallelForAsync<int>(0, texSize.y(), [&](int ty) {
+        for (int tx = 0; tx < texSize.x(); ++tx) {
+            size_t texelIdx = ((size_t)ty * texSize.x() + tx) * 4;
+            int x0 = region.min.x() + tx * stride;
+            int y0 = region.min.y() + ty * stride;
+
+            for (size_t i = 0; i < 4; ++i) {
+                const auto* chan = chans[i];
+                if (!chan) {
+                    data[texelIdx + i] = chanFill[i];
+                    continue;
+                }
+
+                if (stride == 1) {
+                    data[texelIdx + i] = chan->at({x0, y0});
+                    continue;
+                }
+
+                // Box-average the pixels this texel covers; point sampling
+                // would shimmer when panning a zoomed-out view.
+                int x1 = std::min(x0 + stride, region.max.x());
+                int y1 = std::min(y0 + stride, region.max.y());
+                float sum = 0;
+                for (int y = y0; y < y1; ++y) {
+                    for (int x = x0; x < x1; ++x) {
+                        sum += chan->at({x, y});
+                    }
+                }
+                data[texelIdx + i] = sum / ((x1 - x0) * (y1 - y0));
+            }
+        }
+    }, std::numeric_limits<int>::max()).get();
+
+    if (useHalf) {
+        vector<uint16_t> halfData(data.size());
+        for (size_t j = 0; j < data.size(); ++j) {
+            halfData[j] = floatToHalf(data[j]);
+        }
+        texture->upload((uint8_t*)halfData.data());
+    } else {
+        texture->upload((uint8_t*)data.data());
+    }
     texture->generate_mipmap();
+
+    size_t sizeInBytes = numTexels * 4 * (useHalf ? sizeof(uint16_t) : sizeof(float));
+    mTileTextures.emplace(lookup, ImageTile{texture, channelNames, sizeInBytes, ++mTileUseCounter});
+
+    // Evict least-recently-used tiles once the cache exceeds its budget. The
+    // budget comfortably exceeds one screenful of tiles, so tiles of the
+    // current frame are never evicted.
+    constexpr size_t maxTileCacheBytes = (size_t)1024 * 1024 * 1024;
+    size_t totalBytes = 0;
+    for (const auto& kv : mTileTextures) {
+        totalBytes += kv.second.sizeInBytes;
+    }
+
+    while (totalBytes > maxTileCacheBytes && mTileTextures.size() > 1) {
+        auto lru = begin(mTileTextures);
+        for (auto it = begin(mTileTextures); it != end(mTileTextures); ++it) {
+            if (it->second.lastUsed < lru->second.lastUsed) {
+                lru = it;
+            }
+        }
+
+        totalBytes -= lru->second.sizeInBytes;
+        mTileTextures.erase(lru);
+    }
+
     return texture.get();
 }
 
-vector<string> Image::channelsInGroup(const string& groupName) const {
-    for (const auto& group : mChannelGroups) {
-        if (group.name == groupName) {
-            return group.channels;
-        }
+const vector<string>& Image::channelsInGroup(const string& groupName) const {
+    auto it = mChannelGroupIndex.find(groupName);
+    if (it != end(mChannelGroupIndex)) {
+        return mChannelGroups[it->second].channels;
     }
 
-    return {};
+    static const vector<string> empty;
+    return empty;
+}
+
+void Image::rebuildChannelGroupIndex() {
+    mChannelGroupIndex.clear();
+    mChannelGroupIndex.reserve(mChannelGroups.size());
+    for (size_t i = 0; i < mChannelGroups.size(); ++i) {
+        // emplace keeps the first occurrence should two groups share a name.
+        mChannelGroupIndex.emplace(mChannelGroups[i].name, i);
+    }
 }
 
 void Image::decomposeChannelGroup(const string& groupName) {
@@ -335,6 +736,8 @@ void Image::decomposeChannelGroup(const string& groupName) {
     // or when single-color channels appear multiple times in their group to render as
     // RGB rather than pure red.) Don't insert those.
     removeDuplicates(mChannelGroups);
+
+    rebuildChannelGroupIndex();
 }
 
 vector<ChannelGroup> Image::getGroupedChannels(const string& layerName) const {
@@ -462,57 +865,234 @@ vector<string> Image::getExistingChannels(const vector<string>& requestedChannel
     return result;
 }
 
-void Image::updateChannel(const string& channelName, int x, int y, int width, int height, const vector<float>& data) {
+void Image::updateChannel(const string& channelName, int x, int y, int width, int height, const float* data, int64_t stride) {
     Channel* chan = mutableChannel(channelName);
     if (!chan) {
         tlog::warning() << "Channel " << channelName << " could not be updated, because it does not exist.";
         return;
     }
 
-    chan->updateTile(x, y, width, height, data);
+    chan->updateTile(x, y, width, height, data, stride);
+    markChannelRegionUpdated(channelName, x, y, width, height);
+}
 
-    // Update textures that are cached for this channel
+void Image::markChannelRegionUpdated(const string& channelName, int x, int y, int width, int height) {
+    // Drop cached tiles containing this channel; they are cheap to re-upload
+    // on demand compared to patching every affected downsampling level.
+    for (auto it = begin(mTileTextures); it != end(mTileTextures);) {
+        const auto& tileChannels = it->second.channels;
+        if (find(begin(tileChannels), end(tileChannels), channelName) != end(tileChannels)) {
+            it = mTileTextures.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    // Only record the dirty region here; interleaving and uploading happen in
+    // one batch when the texture is next drawn. Renderers streaming thousands
+    // of tiles per second otherwise pay one staging allocation and one driver
+    // call per tile. Textures still staging are covered too: their dirty
+    // region is flushed on the first draw after the staged upload lands.
     for (auto& kv : mTextures) {
         auto& imageTexture = kv.second;
         if (find(begin(imageTexture.channels), end(imageTexture.channels), channelName) == end(imageTexture.channels)) {
             continue;
         }
 
-        auto numPixels = (size_t)width * height;
-        vector<float> textureData(numPixels * 4);
+        imageTexture.dirtyRegion.min = min(imageTexture.dirtyRegion.min, Vector2i{x, y});
+        imageTexture.dirtyRegion.max = max(imageTexture.dirtyRegion.max, Vector2i{x + width, y + height});
+    }
+}
 
-        // Populate data for sub-region of the texture to be updated
-        for (size_t i = 0; i < 4; ++i) {
-            if (i < imageTexture.channels.size()) {
-                const auto& localChannelName = imageTexture.channels[i];
-                const auto* localChan = channel(localChannelName);
-                TEV_ASSERT(localChan, "Channel to be updated must exist");
+bool Image::tryApplyDifferentialUpdate(const Image& replacement) {
+    // An evicted image has no pixel data left to diff against.
+    if (mIsEvicted) {
+        return false;
+    }
 
-                for (int posY = 0; posY < height; ++posY) {
-                    for (int posX = 0; posX < width; ++posX) {
-                        int tileIdx = posX + posY * width;
-                        textureData[tileIdx * 4 + i] = localChan->at({x + posX, y + posY});
-                    }
+    auto& oldChannels = mData.channels;
+    const auto& newChannels = replacement.mData.channels;
+
+    if (mData.dataWindow != replacement.mData.dataWindow ||
+        mData.displayWindow != replacement.mData.displayWindow ||
+        oldChannels.size() != newChannels.size()) {
+        return false;
+    }
+
+    for (size_t i = 0; i < oldChannels.size(); ++i) {
+        if (oldChannels[i].name() != newChannels[i].name() || oldChannels[i].format() != newChannels[i].format()) {
+            return false;
+        }
+
+        // Unmaterialized channels (lazily created zero channels) have no
+        // buffer to diff against.
+        if (!oldChannels[i].materialized() || !newChannels[i].materialized()) {
+            return false;
+        }
+    }
+
+    // Tile granularity trades diff precision against bookkeeping; 128px
+    // matches what progressive renderers typically write between file
+    // updates.
+    constexpr int TILE_SIZE = 128;
+    Vector2i size = this->size();
+
+    // Compares one tile of `dst` and `src` and copies it over if it differs.
+    auto diffAndCopyTile = [&](auto* dst, const auto* src, int tileX, int tileY, int tileWidth, int tileHeight) {
+        bool changed = false;
+        for (int posY = 0; posY < tileHeight; ++posY) {
+            size_t offset = (size_t)(tileY + posY) * size.x() + tileX;
+            if (memcmp(dst + offset, src + offset, tileWidth * sizeof(*dst)) != 0) {
+                changed = true;
+                break;
+            }
+        }
+
+        if (changed) {
+            for (int posY = 0; posY < tileHeight; ++posY) {
+                size_t offset = (size_t)(tileY + posY) * size.x() + tileX;
+                memcpy(dst + offset, src + offset, tileWidth * sizeof(*dst));
+            }
+        }
+
+        return changed;
+    };
+
+    for (size_t i = 0; i < oldChannels.size(); ++i) {
+        auto& oldChan = oldChannels[i];
+        const auto& newChan = newChannels[i];
+
+        Box2i changedRegion;
+        for (int tileY = 0; tileY < size.y(); tileY += TILE_SIZE) {
+            int tileHeight = std::min(TILE_SIZE, size.y() - tileY);
+            for (int tileX = 0; tileX < size.x(); tileX += TILE_SIZE) {
+                int tileWidth = std::min(TILE_SIZE, size.x() - tileX);
+
+                bool changed = oldChan.format() == EPixelFormat::F16 ?
+                    diffAndCopyTile(oldChan.halfData().data(), newChan.halfData().data(), tileX, tileY, tileWidth, tileHeight) :
+                    diffAndCopyTile(oldChan.data().data(), newChan.data().data(), tileX, tileY, tileWidth, tileHeight);
+
+                if (changed) {
+                    changedRegion.min = min(changedRegion.min, Vector2i{tileX, tileY});
+                    changedRegion.max = max(changedRegion.max, Vector2i{tileX + tileWidth, tileY + tileHeight});
                 }
-            } else {
-                float val = i == 3 ? 1 : 0;
-                for (size_t j = 0; j < numPixels; ++j) {
-                    textureData[j * 4 + i] = val;
+            }
+        }
+
+        if (changedRegion.isValid()) {
+            markChannelRegionUpdated(
+                oldChan.name(), changedRegion.min.x(), changedRegion.min.y(),
+                changedRegion.size().x(), changedRegion.size().y()
+            );
+        }
+    }
+
+    return true;
+}
+
+size_t Image::memoryUsage() const {
+    size_t result = 0;
+    for (const auto& channel : mData.channels) {
+        result += channel.memoryUsage();
+    }
+
+    for (const auto& kv : mTextures) {
+        const auto& texture = kv.second.nanoguiTexture;
+        result += (size_t)texture->size().x() * texture->size().y() * texture->bytes_per_pixel();
+    }
+
+    for (const auto& kv : mTileTextures) {
+        result += kv.second.sizeInBytes;
+    }
+
+    result += mUpdateStagingBuffer.capacity() * sizeof(float);
+    result += mUpdateStagingBufferHalf.capacity() * sizeof(uint16_t);
+
+    return result;
+}
+
+void Image::evict() {
+    TEV_ASSERT(!hasStagingTextures(), "Must not evict an image that is still staging texture data.");
+
+    for (auto& channel : mData.channels) {
+        channel.dropPixelData();
+    }
+
+    mTextures.clear();
+    mTileTextures.clear();
+    mUpdateStagingBuffer = {};
+    mUpdateStagingBufferHalf = {};
+
+    mIsEvicted = true;
+    mEvictionReloadScheduled = false;
+}
+
+void Image::flushTextureUpdates(ImageTexture& imageTexture) {
+    trace::Span span{"image: texture update"};
+
+    Box2i region = imageTexture.dirtyRegion;
+    imageTexture.dirtyRegion = {};
+
+    region.min = max(region.min, Vector2i{0});
+    region.max = min(region.max, size());
+    if (!region.isValid()) {
+        return;
+    }
+
+    int width = region.size().x();
+    int height = region.size().y();
+    auto numPixels = (size_t)width * height;
+    mUpdateStagingBuffer.resize(numPixels * 4);
+
+    // Populate data for sub-region of the texture to be updated
+    for (size_t i = 0; i < 4; ++i) {
+        if (i < imageTexture.channels.size()) {
+            const auto& localChannelName = imageTexture.channels[i];
+            const auto* localChan = channel(localChannelName);
+            TEV_ASSERT(localChan, "Channel to be updated must exist");
+
+            for (int posY = 0; posY < height; ++posY) {
+                for (int posX = 0; posX < width; ++posX) {
+                    int tileIdx = posX + posY * width;
+                    mUpdateStagingBuffer[tileIdx * 4 + i] = localChan->at({region.min.x() + posX, region.min.y() + posY});
                 }
             }
+        } else {
+            float val = i == 3 ? 1 : 0;
+            for (size_t j = 0; j < numPixels; ++j) {
+                mUpdateStagingBuffer[j * 4 + i] = val;
+            }
         }
+    }
 
-        imageTexture.nanoguiTexture->upload_sub_region((uint8_t*)textureData.data(), {x, y}, {width, height});
-        imageTexture.mipmapDirty = true;
+    // The uploaded bits must match the texture's component format. Tile
+    // updates promote their channel to float storage, but textures created
+    // from half-float channels remain half-float for their lifetime.
+    if (imageTexture.nanoguiTexture->component_format() == Texture::ComponentFormat::Float16) {
+        mUpdateStagingBufferHalf.resize(numPixels * 4);
+        for (size_t j = 0; j < numPixels * 4; ++j) {
+            mUpdateStagingBufferHalf[j] = floatToHalf(mUpdateStagingBuffer[j]);
+        }
+
+        imageTexture.nanoguiTexture->upload_sub_region((uint8_t*)mUpdateStagingBufferHalf.data(), {region.min.x(), region.min.y()}, {width, height});
+    } else {
+        imageTexture.nanoguiTexture->upload_sub_region((uint8_t*)mUpdateStagingBuffer.data(), {region.min.x(), region.min.y()}, {width, height});
     }
+    imageTexture.mipmapDirty = true;
 }
 
 void Image::updateVectorGraphics(bool append, const vector<VgCommand>& commands) {
     if (!append) {
         mVgCommands.clear();
+        mVgBatch.clear();
     }
 
     std::copy(std::begin(commands), std::end(commands), std::back_inserter(mVgCommands));
+
+    // Only the new commands are tessellated, so a stream of appends — the
+    // common shape of bulk annotation updates over IPC — stays linear in the
+    // total command count rather than quadratic.
+    mVgBatch.append(commands);
 }
 
 template <typename T>
@@ -575,6 +1155,7 @@ Task<vector<shared_ptr<Image>>> tryLoadImage(int taskPriority, fs::path path, is
     }
 
     try {
+        trace::Span loadSpan{"image: load"};
         auto start = chrono::system_clock::now();
 
         if (!iStream) {
@@ -607,10 +1188,13 @@ Task<vector<shared_ptr<Image>>> tryLoadImage(int taskPriority, fs::path path, is
 
             // Earlier images should be prioritized when loading.
             loadMethod = imageLoader->name();
+            auto decodeBegin = chrono::steady_clock::now();
             auto imageData = co_await imageLoader->load(iStream, path, channelSelector, taskPriority);
+            trace::record("image: decode", decodeBegin, chrono::steady_clock::now());
 
             vector<shared_ptr<Image>> images;
             for (auto& i : imageData) {
+                trace::Span postprocessSpan{"image: postprocess"};
                 co_await i.ensureValid(channelSelector, taskPriority);
 
                 // If multiple image "parts" were loaded and they have names,
@@ -677,6 +1261,7 @@ void BackgroundImagesLoader::enqueue(const fs::path& path, const string& channel
 
         fs::path canonicalPath = fs::canonical(path);
         mDirectories[canonicalPath].emplace(channelSelector);
+        watchDirectory(canonicalPath);
 
         bool first = true;
         forEachFileInDir(mRecursiveDirectories, canonicalPath, [&](auto const& entry) {
@@ -693,7 +1278,10 @@ void BackgroundImagesLoader::enqueue(const fs::path& path, const string& channel
     invokeTaskDetached([loadId, path, channelSelector, shallSelect, toReplace, this]() -> Task<void> {
         int taskPriority = -Image::drawId();
 
-        co_await ThreadPool::global().enqueueCoroutine(taskPriority);
+        // File reads are blocking and belong on the I/O pool. Compute-heavy
+        // subtasks (pixel conversion etc.) hop back onto the compute pool
+        // through their own parallelForAsync calls.
+        co_await ThreadPool::globalIo().enqueueCoroutine(taskPriority);
         auto images = co_await tryLoadImage(taskPriority, path, channelSelector);
 
         if (images.empty()) {
@@ -702,7 +1290,7 @@ void BackgroundImagesLoader::enqueue(const fs::path& path, const string& channel
 
         {
             std::lock_guard lock{mPendingLoadedImagesMutex};
-            mPendingLoadedImages.push({ loadId, shallSelect, images, toReplace });
+            mPendingLoadedImages.emplace(loadId, ImageAddition{ loadId, shallSelect, std::move(images), toReplace });
         }
 
         if (publishSortedLoads()) {
@@ -711,34 +1299,94 @@ void BackgroundImagesLoader::enqueue(const fs::path& path, const string& channel
     });
 }
 
+// Whether `path` lexically equals `base` or lies somewhere below it.
+static bool containsPath(const fs::path& base, const fs::path& path) {
+    auto pathIt = path.begin();
+    for (auto baseIt = base.begin(); baseIt != base.end(); ++baseIt, ++pathIt) {
+        if (pathIt == path.end() || *baseIt != *pathIt) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void BackgroundImagesLoader::watchDirectory(const fs::path& dir) {
+    if (!mFileWatcher && !mFileWatcherFailed) {
+        mFileWatcher = FileWatcher::create([this](const fs::path& changedDir) {
+            {
+                lock_guard lock{mDirtyDirectoriesMutex};
+                mDirtyDirectories.insert(changedDir);
+            }
+
+            // Wake the UI thread so the change is picked up promptly.
+            redrawWindow();
+        });
+
+        if (!mFileWatcher) {
+            mFileWatcherFailed = true;
+            tlog::warning() << "Native filesystem watching is unavailable; falling back to polling.";
+        }
+    }
+
+    if (mFileWatcher) {
+        mFileWatcher->watch(dir, mRecursiveDirectories);
+    }
+}
+
+void BackgroundImagesLoader::scanDirectoryForNewFiles(const fs::path& dir, const set<string>& channelSelectors) {
+    forEachFileInDir(mRecursiveDirectories, dir, [&](auto const& entry) {
+        if (!entry.is_directory()) {
+            for (const auto& channelSelector : channelSelectors) {
+                PathAndChannelSelector p = {entry, channelSelector};
+                if (!mFilesFoundInDirectories.contains(p)) {
+                    mFilesFoundInDirectories.emplace(p);
+                    enqueue(entry, channelSelector, false);
+                }
+            }
+        }
+    });
+}
+
 void BackgroundImagesLoader::checkDirectoriesForNewFilesAndLoadThose() {
-    for (const auto& dir : mDirectories) {
-        forEachFileInDir(mRecursiveDirectories, dir.first, [&](auto const& entry) {
-            if (!entry.is_directory()) {
-                for (const auto& channelSelector : dir.second) {
-                    PathAndChannelSelector p = {entry, channelSelector};
-                    if (!mFilesFoundInDirectories.contains(p)) {
-                        mFilesFoundInDirectories.emplace(p);
-                        enqueue(entry, channelSelector, false);
-                    }
+    // With a native watcher only the directories in which it saw events need
+    // rescanning; without one, every watched directory gets re-enumerated.
+    if (mFileWatcher) {
+        set<fs::path> dirtyDirectories;
+        {
+            lock_guard lock{mDirtyDirectoriesMutex};
+            dirtyDirectories.swap(mDirtyDirectories);
+        }
+
+        for (const auto& dirtyDir : dirtyDirectories) {
+            for (const auto& dir : mDirectories) {
+                if (dirtyDir == dir.first || (mRecursiveDirectories && containsPath(dir.first, dirtyDir))) {
+                    scanDirectoryForNewFiles(dirtyDir, dir.second);
                 }
             }
-        });
+        }
+
+        return;
+    }
+
+    for (const auto& dir : mDirectories) {
+        scanDirectoryForNewFiles(dir.first, dir.second);
     }
 }
 
 bool BackgroundImagesLoader::publishSortedLoads() {
     std::lock_guard lock{mPendingLoadedImagesMutex};
     bool pushed = false;
-    while (!mPendingLoadedImages.empty() && mPendingLoadedImages.top().loadId == mLoadCounter) {
+    auto it = mPendingLoadedImages.begin();
+    while (it != mPendingLoadedImages.end() && it->first == mLoadCounter) {
         ++mLoadCounter;
 
         // null image pointers indicate failed loads. These shouldn't be pushed.
-        if (!mPendingLoadedImages.top().images.empty()) {
-            mLoadedImages.push(std::move(mPendingLoadedImages.top()));
+        if (!it->second.images.empty()) {
+            mLoadedImages.push(std::move(it->second));
         }
 
-        mPendingLoadedImages.pop();
+        it = mPendingLoadedImages.erase(it);
         pushed = true;
     }
     return pushed;
@@ -0,0 +1,240 @@
+// This file was developed by Thomas Müller <thomas94@gmx.net>.
+// It is published under the BSD 3-Clause License within the LICENSE file.
+
+// Benchmark suite for tev's image loaders. Points at a corpus directory and
+// runs every file through the same loader-selection and post-processing path
+// as the viewer, reporting per-stage timings:
+//
+//     tev-bench /path/to/corpus --threads 1,4,16 --runs 3 --csv results.csv
+//
+// Stages are: reading the file from disk, decoding via the matching
+// ImageLoader (which includes the loader's internal conversion work, e.g.
+// RawChannel::copyTo in the EXR loader), and ensureValid post-processing
+// (color-space conversion and alpha premultiplication). The first run of each
+// file is labeled "cold" — genuinely cold only if the OS page cache has not
+// seen the corpus before — and subsequent runs "warm". The optional CSV
+// output is meant for machine consumption and regression tracking.
+
+#include <tev/Image.h>
+#include <tev/ThreadPool.h>
+#include <tev/imageio/ImageLoader.h>
+
+#include <args.hxx>
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <thread>
+
+using namespace args;
+using namespace std;
+
+namespace tev {
+
+namespace {
+
+struct StageTimings {
+    string loaderName;
+    double readMs = 0;
+    double decodeMs = 0;
+    double postprocessMs = 0;
+
+    double totalMs() const {
+        return readMs + decodeMs + postprocessMs;
+    }
+};
+
+double msSince(const chrono::steady_clock::time_point& begin) {
+    return chrono::duration<double, milli>{chrono::steady_clock::now() - begin}.count();
+}
+
+// Mirrors the stages of tryLoadImage: read the file, pick a loader, decode,
+// then post-process each resulting part.
+StageTimings benchFile(const fs::path& path) {
+    StageTimings timings;
+
+    auto readBegin = chrono::steady_clock::now();
+    ifstream fileStream{path, ios_base::binary};
+    if (!fileStream) {
+        throw invalid_argument{fmt::format("Image {} could not be opened.", path)};
+    }
+
+    stringstream iStream;
+    iStream << fileStream.rdbuf();
+    timings.readMs = msSince(readBegin);
+
+    for (const auto& imageLoader : ImageLoader::getLoaders()) {
+        // If we arrived at the last loader, then we want to at least try loading the image,
+        // even if it is likely to fail.
+        bool useLoader = imageLoader == ImageLoader::getLoaders().back() || imageLoader->canLoadFile(iStream);
+
+        // Reset file cursor in case file load check changed it.
+        iStream.clear();
+        iStream.seekg(0);
+
+        if (!useLoader) {
+            continue;
+        }
+
+        timings.loaderName = imageLoader->name();
+
+        auto decodeBegin = chrono::steady_clock::now();
+        auto imageData = imageLoader->load(iStream, path, "", numeric_limits<int>::max()).get();
+        timings.decodeMs = msSince(decodeBegin);
+
+        auto postprocessBegin = chrono::steady_clock::now();
+        for (auto& i : imageData) {
+            i.ensureValid("", numeric_limits<int>::max()).get();
+        }
+        timings.postprocessMs = msSince(postprocessBegin);
+
+        return timings;
+    }
+
+    throw runtime_error{"No suitable image loader found."};
+}
+
+void setGlobalThreadCount(size_t numThreads) {
+    auto& pool = ThreadPool::global();
+    if (numThreads > pool.numThreads()) {
+        pool.startThreads(numThreads - pool.numThreads());
+    } else if (numThreads < pool.numThreads()) {
+        pool.shutdownThreads(pool.numThreads() - numThreads);
+    }
+}
+
+vector<size_t> parseThreadCounts(const string& str) {
+    vector<size_t> result;
+    for (const auto& part : split(str, ",")) {
+        if (!part.empty()) {
+            result.push_back((size_t)stoul(part));
+        }
+    }
+
+    if (result.empty()) {
+        throw invalid_argument{"At least one thread count must be specified."};
+    }
+
+    return result;
+}
+
+} // namespace
+
+int mainFunc(int argc, char* argv[]) {
+    ArgumentParser parser{
+        "Benchmark suite for tev's image loaders.",
+        "Runs every file in a corpus directory through the image loading pipeline and reports per-stage timings.",
+    };
+
+    Positional<string> corpusArg{parser, "CORPUS", "Directory containing the image corpus."};
+    ValueFlag<string> threadsFlag{parser, "THREADS", "Comma-separated list of thread counts to sweep. Default is the hardware concurrency.", {"threads"}};
+    ValueFlag<int> runsFlag{parser, "RUNS", "Number of runs per file and thread count. Default is 3.", {"runs"}};
+    ValueFlag<string> csvFlag{parser, "CSV", "Path of a CSV file to write machine-readable results to.", {"csv"}};
+    HelpFlag helpFlag{parser, "HELP", "Display this help menu.", {'h', "help"}};
+
+    try {
+        parser.ParseCLI(argc, argv);
+    } catch (const Help&) {
+        std::cout << parser;
+        return 0;
+    } catch (const ParseError& e) {
+        std::cerr << e.what() << std::endl << parser;
+        return 1;
+    }
+
+    if (!corpusArg) {
+        std::cerr << "A corpus directory must be specified." << std::endl << parser;
+        return 1;
+    }
+
+    fs::path corpus = get(corpusArg);
+    if (!fs::exists(corpus) || !fs::is_directory(corpus)) {
+        tlog::error() << corpus << " is not a directory.";
+        return 1;
+    }
+
+    vector<size_t> threadCounts =
+        threadsFlag ? parseThreadCounts(get(threadsFlag)) : vector<size_t>{(size_t)thread::hardware_concurrency()};
+    int numRuns = runsFlag ? get(runsFlag) : 3;
+
+    vector<fs::path> files;
+    for (const auto& entry : fs::recursive_directory_iterator{corpus}) {
+        if (entry.is_regular_file()) {
+            files.push_back(entry.path());
+        }
+    }
+
+    sort(files.begin(), files.end());
+    if (files.empty()) {
+        tlog::error() << "No files found in " << corpus;
+        return 1;
+    }
+
+    ofstream csv;
+    if (csvFlag) {
+        csv.open(get(csvFlag));
+        if (!csv) {
+            tlog::error() << "Could not open " << get(csvFlag) << " for writing.";
+            return 1;
+        }
+
+        csv << "file,loader,threads,run,cache,read_ms,decode_ms,postprocess_ms,total_ms\n";
+    }
+
+    for (const auto& file : files) {
+        bool fileTouched = false;
+        for (size_t numThreads : threadCounts) {
+            setGlobalThreadCount(numThreads);
+
+            vector<StageTimings> runs;
+            for (int run = 0; run < numRuns; ++run) {
+                try {
+                    runs.push_back(benchFile(file));
+                } catch (const runtime_error& e) {
+                    tlog::warning() << fmt::format("Skipping {}: {}", toString(file), e.what());
+                    break;
+                }
+
+                const auto& t = runs.back();
+                if (csv) {
+                    csv << fmt::format(
+                        "{},{},{},{},{},{:.3f},{:.3f},{:.3f},{:.3f}\n",
+                        toString(file), t.loaderName, numThreads, run, fileTouched ? "warm" : "cold",
+                        t.readMs, t.decodeMs, t.postprocessMs, t.totalMs()
+                    );
+                }
+
+                fileTouched = true;
+            }
+
+            if (runs.empty()) {
+                break;
+            }
+
+            // The median over all runs at this thread count is the headline number.
+            sort(runs.begin(), runs.end(), [](const StageTimings& a, const StageTimings& b) { return a.totalMs() < b.totalMs(); });
+            const auto& median = runs[runs.size() / 2];
+
+            tlog::info() << fmt::format(
+                "{:32} via {:5} @ {:2} threads: read {:7.2f} ms, decode {:7.2f} ms, postprocess {:7.2f} ms, total {:7.2f} ms (median of {})",
+                toString(file.filename()), median.loaderName, numThreads,
+                median.readMs, median.decodeMs, median.postprocessMs, median.totalMs(), runs.size()
+            );
+        }
+    }
+
+    return 0;
+}
+
+} // namespace tev
+
+int main(int argc, char* argv[]) {
+    try {
+        return tev::mainFunc(argc, argv);
+    } catch (const std::runtime_error& e) {
+        tlog::error() << e.what();
+        return 1;
+    }
+}
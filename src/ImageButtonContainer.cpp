@@ -0,0 +1,90 @@
+// This file was developed by Thomas Müller <thomas94@gmx.net>.
+// It is published under the BSD 3-Clause License within the LICENSE file.
+
+#include <tev/ImageButtonContainer.h>
+
+#include <nanogui/opengl.h>
+#include <nanogui/screen.h>
+
+using namespace nanogui;
+using namespace std;
+
+namespace tev {
+
+ImageButtonContainer::ImageButtonContainer(Widget* parent)
+: Widget{parent} {}
+
+Vector2i ImageButtonContainer::preferred_size(NVGcontext* ctx) const {
+    // All buttons share the same height, so measuring a single one suffices.
+    Vector2i buttonSize{0, 0};
+    int numVisible = 0;
+    for (auto child : m_children) {
+        if (!child->visible()) {
+            continue;
+        }
+
+        if (numVisible == 0) {
+            buttonSize = child->preferred_size(ctx);
+        }
+
+        ++numVisible;
+    }
+
+    return {buttonSize.x(), buttonSize.y() * numVisible};
+}
+
+void ImageButtonContainer::perform_layout(NVGcontext* ctx) {
+    int buttonHeight = 0;
+    int y = 0;
+    for (auto child : m_children) {
+        if (!child->visible()) {
+            continue;
+        }
+
+        if (buttonHeight == 0) {
+            buttonHeight = child->preferred_size(ctx).y();
+        }
+
+        child->set_position({0, y});
+        child->set_size({m_size.x(), buttonHeight});
+        child->perform_layout(ctx);
+
+        y += buttonHeight;
+    }
+}
+
+void ImageButtonContainer::draw(NVGcontext* ctx) {
+    if (m_children.empty()) {
+        return;
+    }
+
+    // The current transform already contains the enclosing scroll panel's
+    // offset, so its translation maps this widget's coordinates to the screen.
+    float xform[6];
+    nvgCurrentTransform(ctx, xform);
+    float offset = xform[5] + m_pos.y();
+    float screenHeight = (float)screen()->size().y();
+
+    nvgSave(ctx);
+    nvgTranslate(ctx, m_pos.x(), m_pos.y());
+    for (auto child : m_children) {
+        if (!child->visible()) {
+            continue;
+        }
+
+        // Visible children are laid out top to bottom, so everything after the
+        // first child below the screen is off-screen as well.
+        if (offset + child->position().y() > screenHeight) {
+            break;
+        }
+
+        if (offset + child->position().y() + child->size().y() < 0) {
+            continue;
+        }
+
+        child->draw(ctx);
+    }
+    nvgRestore(ctx);
+}
+
+}
@@ -4,6 +4,7 @@
 #include <tev/FalseColor.h>
 #include <tev/ImageCanvas.h>
 #include <tev/ThreadPool.h>
+#include <tev/Trace.h>
 
 #include <tev/imageio/ImageSaver.h>
 
@@ -21,9 +22,153 @@ using namespace std;
 
 namespace tev {
 
+namespace {
+
+// Batch kernels for metric evaluation and tonemapping. Template specialization
+// hoists the switch out of the per-pixel loop and leaves a branch-free body
+// that the compiler auto-vectorizes for the target instruction set
+// (SSE/AVX/NEON), so these paths run at memory bandwidth rather than at
+// scalar-switch speed.
+
+template <EMetric M>
+float metricKernel(float image, float reference) {
+    float diff = image - reference;
+    if constexpr (M == EMetric::Error)                 { return diff; }
+    if constexpr (M == EMetric::AbsoluteError)         { return abs(diff); }
+    if constexpr (M == EMetric::SquaredError)          { return diff * diff; }
+    if constexpr (M == EMetric::RelativeAbsoluteError) { return abs(diff) / (reference + 0.01f); }
+    if constexpr (M == EMetric::RelativeSquaredError)  { return diff * diff / (reference * reference + 0.01f); }
+}
+
+// A null reference stands for a reference value of zero everywhere.
+template <EMetric M>
+void applyMetricToRow(float* out, const float* image, const float* reference, size_t n) {
+    if (reference) {
+        for (size_t x = 0; x < n; ++x) {
+            out[x] = metricKernel<M>(image[x], reference[x]);
+        }
+    } else {
+        for (size_t x = 0; x < n; ++x) {
+            out[x] = metricKernel<M>(image[x], 0.0f);
+        }
+    }
+}
+
+void applyMetricToRow(float* out, const float* image, const float* reference, size_t n, EMetric metric) {
+    switch (metric) {
+        case EMetric::Error:                 applyMetricToRow<EMetric::Error>(out, image, reference, n); break;
+        case EMetric::AbsoluteError:         applyMetricToRow<EMetric::AbsoluteError>(out, image, reference, n); break;
+        case EMetric::SquaredError:          applyMetricToRow<EMetric::SquaredError>(out, image, reference, n); break;
+        case EMetric::RelativeAbsoluteError: applyMetricToRow<EMetric::RelativeAbsoluteError>(out, image, reference, n); break;
+        case EMetric::RelativeSquaredError:  applyMetricToRow<EMetric::RelativeSquaredError>(out, image, reference, n); break;
+        default:
+            throw runtime_error{"Invalid metric selected."};
+    }
+}
+
+template <ETonemap T>
+Vector3f tonemapKernel(const Vector3f& value, float invGamma, EColorMap colorMap) {
+    if constexpr (T == ETonemap::SRGB) {
+        return {toSRGB(value.x()), toSRGB(value.y()), toSRGB(value.z())};
+    }
+
+    if constexpr (T == ETonemap::Gamma) {
+        return {pow(value.x(), invGamma), pow(value.y(), invGamma), pow(value.z(), invGamma)};
+    }
+
+    if constexpr (T == ETonemap::FalseColor) {
+        const auto& fcd = colormap::data(colorMap);
+        float linear = log2(mean(value) + 0.03125f) / 10 + 0.5f;
+        int start = 4 * clamp((int)(linear * (fcd.size() / 4)), 0, (int)fcd.size() / 4 - 1);
+        return Vector3f{fcd[start], fcd[start + 1], fcd[start + 2]};
+    }
+
+    if constexpr (T == ETonemap::PositiveNegative) {
+        return {-2.0f * mean(min(value, Vector3f{0.0f})), 2.0f * mean(max(value, Vector3f{0.0f})), 0.0f};
+    }
+}
+
+// 8x8 Bayer matrix for ordered dithering during 8-bit quantization.
+constexpr int BAYER8[8][8] = {
+    { 0, 32,  8, 40,  2, 34, 10, 42},
+    {48, 16, 56, 24, 50, 18, 58, 26},
+    {12, 44,  4, 36, 14, 46,  6, 38},
+    {60, 28, 52, 20, 62, 30, 54, 22},
+    { 3, 35, 11, 43,  1, 33,  9, 41},
+    {51, 19, 59, 27, 49, 17, 57, 25},
+    {15, 47,  7, 39, 13, 45,  5, 37},
+    {63, 31, 55, 23, 61, 29, 53, 21},
+};
+
+// Fused export kernel: reads the per-channel data directly, un-premultiplies
+// alpha if requested, applies exposure/offset and the tonemap, and quantizes
+// to 8 bit — one pass with no intermediate RGBA staging. Quantization
+// optionally applies ordered dithering, which hides the banding that plain
+// rounding produces in smooth gradients.
+template <ETonemap T>
+void tonemapChannelsRowToLdr(
+    const vector<Channel>& channels, bool divideAlpha, char* out, int y, int width,
+    float exposureScale, float offset, float invGamma, EColorMap colorMap, bool dither
+) {
+    int nChannels = min((int)channels.size(), 4);
+    const float* chanData[4] = {};
+    for (int c = 0; c < nChannels; ++c) {
+        chanData[c] = channels[c].data().data() + (size_t)y * width;
+    }
+
+    const int* bayerRow = BAYER8[y & 7];
+    for (int x = 0; x < width; ++x) {
+        // Channels the image does not have read as zero, except for alpha,
+        // which reads as one.
+        float v[4] = {0.0f, 0.0f, 0.0f, 1.0f};
+        for (int c = 0; c < nChannels; ++c) {
+            v[c] = chanData[c][x];
+        }
+
+        // Divide alpha out if needed (for storing in non-premultiplied formats)
+        if (divideAlpha) {
+            float alpha = v[3];
+            for (int c = 0; c < min(nChannels, 3); ++c) {
+                v[c] = alpha == 0 ? 0 : v[c] / alpha;
+            }
+        }
+
+        Vector3f value = tonemapKernel<T>({
+            exposureScale * v[0] + offset,
+            exposureScale * v[1] + offset,
+            exposureScale * v[2] + offset,
+        }, invGamma, colorMap);
+        value = min(max(value, Vector3f{0.0f}), Vector3f{1.0f});
+
+        float quantizationOffset = dither ? (bayerRow[x & 7] + 0.5f) / 64.0f : 0.5f;
+        for (int j = 0; j < 3; ++j) {
+            out[4 * x + j] = (char)(value[j] * 255 + quantizationOffset);
+        }
+        out[4 * x + 3] = (char)(v[3] * 255 + 0.5f);
+    }
+}
+
+void tonemapChannelsRowToLdr(
+    const vector<Channel>& channels, bool divideAlpha, char* out, int y, int width,
+    float exposureScale, float offset, float invGamma, ETonemap tonemap, EColorMap colorMap, bool dither
+) {
+    switch (tonemap) {
+        case ETonemap::SRGB:             tonemapChannelsRowToLdr<ETonemap::SRGB>(channels, divideAlpha, out, y, width, exposureScale, offset, invGamma, colorMap, dither); break;
+        case ETonemap::Gamma:            tonemapChannelsRowToLdr<ETonemap::Gamma>(channels, divideAlpha, out, y, width, exposureScale, offset, invGamma, colorMap, dither); break;
+        case ETonemap::FalseColor:       tonemapChannelsRowToLdr<ETonemap::FalseColor>(channels, divideAlpha, out, y, width, exposureScale, offset, invGamma, colorMap, dither); break;
+        case ETonemap::PositiveNegative: tonemapChannelsRowToLdr<ETonemap::PositiveNegative>(channels, divideAlpha, out, y, width, exposureScale, offset, invGamma, colorMap, dither); break;
+        default:
+            throw runtime_error{"Invalid tonemap selected."};
+    }
+}
+
+}
+
 ImageCanvas::ImageCanvas(Widget* parent, float pixelRatio)
 : Canvas{parent, 1, false, false, false}, mPixelRatio{pixelRatio} {
     mShader.reset(new UberShader{render_pass()});
+    mVgShaderImage.reset(new VectorGraphicsShader{render_pass()});
+    mVgShaderReference.reset(new VectorGraphicsShader{render_pass()});
     set_draw_border(false);
 }
 
@@ -47,12 +192,24 @@ bool ImageCanvas::scroll_event(const Vector2i& p, const Vector2f& rel) {
 }
 
 void ImageCanvas::draw_contents() {
+    trace::Span span{"canvas: draw"};
+
+    drawImageAndReference();
+
+    // Within the render pass such that the overlay is clipped to the canvas;
+    // the NanoVG overlays of draw() stack on top.
+    drawRetainedVectorGraphics();
+}
+
+void ImageCanvas::drawImageAndReference() {
     auto* glfwWindow = screen()->glfw_window();
     bool altHeld = glfwGetKey(glfwWindow, GLFW_KEY_LEFT_ALT) || glfwGetKey(glfwWindow, GLFW_KEY_RIGHT_ALT);
     bool ctrlHeld = glfwGetKey(glfwWindow, GLFW_KEY_LEFT_CONTROL) || glfwGetKey(glfwWindow, GLFW_KEY_RIGHT_CONTROL);
     Image* image = (mReference && altHeld) ? mReference.get() : mImage.get();
 
-    if (!image) {
+    // An evicted image has no pixel data until its transparent reload lands;
+    // show the checkerboard in the meantime.
+    if (!image || image->isEvicted()) {
         mShader->draw(
             2.0f * inverse(Vector2f{m_size}) / mPixelRatio,
             Vector2f{20.0f}
@@ -60,7 +217,12 @@ void ImageCanvas::draw_contents() {
         return;
     }
 
-    if (!mReference || ctrlHeld || image == mReference.get()) {
+    if (!mReference || ctrlHeld || image == mReference.get() || mReference->isEvicted()) {
+        if (shouldDrawTiled(image)) {
+            drawTiled(image, nullptr);
+            return;
+        }
+
         mShader->draw(
             2.0f * inverse(Vector2f{m_size}) / mPixelRatio,
             Vector2f{20.0f},
@@ -77,6 +239,11 @@ void ImageCanvas::draw_contents() {
         return;
     }
 
+    if (shouldDrawTiled(mImage.get()) || shouldDrawTiled(mReference.get())) {
+        drawTiled(mImage.get(), mReference.get());
+        return;
+    }
+
     mShader->draw(
         2.0f * inverse(Vector2f{m_size}) / mPixelRatio,
         Vector2f{20.0f},
@@ -97,6 +264,196 @@ void ImageCanvas::draw_contents() {
     );
 }
 
+void ImageCanvas::drawRetainedVectorGraphics() {
+    if (!mImage) {
+        return;
+    }
+
+    auto drawBatch = [&](VectorGraphicsShader& shader, const Image& image, const Color& defaultColor) {
+        const VgBatch& batch = image.vgBatch();
+        if (!batch.supported() || batch.empty()) {
+            return;
+        }
+
+        // The same display-window-to-screen mapping as the NanoVG replay
+        // path, composed with the screen-to-clip-space conversion. The
+        // canvas transform has no rotation, so scale and offset capture the
+        // full matrix.
+        Matrix3f toClip =
+            Matrix3f::scale(Vector2f{2.0f / m_size.x(), -2.0f / m_size.y()}) *
+            Matrix3f::translate(-0.5f * Vector2f{m_size}) *
+            displayWindowToNanogui(&image);
+
+        shader.draw(
+            batch,
+            Vector2f{toClip.m[0][0], toClip.m[1][1]},
+            Vector2f{toClip.m[2][0], toClip.m[2][1]},
+            Vector2f{m_size},
+            3.0f,
+            defaultColor
+        );
+    };
+
+    if (mReference) {
+        drawBatch(*mVgShaderReference, *mReference, REFERENCE_COLOR);
+    }
+
+    drawBatch(*mVgShaderImage, *mImage, IMAGE_COLOR);
+}
+
+bool ImageCanvas::shouldDrawTiled(const Image* image) {
+    // 8192 is the smallest GL_MAX_TEXTURE_SIZE still found on hardware we care
+    // about; larger images could fail to upload as a single texture, and even
+    // where they fit, a monolithic texture keeps every pixel resident when the
+    // viewport typically shows only a small fraction of them.
+    constexpr int MAX_UNTILED_DIM = 8192;
+    Vector2i size = image->size();
+    return size.x() > MAX_UNTILED_DIM || size.y() > MAX_UNTILED_DIM;
+}
+
+void ImageCanvas::drawTiled(Image* image, Image* reference) {
+    Vector2f pixelSizeNdc = 2.0f * inverse(Vector2f{m_size}) / mPixelRatio;
+
+    // Checkerboard background; the tiles drawn on top only cover the image.
+    mShader->draw(pixelSizeNdc, Vector2f{20.0f});
+
+    auto texToNano = textureToNanogui(image);
+    auto nanoToTex = inverse(texToNano);
+
+    Vector2f topLeft = nanoToTex * Vector2f{0.0f};
+    Vector2f bottomRight = nanoToTex * Vector2f{m_size};
+
+    Vector2i size = image->size();
+    Box2i visible = {
+        {(int)std::floor(topLeft.x()), (int)std::floor(topLeft.y())},
+        {(int)std::ceil(bottomRight.x()), (int)std::ceil(bottomRight.y())},
+    };
+    visible.min = max(visible.min, Vector2i{0});
+    visible.max = min(visible.max, size);
+    if (!visible.isValid()) {
+        return;
+    }
+
+    // Pick the downsampling such that a texel covers at least half a screen
+    // pixel: resident data scales with the viewport rather than the image,
+    // and the remaining up-to-2x minification is handled by each tile's own
+    // mipmaps. The canvas transform has no rotation, so mapping a unit vector
+    // yields the screen-space extent of one image pixel.
+    auto strideForTransform = [](const Matrix3f& toNano) {
+        Vector2f imagePixel = toNano * Vector2f{1.0f} - toNano * Vector2f{0.0f};
+        float minExtent = std::min(std::abs(imagePixel.x()), std::abs(imagePixel.y()));
+        int stride = 1;
+        while (stride < (1 << 16) && minExtent * stride < 0.5f) {
+            stride *= 2;
+        }
+        return stride;
+    };
+
+    int stride = strideForTransform(texToNano);
+
+    constexpr int TILE_SIZE_TEXELS = 2048;
+    int tileSpan = TILE_SIZE_TEXELS * stride;
+
+    const auto& channelNames = image->channelsInGroup(mRequestedChannelGroup);
+
+    auto imgTransform = transform(image);
+    auto invImgTransform = inverse(imgTransform);
+
+    Matrix3f refTransform{0.0f}, invRefTransform{0.0f};
+    Vector2i refSize{0};
+    int refStride = 1;
+    if (reference) {
+        refTransform = transform(reference);
+        invRefTransform = inverse(refTransform);
+        refSize = reference->size();
+        refStride = strideForTransform(textureToNanogui(reference));
+    }
+
+    for (int ty = visible.min.y() / tileSpan; ty * tileSpan < visible.max.y(); ++ty) {
+        for (int tx = visible.min.x() / tileSpan; tx * tileSpan < visible.max.x(); ++tx) {
+            Box2i tile = {
+                {tx * tileSpan, ty * tileSpan},
+                {std::min((tx + 1) * tileSpan, size.x()), std::min((ty + 1) * tileSpan, size.y())},
+            };
+
+            // One-texel gutter such that bilinear filtering does not bleed the
+            // clamped edge texels at tile seams.
+            Box2i padded = {
+                max(tile.min - Vector2i{stride}, Vector2i{0}),
+                min(tile.max + Vector2i{stride}, size),
+            };
+
+            auto* texture = image->tileTexture(channelNames, padded, stride);
+
+            // The texture covers whole texels, which may extend past the
+            // padded region when its span is not divisible by the stride.
+            Vector2f covered = Vector2f{texture->size()} * (float)stride;
+
+            Matrix3f uvTransform =
+                Matrix3f::translate(-Vector2f{padded.min} / covered) *
+                Matrix3f::scale(Vector2f{size} / covered) *
+                invImgTransform;
+
+            Vector2f c0 = imgTransform * (Vector2f{tile.min} / Vector2f{size});
+            Vector2f c1 = imgTransform * (Vector2f{tile.max} / Vector2f{size});
+            Box2f ndcRect = {min(c0, c1), max(c0, c1)};
+
+            if (!reference) {
+                mShader->draw(
+                    pixelSizeNdc,
+                    Vector2f{20.0f},
+                    ndcRect,
+                    texture,
+                    uvTransform,
+                    mExposure,
+                    mOffset,
+                    mGamma,
+                    mClipToLdr,
+                    mTonemap
+                );
+                continue;
+            }
+
+            // The reference pixels under this tile's screen rectangle. The
+            // region is clamped to at least one pixel inside the reference;
+            // screen pixels beyond it map outside [0, 1] and sample zero, as
+            // in the monolithic path.
+            Vector2f r0 = (invRefTransform * c0) * Vector2f{refSize};
+            Vector2f r1 = (invRefTransform * c1) * Vector2f{refSize};
+            Box2i refRegion = {
+                {(int)std::floor(std::min(r0.x(), r1.x())) - refStride, (int)std::floor(std::min(r0.y(), r1.y())) - refStride},
+                {(int)std::ceil(std::max(r0.x(), r1.x())) + refStride, (int)std::ceil(std::max(r0.y(), r1.y())) + refStride},
+            };
+            refRegion.min = min(max(refRegion.min, Vector2i{0}), refSize - Vector2i{1});
+            refRegion.max = max(min(refRegion.max, refSize), refRegion.min + Vector2i{1});
+
+            auto* refTexture = reference->tileTexture(mImage->channelsInGroup(mRequestedChannelGroup), refRegion, refStride);
+            Vector2f refCovered = Vector2f{refTexture->size()} * (float)refStride;
+
+            Matrix3f refUvTransform =
+                Matrix3f::translate(-Vector2f{refRegion.min} / refCovered) *
+                Matrix3f::scale(Vector2f{refSize} / refCovered) *
+                invRefTransform;
+
+            mShader->draw(
+                pixelSizeNdc,
+                Vector2f{20.0f},
+                ndcRect,
+                texture,
+                uvTransform,
+                refTexture,
+                refUvTransform,
+                mExposure,
+                mOffset,
+                mGamma,
+                mClipToLdr,
+                mTonemap,
+                mMetric
+            );
+        }
+    }
+}
+
 void ImageCanvas::drawPixelValuesAsText(NVGcontext* ctx) {
     TEV_ASSERT(mImage, "Can only draw pixel values if there exists an image.");
 
@@ -143,43 +500,91 @@ void ImageCanvas::drawPixelValuesAsText(NVGcontext* ctx) {
             (glfwGetKey(glfwWindow, GLFW_KEY_LEFT_SHIFT) || glfwGetKey(glfwWindow, GLFW_KEY_RIGHT_SHIFT)) &&
             (glfwGetKey(glfwWindow, GLFW_KEY_LEFT_CONTROL) || glfwGetKey(glfwWindow, GLFW_KEY_RIGHT_CONTROL));
 
+        size_t nChannels = colors.size();
+
+        // The formatted strings only change when the underlying values can;
+        // pan and zoom merely move where they are drawn. So evaluation and
+        // formatting are cached and the per-frame work is text submission.
+        Box2i region{startIndices, endIndices};
+        int referenceId = mReference ? mReference->id() : -1;
+
+        if (mPixelTextCache.imageId != mImage->id() || mPixelTextCache.referenceId != referenceId ||
+            mPixelTextCache.group != mRequestedChannelGroup || mPixelTextCache.metric != mMetric ||
+            mPixelTextCache.hex != shiftAndControlHeld || !(mPixelTextCache.region == region)) {
+            mPixelTextCache.imageId = mImage->id();
+            mPixelTextCache.referenceId = referenceId;
+            mPixelTextCache.group = mRequestedChannelGroup;
+            mPixelTextCache.metric = mMetric;
+            mPixelTextCache.hex = shiftAndControlHeld;
+            mPixelTextCache.region = region;
+            mPixelTextCache.strings.clear();
+
+            Vector2i cur;
+            vector<float> values;
+            for (cur.y() = startIndices.y(); cur.y() < endIndices.y(); ++cur.y()) {
+                for (cur.x() = startIndices.x(); cur.x() < endIndices.x(); ++cur.x()) {
+                    Vector2i nano = Vector2i{texToNano * (Vector2f{cur} + Vector2f{0.5f})};
+                    getValuesAtNanoPos(nano, values, channels);
+
+                    TEV_ASSERT(values.size() >= nChannels, "Can not have more values than channels.");
+
+                    for (size_t i = 0; i < nChannels; ++i) {
+                        if (shiftAndControlHeld) {
+                            float tonemappedValue = Channel::tail(channels[i]) == "A" ? values[i] : toSRGB(values[i]);
+                            unsigned char discretizedValue = (char)(tonemappedValue * 255 + 0.5f);
+                            mPixelTextCache.strings.emplace_back(fmt::format("{:02X}", discretizedValue));
+                        } else {
+                            mPixelTextCache.strings.emplace_back(
+                                std::abs(values[i]) > 100000 ? fmt::format("{:6g}", values[i]) : fmt::format("{:.5f}", values[i])
+                            );
+                        }
+                    }
+                }
+            }
+        }
+
+        // Screen positions of every cached string under the current transform.
+        vector<Vector2f> positions;
+        positions.reserve(mPixelTextCache.strings.size());
+
         Vector2i cur;
-        vector<float> values;
         for (cur.y() = startIndices.y(); cur.y() < endIndices.y(); ++cur.y()) {
             for (cur.x() = startIndices.x(); cur.x() < endIndices.x(); ++cur.x()) {
                 Vector2i nano = Vector2i{texToNano * (Vector2f{cur} + Vector2f{0.5f})};
-                getValuesAtNanoPos(nano, values, channels);
-
-                TEV_ASSERT(values.size() >= colors.size(), "Can not have more values than channels.");
-
-                for (size_t i = 0; i < colors.size(); ++i) {
-                    string str;
-                    Vector2f pos;
-
+                for (size_t i = 0; i < nChannels; ++i) {
                     if (shiftAndControlHeld) {
-                        float tonemappedValue = Channel::tail(channels[i]) == "A" ? values[i] : toSRGB(values[i]);
-                        unsigned char discretizedValue = (char)(tonemappedValue * 255 + 0.5f);
-                        str = fmt::format("{:02X}", discretizedValue);
-
-                        pos = Vector2f{
-                            m_pos.x() + nano.x() + (i - 0.5f * (colors.size() - 1)) * fontSize * 0.88f,
-                            (float)m_pos.y() + nano.y(),
-                        };
+                        positions.emplace_back(
+                            m_pos.x() + nano.x() + (i - 0.5f * (nChannels - 1)) * fontSize * 0.88f,
+                            (float)m_pos.y() + nano.y()
+                        );
                     } else {
-                        str = std::abs(values[i]) > 100000 ? fmt::format("{:6g}", values[i]) : fmt::format("{:.5f}", values[i]);
-
-                        pos = Vector2f{
+                        positions.emplace_back(
                             (float)m_pos.x() + nano.x(),
-                            m_pos.y() + nano.y() + (i - 0.5f * (colors.size() - 1)) * fontSize,
-                        };
+                            m_pos.y() + nano.y() + (i - 0.5f * (nChannels - 1)) * fontSize
+                        );
                     }
-
-                    Color col = colors[i];
-                    nvgFillColor(ctx, Color(col.r(), col.g(), col.b(), fontAlpha));
-                    drawTextWithShadow(ctx, pos.x(), pos.y(), str, fontAlpha);
                 }
             }
         }
+
+        // Submit in large batches — one blurred shadow pass for everything
+        // and one pass per channel color — instead of toggling fill color
+        // and blur state around every individual string.
+        nvgSave(ctx);
+        nvgFontBlur(ctx, 2);
+        nvgFillColor(ctx, Color{0.0f, fontAlpha});
+        for (size_t j = 0; j < positions.size(); ++j) {
+            nvgText(ctx, positions[j].x() + 1, positions[j].y() + 1, mPixelTextCache.strings[j].c_str(), nullptr);
+        }
+        nvgRestore(ctx);
+
+        for (size_t i = 0; i < nChannels; ++i) {
+            Color col = colors[i];
+            nvgFillColor(ctx, Color(col.r(), col.g(), col.b(), fontAlpha));
+            for (size_t j = i; j < positions.size(); j += nChannels) {
+                nvgText(ctx, positions[j].x(), positions[j].y(), mPixelTextCache.strings[j].c_str(), nullptr);
+            }
+        }
     }
 }
 
@@ -396,7 +801,7 @@ void ImageCanvas::draw(NVGcontext* ctx) {
             nvgStrokeWidth(ctx, 3.0f);
 
             size_t saveCounter = 0;
-            for (const auto& command : mImage->vgCommands()) {
+            for (const auto& command : commands) {
                 if (command.type == VgCommand::EType::Save) {
                     ++saveCounter;
                 } else if (command.type == VgCommand::EType::Restore) {
@@ -421,11 +826,14 @@ void ImageCanvas::draw(NVGcontext* ctx) {
             nvgRestore(ctx);
         };
 
-        if (mReference && !mReference->vgCommands().empty()) {
+        // Command lists within the retained subset were already drawn from
+        // GPU vertex buffers in draw_contents(); only lists the batch cannot
+        // represent are replayed here.
+        if (mReference && !mReference->vgCommands().empty() && !mReference->vgBatch().supported()) {
             applyVgCommandsSandboxed(REFERENCE_COLOR, mReference->vgCommands());
         }
 
-        if (!mImage->vgCommands().empty()) {
+        if (!mImage->vgCommands().empty() && !mImage->vgBatch().supported()) {
             applyVgCommandsSandboxed(IMAGE_COLOR, mImage->vgCommands());
         }
 
@@ -482,8 +890,7 @@ void ImageCanvas::getValuesAtNanoPos(Vector2i nanoPos, vector<float>& result, co
     }
 
     auto imageCoords = getImageCoords(*mImage, nanoPos);
-    for (const auto& channel : channels) {
-        const Channel* c = mImage->channel(channel);
+    for (const Channel* c : mImage->channels(channels)) {
         TEV_ASSERT(c, "Requested channel must exist.");
         result.push_back(c->eval(imageCoords));
     }
@@ -491,11 +898,12 @@ void ImageCanvas::getValuesAtNanoPos(Vector2i nanoPos, vector<float>& result, co
     // Subtract reference if it exists.
     if (mReference) {
         auto referenceCoords = getImageCoords(*mReference, nanoPos);
+        auto referenceChannels = mReference->channels(channels);
         for (size_t i = 0; i < result.size(); ++i) {
             bool isAlpha = Channel::isAlpha(channels[i]);
             float defaultVal = isAlpha && mReference->contains(referenceCoords) ? 1.0f : 0.0f;
 
-            const Channel* c = mReference->channel(channels[i]);
+            const Channel* c = referenceChannels[i];
             float reference = c ? c->eval(referenceCoords) : defaultVal;
 
             result[i] = isAlpha ? 0.5f * (result[i] + reference) : applyMetric(result[i], reference);
@@ -503,7 +911,7 @@ void ImageCanvas::getValuesAtNanoPos(Vector2i nanoPos, vector<float>& result, co
     }
 }
 
-Vector3f ImageCanvas::applyTonemap(const Vector3f& value, float gamma, ETonemap tonemap) {
+Vector3f ImageCanvas::applyTonemap(const Vector3f& value, float gamma, ETonemap tonemap, EColorMap colorMap) {
     Vector3f result;
     switch (tonemap) {
         case ETonemap::SRGB:
@@ -518,8 +926,8 @@ Vector3f ImageCanvas::applyTonemap(const Vector3f& value, float gamma, ETonemap
             }
         case ETonemap::FalseColor:
             {
-                static const auto falseColor = [](float linear) {
-                    static const auto& fcd = colormap::turbo();
+                const auto falseColor = [colorMap](float linear) {
+                    const auto& fcd = colormap::data(colorMap);
                     int start = 4 * clamp((int)(linear * (fcd.size() / 4)), 0, (int)fcd.size() / 4 - 1);
                     return Vector3f{fcd[start], fcd[start + 1], fcd[start + 2]};
                 };
@@ -564,87 +972,147 @@ void ImageCanvas::resetTransform() {
 std::vector<float> ImageCanvas::getHdrImageData(bool divideAlpha, int priority) const {
     std::vector<float> result;
 
-    if (!mImage) {
+    auto rowSource = getHdrImageDataRowSource(divideAlpha, priority);
+    if (!rowSource) {
         return result;
     }
 
-    const auto& channels = channelsFromImages(mImage, mReference, mRequestedChannelGroup, mMetric, priority);
-    auto numPixels = mImage->numPixels();
+    // Flatten image into vector
+    Vector2i size = mImage->size();
+    result.resize(4 * (size_t)size.x() * size.y());
+    rowSource(result.data(), 0, size.y());
+
+    return result;
+}
+
+std::vector<char> ImageCanvas::getLdrImageData(bool divideAlpha, int priority, bool dither) const {
+    std::vector<char> result;
 
-    if (channels.empty()) {
+    auto rowSource = getLdrImageDataRowSource(divideAlpha, priority, dither);
+    if (!rowSource) {
         return result;
     }
 
-    int nChannelsToSave = std::min((int)channels.size(), 4);
+    Vector2i size = mImage->size();
+    result.resize(4 * (size_t)size.x() * size.y());
+    rowSource(result.data(), 0, size.y());
 
-    // Flatten image into vector
-    result.resize(4 * numPixels, 0);
+    return result;
+}
 
-    ThreadPool::global().parallelFor(0, nChannelsToSave, [&channels, &result](int i) {
-        const auto& channelData = channels[i].data();
-        for (size_t j = 0; j < channelData.size(); ++j) {
-            result[j * 4 + i] = channelData[j];
-        }
-    }, priority);
+std::function<void(float*, int, int)> ImageCanvas::getHdrImageDataRowSource(bool divideAlpha, int priority) const {
+    if (!mImage) {
+        return {};
+    }
 
-    // Manually set alpha channel to 1 if the image does not have one.
-    if (nChannelsToSave < 4) {
-        for (size_t i = 0; i < numPixels; ++i) {
-            result[i * 4 + 3] = 1;
-        }
+    // The resolved channels — with the comparison metric already applied when
+    // a reference is set — are computed once and shared by every batch the
+    // saver pulls; only one scanline batch is ever interleaved at a time.
+    auto channels = make_shared<vector<Channel>>(
+        channelsFromImages(mImage, mReference, mRequestedChannelGroup, mMetric, Box2i{mImage->size()}, 1, priority)
+    );
+
+    if (channels->empty()) {
+        return {};
     }
 
-    // Divide alpha out if needed (for storing in non-premultiplied formats)
-    if (divideAlpha) {
-        ThreadPool::global().parallelFor(0, min(nChannelsToSave, 3), [&result,numPixels](int i) {
-            for (size_t j = 0; j < numPixels; ++j) {
-                float alpha = result[j * 4 + 3];
-                if (alpha == 0) {
-                    result[j * 4 + i] = 0;
-                } else {
-                    result[j * 4 + i] /= alpha;
+    int width = mImage->size().x();
+    return [channels, width, divideAlpha, priority](float* data, int beginRow, int numRows) {
+        // Read through a const reference: non-const data() would detach
+        // buffers that channelsFromImages shared copy-on-write.
+        const vector<Channel>& chans = *channels;
+        int nChannelsToSave = min((int)chans.size(), 4);
+        ThreadPool::global().parallelFor(beginRow, beginRow + numRows, [&](int y) {
+            float* row = data + 4 * (size_t)(y - beginRow) * width;
+            for (int x = 0; x < width; ++x) {
+                size_t j = (size_t)y * width + x;
+                float* pixel = row + 4 * (size_t)x;
+                for (int c = 0; c < nChannelsToSave; ++c) {
+                    pixel[c] = chans[c].data()[j];
+                }
+
+                // Manually set alpha channel to 1 if the image does not have one.
+                for (int c = nChannelsToSave; c < 4; ++c) {
+                    pixel[c] = c == 3 ? 1.0f : 0.0f;
+                }
+
+                // Divide alpha out if needed (for storing in non-premultiplied formats)
+                if (divideAlpha) {
+                    float alpha = pixel[3];
+                    for (int c = 0; c < min(nChannelsToSave, 3); ++c) {
+                        pixel[c] = alpha == 0 ? 0 : pixel[c] / alpha;
+                    }
                 }
             }
         }, priority);
-    }
-
-    return result;
+    };
 }
 
-std::vector<char> ImageCanvas::getLdrImageData(bool divideAlpha, int priority) const {
-    std::vector<char> result;
+std::function<void(char*, int, int)> ImageCanvas::getLdrImageDataRowSource(bool divideAlpha, int priority, bool dither) const {
+    return ldrImageDataRowSource(mImage, mReference, mRequestedChannelGroup, mMetric, mExposure, mOffset, mGamma, mTonemap, mColorMap, divideAlpha, priority, dither);
+}
 
-    if (!mImage) {
-        return result;
+std::function<void(char*, int, int)> ImageCanvas::ldrImageDataRowSource(
+    shared_ptr<Image> image,
+    shared_ptr<Image> reference,
+    const string& requestedChannelGroup,
+    EMetric metric,
+    float exposure,
+    float offset,
+    float gamma,
+    ETonemap tonemap,
+    EColorMap colorMap,
+    bool divideAlpha,
+    int priority,
+    bool dither
+) {
+    if (!image) {
+        return {};
     }
 
-    auto numPixels = mImage->numPixels();
-    auto floatData = getHdrImageData(divideAlpha, priority);
+    auto channels = make_shared<vector<Channel>>(
+        channelsFromImages(image, reference, requestedChannelGroup, metric, Box2i{image->size()}, 1, priority)
+    );
 
-    // Store as LDR image.
-    result.resize(floatData.size());
+    if (channels->empty()) {
+        return {};
+    }
 
-    ThreadPool::global().parallelFor<size_t>(0, numPixels, [&](size_t i) {
-        size_t start = 4 * i;
-        Vector3f value = applyTonemap({
-            applyExposureAndOffset(floatData[start]),
-            applyExposureAndOffset(floatData[start + 1]),
-            applyExposureAndOffset(floatData[start + 2]),
-        });
-        for (int j = 0; j < 3; ++j) {
-            floatData[start + j] = value[j];
-        }
-        for (int j = 0; j < 4; ++j) {
-            result[start + j] = (char)(floatData[start + j] * 255 + 0.5f);
-        }
-    }, priority);
+    // Unlike the HDR path, this does not go through an intermediate RGBA
+    // float buffer: each row is read from the per-channel data, tonemapped,
+    // and quantized to bytes in one fused pass.
+    int width = image->size().x();
+    float exposureScale = pow(2.0f, exposure);
+    return [channels, width, divideAlpha, dither, exposureScale, offset, invGamma = 1 / gamma, tonemap, colorMap, priority](
+        char* data, int beginRow, int numRows
+    ) {
+        ThreadPool::global().parallelFor(beginRow, beginRow + numRows, [&](int y) {
+            tonemapChannelsRowToLdr(
+                *channels, divideAlpha, data + 4 * (size_t)(y - beginRow) * width, y, width,
+                exposureScale, offset, invGamma, tonemap, colorMap, dither
+            );
+        }, priority);
+    };
+}
 
-    return result;
+// Wraps a row source such that coarse progress shows up in the log while a
+// large export is streaming.
+template <typename T> static std::function<void(T*, int, int)>
+logProgress(std::function<void(T*, int, int)> rowSource, int totalRows, const fs::path& path) {
+    return [rowSource, totalRows, path, lastQuarter = std::make_shared<int>(0)](T* data, int beginRow, int numRows) {
+        rowSource(data, beginRow, numRows);
+
+        int quarter = 4 * (beginRow + numRows) / totalRows;
+        if (quarter > *lastQuarter && quarter < 4) {
+            *lastQuarter = quarter;
+            tlog::info() << fmt::format("Saving {}... {}%", path, quarter * 25);
+        }
+    };
 }
 
-void ImageCanvas::saveImage(const fs::path& path) const {
+Task<void> ImageCanvas::saveImage(fs::path path) const {
     if (!mImage) {
-        return;
+        co_return;
     }
 
     Vector2i imageSize = mImage->size();
@@ -652,11 +1120,6 @@ void ImageCanvas::saveImage(const fs::path& path) const {
     tlog::info() << "Saving currently displayed image as " << path << ".";
     auto start = chrono::system_clock::now();
 
-    ofstream f{path, ios_base::binary};
-    if (!f) {
-        throw invalid_argument{fmt::format("Could not open file {}", path)};
-    }
-
     for (const auto& saver : ImageSaver::getSavers()) {
         if (!saver->canSaveFile(path)) {
             continue;
@@ -667,43 +1130,103 @@ void ImageCanvas::saveImage(const fs::path& path) const {
 
         TEV_ASSERT(hdrSaver || ldrSaver, "Each image saver must either be a HDR or an LDR saver.");
 
+        // The row sources are built on the calling thread — they snapshot the
+        // canvas state (resolved channels, tonemap settings) and afterwards
+        // no longer touch `this` — so the encode and disk write below can run
+        // on the I/O pool while the UI keeps rendering. Multiple saves simply
+        // queue up behind each other there.
         if (hdrSaver) {
-            hdrSaver->save(
-                f, path,
-                getHdrImageData(!saver->hasPremultipliedAlpha(), std::numeric_limits<int>::max()),
-                imageSize, 4
-            );
+            auto rowSource = getHdrImageDataRowSource(!saver->hasPremultipliedAlpha(), std::numeric_limits<int>::max());
+            if (!rowSource) {
+                throw invalid_argument{"Image has no channels to save."};
+            }
+
+            co_await ThreadPool::globalIo().enqueueCoroutine(std::numeric_limits<int>::max());
+
+            ofstream f{path, ios_base::binary};
+            if (!f) {
+                throw invalid_argument{fmt::format("Could not open file {}", path)};
+            }
+
+            hdrSaver->save(f, path, logProgress(std::move(rowSource), imageSize.y(), path), imageSize, 4);
         } else if (ldrSaver) {
-            ldrSaver->save(
-                f, path,
-                getLdrImageData(!saver->hasPremultipliedAlpha(), std::numeric_limits<int>::max()),
-                imageSize, 4
-            );
+            auto rowSource = getLdrImageDataRowSource(!saver->hasPremultipliedAlpha(), std::numeric_limits<int>::max());
+            if (!rowSource) {
+                throw invalid_argument{"Image has no channels to save."};
+            }
+
+            co_await ThreadPool::globalIo().enqueueCoroutine(std::numeric_limits<int>::max());
+
+            ofstream f{path, ios_base::binary};
+            if (!f) {
+                throw invalid_argument{fmt::format("Could not open file {}", path)};
+            }
+
+            ldrSaver->save(f, path, logProgress(std::move(rowSource), imageSize.y(), path), imageSize, 4);
         }
 
         auto end = chrono::system_clock::now();
         chrono::duration<double> elapsedSeconds = end - start;
 
         tlog::success() << fmt::format("Saved {} after {:.3f} seconds.", path, elapsedSeconds.count());
-        return;
+        co_return;
     }
 
     throw invalid_argument{fmt::format("No save routine for image type {} found.", path.extension())};
 }
 
 shared_ptr<Lazy<shared_ptr<CanvasStatistics>>> ImageCanvas::canvasStatistics() {
-    if (!mImage) {
+    if (!mImage || mImage->isEvicted() || (mReference && mReference->isEvicted())) {
         return nullptr;
     }
 
-    string channels = join(mImage->channelsInGroup(mRequestedChannelGroup), ",");
+    Box2i region{mImage->size()};
+    if (mStatisticsOnVisibleRegion) {
+        region = visibleStatisticsRegion();
+    }
+
+    // Group names are unique per image, so they can key the cache directly
+    // without joining the group's channel names on every lookup.
     string key = mReference ?
-        fmt::format("{}-{}-{}-{}", mImage->id(), channels, mReference->id(), (int)mMetric) :
-        fmt::format("{}-{}", mImage->id(), channels);
+        fmt::format("{}-{}-{}-{}", mImage->id(), mRequestedChannelGroup, mReference->id(), (int)mMetric) :
+        fmt::format("{}-{}", mImage->id(), mRequestedChannelGroup);
+
+    if (region != Box2i{mImage->size()}) {
+        key += fmt::format("-{},{},{},{}", region.min.x(), region.min.y(), region.max.x(), region.max.y());
+    }
 
     auto iter = mCanvasStatistics.find(key);
     if (iter != end(mCanvasStatistics)) {
-        return iter->second;
+        auto pending = mPendingCanvasStatistics.find(key);
+        if (pending == end(mPendingCanvasStatistics) || !pending->second.canceled()) {
+            // Serve the instant subsample estimate until the exact result lands.
+            if (!iter->second->isReady()) {
+                auto approx = mApproxCanvasStatistics.find(key);
+                if (approx != end(mApproxCanvasStatistics) && approx->second->isReady()) {
+                    return approx->second;
+                }
+            }
+
+            return iter->second;
+        }
+
+        // A previous computation for this key was canceled mid-flight;
+        // discard its partial result and start over below.
+        mCanvasStatistics.erase(iter);
+        mApproxCanvasStatistics.erase(key);
+        mPendingCanvasStatistics.erase(pending);
+    }
+
+    // Any computation still running for a view other than the one on screen
+    // is obsolete; trip its token so it stops burning cores.
+    for (auto it = begin(mPendingCanvasStatistics); it != end(mPendingCanvasStatistics); ) {
+        auto stat = mCanvasStatistics.find(it->first);
+        if (stat == end(mCanvasStatistics) || stat->second->isReady()) {
+            it = mPendingCanvasStatistics.erase(it);
+        } else {
+            it->second.cancel();
+            ++it;
+        }
     }
 
     static std::atomic<int> sId{0};
@@ -717,6 +1240,9 @@ shared_ptr<Lazy<shared_ptr<CanvasStatistics>>> ImageCanvas::canvasStatistics() {
     promise<shared_ptr<CanvasStatistics>> promise;
     mCanvasStatistics.insert(make_pair(key, make_shared<Lazy<shared_ptr<CanvasStatistics>>>(promise.get_future())));
 
+    auto cancel = CancellationToken::create();
+    mPendingCanvasStatistics[key] = cancel;
+
     // Remember the keys associateed with the participating images. Such that their
     // canvas statistics can be retrieved and deleted when either of the images
     // is closed or mutated.
@@ -728,88 +1254,208 @@ shared_ptr<Lazy<shared_ptr<CanvasStatistics>>> ImageCanvas::canvasStatistics() {
         mReference->setStaleIdCallback([this](int id) { purgeCanvasStatistics(id); });
     }
 
-    invokeTaskDetached([image, reference, requestedChannelGroup, metric, priority, p=std::move(promise)]() mutable -> Task<void> {
+    invokeTaskDetached([image, reference, requestedChannelGroup, metric, region, priority, cancel, p=std::move(promise)]() mutable -> Task<void> {
         co_await ThreadPool::global().enqueueCoroutine(priority);
-        p.set_value(co_await computeCanvasStatistics(image, reference, requestedChannelGroup, metric, priority));
+        p.set_value(co_await computeCanvasStatistics(image, reference, requestedChannelGroup, metric, region, 1, priority, cancel));
     });
 
+    // For huge regions, additionally kick off a stratified-subsample pass at
+    // even higher priority. It touches only a few million pixels and hence
+    // finishes near-instantly; its estimate is displayed until the exact
+    // computation above replaces it.
+    static const size_t SAMPLE_TARGET = 2 * 1024 * 1024;
+    size_t regionPixels = (size_t)region.size().x() * region.size().y();
+    if (regionPixels > 4 * SAMPLE_TARGET) {
+        int sampleStride = (int)ceil(sqrt((double)regionPixels / SAMPLE_TARGET));
+        int approxPriority = ++sId;
+
+        std::promise<shared_ptr<CanvasStatistics>> approxPromise;
+        mApproxCanvasStatistics[key] = make_shared<Lazy<shared_ptr<CanvasStatistics>>>(approxPromise.get_future());
+
+        invokeTaskDetached([image, reference, requestedChannelGroup, metric, region, sampleStride, approxPriority, cancel, p=std::move(approxPromise)]() mutable -> Task<void> {
+            co_await ThreadPool::global().enqueueCoroutine(approxPriority);
+            p.set_value(co_await computeCanvasStatistics(image, reference, requestedChannelGroup, metric, region, sampleStride, approxPriority, cancel));
+        });
+    }
+
     return mCanvasStatistics.at(key);
 }
 
 void ImageCanvas::purgeCanvasStatistics(int imageId) {
     for (const auto& key : mImageIdToCanvasStatisticsKey[imageId]) {
+        auto pending = mPendingCanvasStatistics.find(key);
+        if (pending != end(mPendingCanvasStatistics)) {
+            pending->second.cancel();
+            mPendingCanvasStatistics.erase(pending);
+        }
+
         mCanvasStatistics.erase(key);
+        mApproxCanvasStatistics.erase(key);
     }
 
     mImageIdToCanvasStatisticsKey.erase(imageId);
 }
 
+Box2i ImageCanvas::visibleStatisticsRegion() {
+    // The canvas transform has no rotation, so the two mapped corners span the
+    // entire visible rectangle in image space.
+    Matrix3f toImage = inverse(textureToNanogui(mImage.get()));
+    Vector2f corner0 = toImage * Vector2f{0.0f};
+    Vector2f corner1 = toImage * Vector2f{m_size};
+
+    Box2i region{
+        Vector2i{(int)floor(min(corner0.x(), corner1.x())), (int)floor(min(corner0.y(), corner1.y()))},
+        Vector2i{(int)ceil(max(corner0.x(), corner1.x())), (int)ceil(max(corner0.y(), corner1.y()))},
+    };
+
+    region.min = min(max(region.min, Vector2i{0}), mImage->size());
+    region.max = min(max(region.max, Vector2i{0}), mImage->size());
+
+    // Quantize outward to a coarse tile grid: small pans keep mapping to the
+    // same region (and hence the same cached statistics), and larger pans
+    // extend the region one tile at a time.
+    static const int TILE_SIZE = 256;
+    region.min = region.min / TILE_SIZE * TILE_SIZE;
+    region.max = min((region.max + Vector2i{TILE_SIZE - 1}) / TILE_SIZE * TILE_SIZE, mImage->size());
+
+    // If the image is entirely off-screen, there is no visible region whose
+    // statistics would be meaningful; fall back to the full image.
+    if (region.size().x() <= 0 || region.size().y() <= 0) {
+        return Box2i{mImage->size()};
+    }
+
+    return region;
+}
+
 vector<Channel> ImageCanvas::channelsFromImages(
     shared_ptr<Image> image,
     shared_ptr<Image> reference,
     const string& requestedChannelGroup,
     EMetric metric,
-    int priority
+    const Box2i& region,
+    int sampleStride,
+    int priority,
+    CancellationToken cancel
 ) {
     if (!image) {
         return {};
     }
 
+    // With a stride of n, only every n-th pixel along each axis is evaluated,
+    // producing channels that cover the region with a stratified subsample.
+    Vector2i size = (region.size() + Vector2i{sampleStride - 1}) / sampleStride;
+
     vector<Channel> result;
-    auto channelNames = image->channelsInGroup(requestedChannelGroup);
+    const auto& channelNames = image->channelsInGroup(requestedChannelGroup);
     for (size_t i = 0; i < channelNames.size(); ++i) {
-        result.emplace_back(toUpper(Channel::tail(channelNames[i])), image->size());
+        // Created lazily: channels either alias the image's buffer below or
+        // materialize right before being filled.
+        result.emplace_back(toUpper(Channel::tail(channelNames[i])), size, EPixelFormat::F32, true);
     }
 
     if (!reference) {
         ThreadPool::global().parallelFor(0, (int)channelNames.size(), [&](int i) {
             const auto* channel = image->channel(channelNames[i]);
-            for (size_t j = 0; j < channel->numPixels(); ++j) {
-                result[i].at(j) = channel->eval(j);
+
+            // A full-resolution, full-region request without a reference is
+            // the identity transform; alias the image's buffer copy-on-write
+            // instead of copying it. The export kernels read float rows
+            // directly, so only float-stored channels are shared.
+            if (sampleStride == 1 && region == Box2i{image->size()} &&
+                channel->format() == EPixelFormat::F32 && channel->materialized()) {
+                result[i].shareDataFrom(*channel);
+                return;
             }
-        }, priority);
+
+            result[i].materialize();
+            for (int y = 0; y < size.y(); ++y) {
+                for (int x = 0; x < size.x(); ++x) {
+                    result[i].at({x, y}) = channel->eval({region.min.x() + x * sampleStride, region.min.y() + y * sampleStride});
+                }
+            }
+        }, priority, cancel);
     } else {
-        Vector2i size = Vector2i{image->size().x(), image->size().y()};
-        Vector2i offset = (Vector2i{reference->size().x(), reference->size().y()} - size) / 2;
+        // Offset from region-local image coordinates to reference coordinates.
+        Vector2i offset = (Vector2i{reference->size().x(), reference->size().y()} - Vector2i{image->size().x(), image->size().y()}) / 2 + region.min;
 
-        ThreadPool::global().parallelFor<size_t>(0, channelNames.size(), [&](size_t i) {
+        // Rows where the reference overlaps are much more expensive than rows where
+        // it does not, so hand out rows dynamically rather than in static slices.
+        for (size_t i = 0; i < channelNames.size(); ++i) {
             const auto* channel = image->channel(channelNames[i]);
+            result[i].materialize();
 
             const Channel* referenceChannel = reference->channel(channelNames[i]);
             if (Channel::isAlpha(result[i].name())) {
-                for (int y = 0; y < size.y(); ++y) {
+                ThreadPool::global().parallelForDynamic(0, size.y(), [&](int y) {
                     for (int x = 0; x < size.x(); ++x) {
                         result[i].at({x, y}) = 0.5f * (
-                            channel->eval({x, y}) +
-                            (referenceChannel ? referenceChannel->eval({x + offset.x(), y + offset.y()}) : 1.0f)
+                            channel->eval({region.min.x() + x * sampleStride, region.min.y() + y * sampleStride}) +
+                            (referenceChannel ? referenceChannel->eval({offset.x() + x * sampleStride, offset.y() + y * sampleStride}) : 1.0f)
                         );
                     }
-                }
+                }, priority, cancel);
             } else {
-                for (int y = 0; y < size.y(); ++y) {
-                    for (int x = 0; x < size.x(); ++x) {
-                        result[i].at({x, y}) = ImageCanvas::applyMetric(
-                            channel->eval({x, y}),
-                            referenceChannel ? referenceChannel->eval({x + offset.x(), y + offset.y()}) : 0.0f,
+                // The batch kernel needs contiguous float rows: no subsampling, both
+                // channels materialized with float storage, and every row of the
+                // region mapping to a row that lies entirely within the reference.
+                bool contiguousRows = sampleStride == 1 && channel->format() == EPixelFormat::F32 && channel->materialized() && (
+                    !referenceChannel || (
+                        referenceChannel->format() == EPixelFormat::F32 && referenceChannel->materialized() &&
+                        offset.x() >= 0 && offset.y() >= 0 &&
+                        offset.x() + size.x() <= referenceChannel->size().x() &&
+                        offset.y() + size.y() <= referenceChannel->size().y()
+                    )
+                );
+
+                if (contiguousRows) {
+                    ThreadPool::global().parallelForDynamic(0, size.y(), [&](int y) {
+                        applyMetricToRow(
+                            &result[i].at({0, y}),
+                            channel->data().data() + (size_t)(y + region.min.y()) * channel->size().x() + region.min.x(),
+                            referenceChannel ?
+                                referenceChannel->data().data() + (size_t)(y + offset.y()) * referenceChannel->size().x() + offset.x() :
+                                nullptr,
+                            size.x(),
                             metric
                         );
-                    }
+                    }, priority, cancel);
+                } else {
+                    ThreadPool::global().parallelForDynamic(0, size.y(), [&](int y) {
+                        for (int x = 0; x < size.x(); ++x) {
+                            result[i].at({x, y}) = ImageCanvas::applyMetric(
+                                channel->eval({region.min.x() + x * sampleStride, region.min.y() + y * sampleStride}),
+                                referenceChannel ? referenceChannel->eval({offset.x() + x * sampleStride, offset.y() + y * sampleStride}) : 0.0f,
+                                metric
+                            );
+                        }
+                    }, priority, cancel);
                 }
             }
-        }, priority);
+        }
     }
 
     return result;
 }
 
+// Statistics are computed on the CPU even though the displayed pixels already
+// live on the GPU: nanogui's rendering abstraction (GL ~2.1 / GLES 2 / Metal)
+// exposes neither compute shaders nor the scatter writes a histogram needs, so
+// a GPU reduction would require a per-backend fork of the render path. The CPU
+// sweep instead relies on the stratified-subsample estimate and the optional
+// visible-region mode to stay interactive on very large images.
 Task<shared_ptr<CanvasStatistics>> ImageCanvas::computeCanvasStatistics(
     std::shared_ptr<Image> image,
     std::shared_ptr<Image> reference,
     const string& requestedChannelGroup,
     EMetric metric,
-    int priority
+    const Box2i& region,
+    int sampleStride,
+    int priority,
+    CancellationToken cancel
 ) {
-    auto flattened = channelsFromImages(image, reference, requestedChannelGroup, metric, priority);
+    trace::Span span{"canvas: statistics"};
+
+    auto flattened = channelsFromImages(image, reference, requestedChannelGroup, metric, region, sampleStride, priority, cancel);
 
     float mean = 0;
     float maximum = -numeric_limits<float>::infinity();
@@ -834,12 +1480,48 @@ Task<shared_ptr<CanvasStatistics>> ImageCanvas::computeCanvasStatistics(
 
     int nChannels = result->nChannels = alphaChannel ? (int)flattened.size() - 1 : (int)flattened.size();
 
-    for (int i = 0; i < nChannels; ++i) {
-        const auto& channel = flattened[i];
-        auto [cmin, cmax, cmean] = channel.minMaxMean();
-        mean += cmean;
-        maximum = max(maximum, cmax);
-        minimum = min(minimum, cmin);
+    size_t numPixels = flattened.empty() ? 0 : flattened.front().numPixels();
+
+    // Partition the pixel range once and reuse the partitioning for both sweeps
+    // below. Each task reduces into its own cache-line padded partial, so the
+    // sweeps never bounce shared state between cores.
+    size_t nTasks = clamp(numPixels / 65536, (size_t)1, ThreadPool::global().numThreads());
+
+    // Fused single-pass min/max/mean: every task sweeps its slice of each
+    // channel exactly once, and the per-task partials are merged afterwards.
+    struct alignas(64) StatsPartial {
+        float minimum = numeric_limits<float>::infinity();
+        float maximum = -numeric_limits<float>::infinity();
+        float mean = 0;
+    };
+
+    vector<StatsPartial> statsPartials(nTasks);
+    co_await ThreadPool::global().parallelForAsync<size_t>(0, nTasks, [&](size_t t) {
+        size_t taskBegin = numPixels * t / nTasks;
+        size_t taskEnd = numPixels * (t + 1) / nTasks;
+
+        auto& partial = statsPartials[t];
+        for (int i = 0; i < nChannels; ++i) {
+            const auto& channel = flattened[i];
+            float sum = 0;
+            for (size_t j = taskBegin; j < taskEnd; ++j) {
+                float val = channel.eval(j);
+                sum += val;
+                partial.minimum = min(partial.minimum, val);
+                partial.maximum = max(partial.maximum, val);
+            }
+            partial.mean += sum / numPixels;
+        }
+    }, priority, cancel);
+
+    if (cancel.canceled()) {
+        co_return result;
+    }
+
+    for (const auto& partial : statsPartials) {
+        mean += partial.mean;
+        maximum = max(maximum, partial.maximum);
+        minimum = min(minimum, partial.minimum);
     }
 
     result->mean = nChannels > 0 ? (mean / nChannels) : 0;
@@ -847,7 +1529,10 @@ Task<shared_ptr<CanvasStatistics>> ImageCanvas::computeCanvasStatistics(
     result->minimum = minimum;
 
     // Now that we know the maximum and minimum value we can define our histogram bin size.
-    static const int NUM_BINS = 400;
+    // The bins are finer than what MultiGraph displays: it re-bins them under
+    // the current exposure/offset at draw time, so slider drags update the
+    // histogram without another pass over the pixels.
+    static const int NUM_BINS = 1600;
     result->histogram.resize(NUM_BINS*nChannels);
 
     // We're going to draw our histogram in log space.
@@ -856,10 +1541,6 @@ Task<shared_ptr<CanvasStatistics>> ImageCanvas::computeCanvasStatistics(
     auto symmetricLog = [](float val) {
         return val > 0 ? (log(val + addition) - smallest) : -(log(-val + addition) - smallest);
     };
-    auto symmetricLogInverse = [](float val) {
-        return val > 0 ? (exp(val + smallest) - addition) : -(exp(-val + smallest) - addition);
-    };
-
     float minLog = symmetricLog(minimum);
     float diffLog = symmetricLog(maximum) - minLog;
 
@@ -867,58 +1548,53 @@ Task<shared_ptr<CanvasStatistics>> ImageCanvas::computeCanvasStatistics(
         return clamp((int)(NUM_BINS * (symmetricLog(val) - minLog) / diffLog), 0, NUM_BINS - 1);
     };
 
-    result->histogramZero = valToBin(0);
-
-    auto binToVal = [&](float val) {
-        return symmetricLogInverse((diffLog * val / NUM_BINS) + minLog);
-    };
-
     // In the strange case that we have 0 channels, early return, because the histogram makes no sense.
-    if (nChannels == 0) {
+    // The same applies if we've been canceled; nobody is going to look at this histogram.
+    if (nChannels == 0 || cancel.canceled()) {
         co_return result;
     }
 
-    auto numPixels = image->numPixels();
-    std::vector<int> indices(numPixels * nChannels);
-
-    vector<Task<void>> tasks;
-    for (int i = 0; i < nChannels; ++i) {
-        const auto& channel = flattened[i];
-        tasks.emplace_back(
-            ThreadPool::global().parallelForAsync<size_t>(0, numPixels, [&, i](size_t j) {
-                indices[j + i * numPixels] = valToBin(channel.eval(j));
-            }, priority)
-        );
-    }
-
-    for (auto& task : tasks) {
-        co_await task;
-    }
-
-    co_await ThreadPool::global().parallelForAsync(0, nChannels, [&](int i) {
-        for (size_t j = 0; j < numPixels; ++j) {
-            result->histogram[indices[j + i * numPixels] + i * NUM_BINS] += alphaChannel ? alphaChannel->eval(j) : 1;
+    // Each task accumulates into its own bin array; the arrays are padded to a
+    // cache-line multiple so neighboring tasks never share a line. Merging the
+    // partial histograms afterwards touches just nTasks * NUM_BINS * nChannels
+    // entries, a pittance compared to the pixel sweep itself.
+    size_t partialStride = ((size_t)NUM_BINS * nChannels + 15) / 16 * 16;
+    vector<float> partialHistograms(nTasks * partialStride);
+
+    co_await ThreadPool::global().parallelForAsync<size_t>(0, nTasks, [&](size_t t) {
+        size_t taskBegin = numPixels * t / nTasks;
+        size_t taskEnd = numPixels * (t + 1) / nTasks;
+
+        float* histogram = partialHistograms.data() + t * partialStride;
+        for (int i = 0; i < nChannels; ++i) {
+            const auto& channel = flattened[i];
+            if (alphaChannel) {
+                for (size_t j = taskBegin; j < taskEnd; ++j) {
+                    histogram[valToBin(channel.eval(j)) + i * NUM_BINS] += alphaChannel->eval(j);
+                }
+            } else {
+                for (size_t j = taskBegin; j < taskEnd; ++j) {
+                    histogram[valToBin(channel.eval(j)) + i * NUM_BINS] += 1;
+                }
+            }
         }
-    }, priority);
+    }, priority, cancel);
 
-    for (int i = 0; i < nChannels; ++i) {
-        for (int j = 0; j < NUM_BINS; ++j) {
-            result->histogram[j + i * NUM_BINS] /= binToVal(j + 1) - binToVal(j);
-        }
+    if (cancel.canceled()) {
+        co_return result;
     }
 
-    // Normalize the histogram according to the 10th-largest
-    // element to avoid a couple spikes ruining the entire graph.
-    auto tmp = result->histogram;
-    size_t idx = tmp.size() - 10;
-    nth_element(tmp.data(), tmp.data() + idx, tmp.data() + tmp.size());
-
-    float norm = 1.0f / (max(tmp[idx], 0.1f) * 1.3f);
-    for (int i = 0; i < nChannels; ++i) {
-        for (int j = 0; j < NUM_BINS; ++j) {
-            result->histogram[j + i * NUM_BINS] *= norm;
+    co_await ThreadPool::global().parallelForAsync(0, NUM_BINS * nChannels, [&](int bin) {
+        float sum = 0;
+        for (size_t t = 0; t < nTasks; ++t) {
+            sum += partialHistograms[bin + t * partialStride];
         }
-    }
+        result->histogram[bin] = sum;
+    }, priority, cancel);
+
+    // The counts stay raw here; conversion to a density and the spike
+    // normalization happen in MultiGraph, where the displayed bin edges
+    // depend on the current exposure and offset.
 
     co_return result;
 }
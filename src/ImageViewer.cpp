@@ -2,6 +2,7 @@
 // It is published under the BSD 3-Clause License within the LICENSE file.
 
 #include <tev/ImageViewer.h>
+#include <tev/Trace.h>
 
 #include <clip.h>
 
@@ -17,6 +18,7 @@
 #include <nanogui/theme.h>
 #include <nanogui/vscrollpanel.h>
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
 #include <stdexcept>
@@ -231,6 +233,34 @@ ImageViewer::ImageViewer(const shared_ptr<BackgroundImagesLoader>& imagesLoader,
         );
     }
 
+    // Colormap options for false-color visualization
+    {
+        mColorMapButtonContainer = new Widget{mSidebarLayout};
+        mColorMapButtonContainer->set_layout(new GridLayout{Orientation::Horizontal, 3, Alignment::Fill, 5, 2});
+
+        auto makeColorMapButton = [&](const string& name, function<void()> callback) {
+            auto button = new Button{mColorMapButtonContainer, name};
+            button->set_flags(Button::RadioButton);
+            button->set_font_size(15);
+            button->set_callback(callback);
+            return button;
+        };
+
+        makeColorMapButton("Turbo",   [this]() { setColorMap(EColorMap::Turbo); });
+        makeColorMapButton("Viridis", [this]() { setColorMap(EColorMap::Viridis); });
+        makeColorMapButton("Inferno", [this]() { setColorMap(EColorMap::Inferno); });
+
+        setColorMap(EColorMap::Turbo);
+
+        // Starts disabled: the initial tonemap is sRGB. setTonemap() enables
+        // the row whenever false-color is active.
+        for (auto* child : mColorMapButtonContainer->children()) {
+            dynamic_cast<Button*>(child)->set_enabled(false);
+        }
+
+        mColorMapButtonContainer->set_tooltip("Colormap used by the false-color (FC) tonemap.");
+    }
+
     // Error metrics
     {
         mMetricButtonContainer = new Widget{mSidebarLayout};
@@ -419,8 +449,7 @@ ImageViewer::ImageViewer(const shared_ptr<BackgroundImagesLoader>& imagesLoader,
             mScrollContent = new Widget{mImageScrollContainer};
             mScrollContent->set_layout(new BoxLayout{Orientation::Vertical, Alignment::Fill});
 
-            mImageButtonContainer = new Widget{mScrollContent};
-            mImageButtonContainer->set_layout(new BoxLayout{Orientation::Vertical, Alignment::Fill});
+            mImageButtonContainer = new ImageButtonContainer{mScrollContent};
         }
     }
 
@@ -703,6 +732,25 @@ bool ImageViewer::keyboard_event(int key, int scancode, int action, int modifier
                 reloadImage(mCurrentImage);
             }
             return true;
+        } else if (key == GLFW_KEY_F9) {
+            // For performance debugging: the first press starts recording
+            // trace spans, the second stops and writes a Chrome trace file.
+            if (!trace::enabled()) {
+                trace::clear();
+                trace::setEnabled(true);
+                tlog::info() << "Recording trace spans. Press F9 again to stop and dump them.";
+            } else {
+                trace::setEnabled(false);
+                auto tracePath = fs::temp_directory_path() / "tev-trace.json";
+                try {
+                    trace::dumpToFile(tracePath);
+                    tlog::success() << "Wrote trace to " << toString(tracePath)
+                                    << ". Open it in chrome://tracing or https://ui.perfetto.dev.";
+                } catch (const runtime_error& e) {
+                    tlog::error() << e.what();
+                }
+            }
+            return true;
         } else if (key == GLFW_KEY_F12) {
             // For debugging purposes.
             toggleConsole();
@@ -714,6 +762,9 @@ bool ImageViewer::keyboard_event(int key, int scancode, int action, int modifier
             mClipToLdrButton->set_pushed(!mClipToLdrButton->pushed());
             mImageCanvas->setClipToLdr(mClipToLdrButton->pushed());
             return true;
+        } else if (key == GLFW_KEY_T) {
+            mImageCanvas->setStatisticsOnVisibleRegion(!mImageCanvas->statisticsOnVisibleRegion());
+            return true;
         } else if (key == GLFW_KEY_ESCAPE) {
             setFilter("");
             return true;
@@ -926,12 +977,21 @@ void ImageViewer::draw_contents() {
         redraw();
     }
 
-    // If watching files for changes, do so every 100ms
+    // If watching files for changes, do so every 100ms. With a native
+    // filesystem watcher the directory check is event-driven and cheap when
+    // nothing changed, so it runs every frame for minimal reload latency.
     if (watchFilesForChanges()) {
+        if (mImagesLoader->hasNativeFileWatcher()) {
+            mImagesLoader->checkDirectoriesForNewFilesAndLoadThose();
+        }
+
         auto now = chrono::steady_clock::now();
         if (now - mLastFileChangesCheckTime >= 100ms) {
             reloadImagesWhoseFileChanged();
-            mImagesLoader->checkDirectoriesForNewFilesAndLoadThose();
+            if (!mImagesLoader->hasNativeFileWatcher()) {
+                mImagesLoader->checkDirectoriesForNewFilesAndLoadThose();
+            }
+
             mLastFileChangesCheckTime = now;
         }
     }
@@ -961,6 +1021,8 @@ void ImageViewer::draw_contents() {
         focusWindow();
     }
 
+    enforceMemoryBudget();
+
     // mTaskQueue contains jobs that should be executed on the main thread. It is useful for handling
     // callbacks from background threads
     while (auto task = mTaskQueue.tryPop()) {
@@ -1014,16 +1076,15 @@ void ImageViewer::draw_contents() {
 
     // Update histogram
     static const string histogramTooltipBase = "Histogram of color values. Adapts to the currently chosen channel group and error metric.";
+    mHistogram->setDisplayTransform(exposure(), offset());
     auto lazyCanvasStatistics = mImageCanvas->canvasStatistics();
     if (lazyCanvasStatistics) {
         if (lazyCanvasStatistics->isReady()) {
             auto statistics = lazyCanvasStatistics->get();
-            mHistogram->setNChannels(statistics->nChannels);
-            mHistogram->setValues(statistics->histogram);
+            mHistogram->setHistogram(statistics->histogram, statistics->nChannels, statistics->minimum, statistics->maximum);
             mHistogram->setMinimum(statistics->minimum);
             mHistogram->setMean(statistics->mean);
             mHistogram->setMaximum(statistics->maximum);
-            mHistogram->setZero(statistics->histogramZero);
             mHistogram->set_tooltip(fmt::format(
                 "{}\n\n"
                 "Minimum: {:.3f}\n"
@@ -1036,12 +1097,10 @@ void ImageViewer::draw_contents() {
             );
         }
     } else {
-        mHistogram->setNChannels(1);
-        mHistogram->setValues({0.0f});
+        mHistogram->setHistogram({}, 1, 0, 0);
         mHistogram->setMinimum(0);
         mHistogram->setMean(0);
         mHistogram->setMaximum(0);
-        mHistogram->setZero(0);
         mHistogram->set_tooltip(
             fmt::format("{}", histogramTooltipBase)
         );
@@ -1081,6 +1140,10 @@ void ImageViewer::insertImage(shared_ptr<Image> image, size_t index, bool shallS
     mImageButtonContainer->add_child((int)index, button);
     mImages.insert(begin(mImages) + index, image);
 
+    // When several images share a name, the first occurrence stays reachable,
+    // matching the first-match semantics of the former linear scan.
+    mImagesByName.emplace(image->name(), image);
+
     mShouldFooterBeVisible |= image->channelGroups().size() > 1;
     // The following call will make sure the footer becomes visible
     // if the previous line enabled it.
@@ -1166,6 +1229,17 @@ void ImageViewer::removeImage(shared_ptr<Image> image) {
     mImages.erase(begin(mImages) + id);
     mImageButtonContainer->remove_child_at(id);
 
+    auto nameIt = mImagesByName.find(image->name());
+    if (nameIt != end(mImagesByName) && nameIt->second == image) {
+        mImagesByName.erase(nameIt);
+
+        // Keep images with a duplicate name reachable, as the linear scan did.
+        auto duplicate = find_if(begin(mImages), end(mImages), [&](const auto& i) { return i->name() == image->name(); });
+        if (duplicate != end(mImages)) {
+            mImagesByName.emplace(image->name(), *duplicate);
+        }
+    }
+
     if (mImages.empty()) {
         selectImage(nullptr);
         selectReference(nullptr);
@@ -1197,6 +1271,12 @@ void ImageViewer::removeAllImages() {
         }
     }
 
+    // Images hidden by the filter survive; rebuild the name index from them.
+    mImagesByName.clear();
+    for (const auto& image : mImages) {
+        mImagesByName.emplace(image->name(), image);
+    }
+
     // No images left to select
     selectImage(nullptr);
     selectReference(nullptr);
@@ -1214,6 +1294,27 @@ void ImageViewer::replaceImage(shared_ptr<Image> image, shared_ptr<Image> replac
         return;
     }
 
+    // Progressive renders typically rewrite a file with most pixels intact,
+    // so first try patching only the changed tiles into the existing image.
+    // That keeps its textures (and their unchanged texels) alive and turns a
+    // full re-upload into a small sub-region update.
+    if (image->tryApplyDifferentialUpdate(*replacement)) {
+        image->setFileLastModified(replacement->fileLastModified());
+
+        if (shallSelect && currentId != id) {
+            selectImage(image);
+        }
+
+        // Statistics must be recomputed; same throttling as in updateImage.
+        if (image != mCurrentImage && image != mCurrentReference) {
+            image->bumpId();
+        } else {
+            mToBump.insert(image);
+        }
+
+        return;
+    }
+
     // Preserve image button caption when replacing an image
     ImageButton* ib = dynamic_cast<ImageButton*>(mImageButtonContainer->children()[id]);
     std::string caption = ib->caption();
@@ -1283,7 +1384,7 @@ void ImageViewer::updateImage(
     const string& channel,
     int x, int y,
     int width, int height,
-    const vector<float>& imageData
+    const float* imageData, int64_t stride
 ) {
     auto image = imageByName(imageName);
     if (!image) {
@@ -1291,7 +1392,7 @@ void ImageViewer::updateImage(
         return;
     }
 
-    image->updateChannel(channel, x, y, width, height, imageData);
+    image->updateChannel(channel, x, y, width, height, imageData, stride);
     if (shallSelect) {
         selectImage(image);
     }
@@ -1361,6 +1462,7 @@ void ImageViewer::selectImage(const shared_ptr<Image>& image, bool stopPlayback)
 
     mCurrentImage = image;
     mImageCanvas->setImage(mCurrentImage);
+    touchImage(image);
 
     // Clear group buttons
     while (mGroupButtonContainer->child_count() > 0) {
@@ -1411,6 +1513,109 @@ void ImageViewer::selectImage(const shared_ptr<Image>& image, bool stopPlayback)
             ));
         }
     }
+
+    prefetchNeighboringImages();
+}
+
+void ImageViewer::touchImage(const shared_ptr<Image>& image) {
+    image->setLastUsed(++mImageUseCounter);
+
+    if (image->isEvicted() && !image->evictionReloadScheduled()) {
+        image->setEvictionReloadScheduled();
+        reloadImage(image);
+    }
+}
+
+void ImageViewer::enforceMemoryBudget() {
+    if (mMemoryBudget == 0 || mImages.empty()) {
+        return;
+    }
+
+    size_t total = 0;
+    vector<shared_ptr<Image>> candidates;
+    for (auto& image : mImages) {
+        total += image->memoryUsage();
+
+        // The displayed images must stay resident, and images still staging
+        // texture data have thread-pool tasks reading their channels.
+        if (image != mCurrentImage && image != mCurrentReference && !image->isEvicted() && !image->hasStagingTextures()) {
+            candidates.emplace_back(image);
+        }
+    }
+
+    if (total <= mMemoryBudget) {
+        return;
+    }
+
+    sort(begin(candidates), end(candidates), [](const shared_ptr<Image>& a, const shared_ptr<Image>& b) {
+        return a->lastUsed() < b->lastUsed();
+    });
+
+    for (auto& image : candidates) {
+        if (total <= mMemoryBudget) {
+            break;
+        }
+
+        total -= image->memoryUsage();
+        image->evict();
+    }
+}
+
+void ImageViewer::prefetchNeighboringImages() {
+    // How far to speculate. When stepping manually, one or two images each
+    // way suffice; interleaving runs on the thread pool, so by the time the
+    // user reaches a neighbor its texture data is typically staged already.
+    // During playback, a deeper forward-only window acts as the decode-ahead
+    // ring: upcoming frames are marked most recently used (reloading them if
+    // the memory budget evicted them), so eviction trails behind the playhead
+    // while the I/O pool refills ahead of it.
+    constexpr int PREFETCH_DISTANCE = 2;
+    constexpr int PLAYBACK_DECODE_AHEAD = 8;
+
+    bool playing = playingBack();
+    int aheadDistance = playing ? PLAYBACK_DECODE_AHEAD : PREFETCH_DISTANCE;
+    int behindDistance = playing ? 0 : PREFETCH_DISTANCE;
+
+    auto prefetch = [&](const shared_ptr<Image>& image) {
+        if (!image || image == mCurrentImage) {
+            return;
+        }
+
+        // A neighbor is likely to be shown soon; bumping it reloads it now
+        // if it was evicted, rather than on selection.
+        if (playing || image->isEvicted()) {
+            touchImage(image);
+        }
+
+        if (image->isEvicted()) {
+            return;
+        }
+
+        // Request the group the canvas would display if this image were
+        // selected: the current one, or its first group as the fallback.
+        string group = mCurrentGroup;
+        if (image->channelsInGroup(group).empty() && !image->channelGroups().empty()) {
+            group = image->channelGroups().front().name;
+        }
+
+        if (!image->channelsInGroup(group).empty()) {
+            image->texture(group);
+        }
+    };
+
+    shared_ptr<Image> forward = mCurrentImage;
+    shared_ptr<Image> backward = mCurrentImage;
+    for (int i = 0; i < max(aheadDistance, behindDistance); ++i) {
+        if (i < aheadDistance) {
+            forward = nextImage(forward, Forward);
+            prefetch(forward);
+        }
+
+        if (i < behindDistance) {
+            backward = nextImage(backward, Backward);
+            prefetch(backward);
+        }
+    }
 }
 
 void ImageViewer::selectGroup(string group) {
@@ -1478,6 +1683,7 @@ void ImageViewer::selectReference(const shared_ptr<Image>& image) {
 
     mCurrentReference = image;
     mImageCanvas->setReference(mCurrentReference);
+    touchImage(image);
 
     // Ensure the currently active reference button is always fully on-screen
     Widget* activeReferenceButton = nullptr;
@@ -1529,7 +1735,7 @@ void ImageViewer::normalizeExposureAndOffset() {
         return;
     }
 
-    auto channels = mCurrentImage->channelsInGroup(mCurrentGroup);
+    const auto& channels = mCurrentImage->channelsInGroup(mCurrentGroup);
 
     float minimum = numeric_limits<float>::max();
     float maximum = numeric_limits<float>::min();
@@ -1564,6 +1770,21 @@ void ImageViewer::setTonemap(ETonemap tonemap) {
     mGammaLabel->set_color(
         tonemap == ETonemap::Gamma ? mGammaLabel->theme()->m_text_color : Color{0.5f, 1.0f}
     );
+
+    if (mColorMapButtonContainer) {
+        for (auto* child : mColorMapButtonContainer->children()) {
+            dynamic_cast<Button*>(child)->set_enabled(tonemap == ETonemap::FalseColor);
+        }
+    }
+}
+
+void ImageViewer::setColorMap(EColorMap colorMap) {
+    mImageCanvas->setColorMap(colorMap);
+    auto& buttons = mColorMapButtonContainer->children();
+    for (size_t i = 0; i < buttons.size(); ++i) {
+        Button* b = dynamic_cast<Button*>(buttons[i]);
+        b->set_pushed((EColorMap)i == colorMap);
+    }
 }
 
 void ImageViewer::setMetric(EMetric metric) {
@@ -1737,16 +1958,22 @@ void ImageViewer::saveImageDialog() {
         return;
     }
 
-    try {
-        mImageCanvas->saveImage(path);
-    } catch (const invalid_argument& e) {
-        new MessageDialog(
-            this,
-            MessageDialog::Type::Warning,
-            "Error",
-            fmt::format("Failed to save image: {}", e.what())
-        );
-    }
+    // The export runs detached on the I/O pool; failures surface as a dialog
+    // once the save task reports back.
+    invokeTaskDetached([this, path]() -> Task<void> {
+        try {
+            co_await mImageCanvas->saveImage(path);
+        } catch (const exception& e) {
+            scheduleToMainThread([this, error = string{e.what()}] {
+                new MessageDialog(
+                    this,
+                    MessageDialog::Type::Warning,
+                    "Error",
+                    fmt::format("Failed to save image: {}", error)
+                );
+            });
+        }
+    });
 
     // Make sure we gain focus after selecting a file to be loaded.
     focusWindow();
@@ -2053,12 +2280,8 @@ shared_ptr<Image> ImageViewer::nthVisibleImage(size_t n) {
 }
 
 shared_ptr<Image> ImageViewer::imageByName(const string& imageName) {
-    int id = imageId(imageName);
-    if (id != -1) {
-        return mImages[id];
-    } else {
-        return nullptr;
-    }
+    auto it = mImagesByName.find(imageName);
+    return it != end(mImagesByName) ? it->second : nullptr;
 }
 
 }
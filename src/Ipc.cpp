@@ -10,21 +10,23 @@
 
 #include <tev/Common.h>
 #include <tev/Ipc.h>
-#include <tev/ThreadPool.h>
+
+#include <zlib.h>
 
 #ifdef _WIN32
 using socklen_t = int;
 #else
 #   include <arpa/inet.h>
 #   include <cstring>
-#   ifdef EMSCRIPTEN
-#       include <fcntl.h>
-#   endif
+#   include <fcntl.h>
 #   include <netdb.h>
 #   include <netinet/in.h>
 #   include <signal.h>
 #   include <sys/file.h>
+#   include <sys/mman.h>
 #   include <sys/socket.h>
+#   include <sys/stat.h>
+#   include <sys/uio.h>
 #   include <unistd.h>
 #   define SOCKET_ERROR (-1)
 #   define INVALID_SOCKET (-1)
@@ -46,6 +48,214 @@ enum SocketError : int {
 #endif
 };
 
+// Sized such that several large tiles (or a full HD float frame) are in
+// flight at once; pages are only committed as they are touched. Updates that
+// do not fit fall back to the socket transport.
+static constexpr size_t SHM_RING_CAPACITY = (size_t)128 * 1024 * 1024;
+
+static constexpr uint32_t SHM_RING_MAGIC = 0x6d687374; // 'tshm'
+static constexpr uint32_t SHM_RING_VERSION = 1;
+
+#if !defined(_WIN32) && !defined(EMSCRIPTEN)
+static string shmPlatformName(const string& name) {
+    // POSIX shared-memory names must start with (and contain exactly one) slash.
+    return "/" + name;
+}
+#endif
+
+unique_ptr<SharedMemoryRing> SharedMemoryRing::create(const string& name, size_t capacity) {
+#if defined(EMSCRIPTEN)
+    (void)name; (void)capacity;
+    return nullptr;
+#else
+    size_t totalSize = sizeof(Header) + capacity;
+
+#   ifdef _WIN32
+    HANDLE fileMapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, (DWORD)(totalSize >> 32), (DWORD)totalSize, name.c_str());
+    if (!fileMapping) {
+        return nullptr;
+    }
+
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        CloseHandle(fileMapping);
+        return nullptr;
+    }
+
+    void* base = MapViewOfFile(fileMapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!base) {
+        CloseHandle(fileMapping);
+        return nullptr;
+    }
+#   else
+    string platformName = shmPlatformName(name);
+    int fd = shm_open(platformName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    if (ftruncate(fd, (off_t)totalSize) == -1) {
+        ::close(fd);
+        shm_unlink(platformName.c_str());
+        return nullptr;
+    }
+
+    void* base = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd); // The mapping keeps the segment alive.
+    if (base == MAP_FAILED) {
+        shm_unlink(platformName.c_str());
+        return nullptr;
+    }
+#   endif
+
+    auto* header = new (base) Header{};
+    header->magic = SHM_RING_MAGIC;
+    header->version = SHM_RING_VERSION;
+    header->capacity = capacity;
+    header->head.store(0, memory_order_relaxed);
+    header->tail.store(0, memory_order_relaxed);
+
+    unique_ptr<SharedMemoryRing> ring{new SharedMemoryRing{}};
+    ring->mName = name;
+    ring->mHeader = header;
+    ring->mData = (char*)(header + 1);
+    ring->mOwner = true;
+#   ifdef _WIN32
+    ring->mFileMapping = fileMapping;
+#   else
+    ring->mMappedSize = totalSize;
+#   endif
+    return ring;
+#endif
+}
+
+unique_ptr<SharedMemoryRing> SharedMemoryRing::open(const string& name) {
+#if defined(EMSCRIPTEN)
+    (void)name;
+    return nullptr;
+#else
+#   ifdef _WIN32
+    HANDLE fileMapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name.c_str());
+    if (!fileMapping) {
+        return nullptr;
+    }
+
+    void* base = MapViewOfFile(fileMapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    if (!base) {
+        CloseHandle(fileMapping);
+        return nullptr;
+    }
+#   else
+    string platformName = shmPlatformName(name);
+    int fd = shm_open(platformName.c_str(), O_RDWR, 0);
+    if (fd == -1) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) == -1 || (size_t)st.st_size < sizeof(Header)) {
+        ::close(fd);
+        return nullptr;
+    }
+
+    size_t totalSize = (size_t)st.st_size;
+    void* base = mmap(nullptr, totalSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) {
+        return nullptr;
+    }
+
+    // Once both ends have the segment mapped, the name is no longer needed;
+    // unlinking here guarantees cleanup even if the producer dies uncleanly.
+    shm_unlink(platformName.c_str());
+#   endif
+
+    auto* header = (Header*)base;
+    if (header->magic != SHM_RING_MAGIC || header->version != SHM_RING_VERSION) {
+#   ifdef _WIN32
+        UnmapViewOfFile(base);
+        CloseHandle(fileMapping);
+#   else
+        munmap(base, totalSize);
+#   endif
+        return nullptr;
+    }
+
+    unique_ptr<SharedMemoryRing> ring{new SharedMemoryRing{}};
+    ring->mName = name;
+    ring->mHeader = header;
+    ring->mData = (char*)(header + 1);
+    ring->mOwner = false;
+#   ifdef _WIN32
+    ring->mFileMapping = fileMapping;
+#   else
+    ring->mMappedSize = totalSize;
+#   endif
+    return ring;
+#endif
+}
+
+SharedMemoryRing::~SharedMemoryRing() {
+#if defined(EMSCRIPTEN)
+#elif defined(_WIN32)
+    if (mHeader) {
+        UnmapViewOfFile(mHeader);
+    }
+
+    if (mFileMapping) {
+        CloseHandle(mFileMapping);
+    }
+#else
+    if (mHeader) {
+        munmap(mHeader, mMappedSize);
+    }
+
+    if (mOwner) {
+        // Usually a no-op, because the consumer unlinks upon opening.
+        shm_unlink(shmPlatformName(mName).c_str());
+    }
+#endif
+}
+
+bool SharedMemoryRing::push(const void* data, size_t size, uint64_t& offset) {
+    uint64_t capacity = mHeader->capacity;
+    if (size > capacity) {
+        return false;
+    }
+
+    // Blocks are stored contiguously; if one does not fit before the end of
+    // the data area, skip the remainder. The skipped bytes are implicitly
+    // released when the consumer pops the block, since pops happen in order.
+    uint64_t start = mHeader->head.load(memory_order_relaxed);
+    uint64_t pos = start % capacity;
+    if (capacity - pos < size) {
+        start += capacity - pos;
+    }
+
+    uint64_t tail = mHeader->tail.load(memory_order_acquire);
+    if (start + size - tail > capacity) {
+        return false;
+    }
+
+    memcpy(mData + (start % capacity), data, size);
+    mHeader->head.store(start + size, memory_order_release);
+    offset = start;
+    return true;
+}
+
+const char* SharedMemoryRing::at(uint64_t offset, size_t size) const {
+    uint64_t capacity = mHeader->capacity;
+    uint64_t pos = offset % capacity;
+    if (size > capacity || capacity - pos < size || offset + size > mHeader->head.load(memory_order_acquire)) {
+        return nullptr;
+    }
+
+    return mData + pos;
+}
+
+void SharedMemoryRing::pop(uint64_t offset, size_t size) {
+    mHeader->tail.store(offset + size, memory_order_release);
+}
+
 IpcPacket::IpcPacket(const char* data, size_t length) {
     if (length <= 0) {
         throw runtime_error{"Cannot construct an IPC packet from no data."};
@@ -90,16 +300,6 @@ void IpcPacket::setUpdateImage(const string& imageName, bool grabFocus, const ve
         channelStrides[i] = channelDescs[i].stride;
     }
 
-    OStream payload{mPayload};
-    payload << EType::UpdateImageV3;
-    payload << grabFocus;
-    payload << imageName;
-    payload << nChannels;
-    payload << channelNames;
-    payload << x << y << width << height;
-    payload << channelOffsets;
-    payload << channelStrides;
-
     size_t nPixels = width * height;
 
     size_t stridedImageDataSize = 0;
@@ -111,7 +311,28 @@ void IpcPacket::setUpdateImage(const string& imageName, bool grabFocus, const ve
         throw runtime_error{fmt::format("UpdateImage IPC packet's data size does not match specified dimensions, offset, and stride. (Expected: {})", stridedImageDataSize)};
     }
 
-    payload << stridedImageData;
+    size_t headerSize = sizeof(EType) + 1 /* grabFocus */ + imageName.size() + 1 + sizeof(nChannels) + 4 * sizeof(int32_t) + nChannels * 2 * sizeof(int64_t);
+    for (int32_t i = 0; i < nChannels; ++i) {
+        headerSize += channelNames[i].size() + 1;
+    }
+
+    OStream payload{mPayload};
+    payload.reserve(headerSize);
+    payload << EType::UpdateImageV3;
+    payload << grabFocus;
+    payload << imageName;
+    payload << nChannels;
+    payload << channelNames;
+    payload << x << y << width << height;
+    payload << channelOffsets;
+    payload << channelStrides;
+
+    // The pixel block is not copied into the payload; it is recorded as an
+    // auxiliary segment that sendToPrimaryInstance() scatter-gathers into the
+    // same send. The receiving end sees an identical byte stream, so the size
+    // prefix must cover both segments.
+    mAuxiliaryPayload = {(const char*)stridedImageData.data(), stridedImageData.size() * sizeof(float)};
+    *(uint32_t*)mPayload.data() = (uint32_t)(mPayload.size() + mAuxiliaryPayload.size());
 }
 
 void IpcPacket::setCreateImage(const string& imageName, bool grabFocus, int32_t width, int32_t height, int32_t nChannels, const vector<string>& channelNames) {
@@ -141,6 +362,109 @@ void IpcPacket::setVectorGraphics(const string& imageName, bool grabFocus, bool
     }
 }
 
+IpcPacket IpcPacket::toShmReference(const string& ringName, uint64_t ringOffset) const {
+    if (type() != EType::UpdateImageV3 || mAuxiliaryPayload.empty()) {
+        throw runtime_error{"Only UpdateImage packets with an auxiliary pixel block can reference shared memory."};
+    }
+
+    IpcPacket result;
+    OStream payload{result.mPayload};
+    payload << EType::UpdateImageShm;
+    payload << ringName;
+    payload << ringOffset;
+    payload << (uint64_t)mAuxiliaryPayload.size();
+
+    // The serialized header past the size prefix and type byte is laid out
+    // exactly like UpdateImageV3's; only the pixel block stays behind in
+    // shared memory.
+    vector<char> header{mPayload.begin() + 5, mPayload.end()};
+    payload << header;
+    return result;
+}
+
+// Packets below this size are sent uncompressed even on remote connections;
+// deflate overhead only pays off for large pixel payloads.
+static constexpr size_t COMPRESSION_THRESHOLD_BYTES = 64 * 1024;
+
+IpcPacket IpcPacket::compress() const {
+    IpcPacket result;
+    uint32_t uncompressedSize = (uint32_t)(mPayload.size() + mAuxiliaryPayload.size());
+
+    OStream payload{result.mPayload};
+    payload << EType::CompressedPacket;
+    payload << uncompressedSize;
+
+    z_stream stream = {};
+    if (deflateInit(&stream, Z_BEST_SPEED) != Z_OK) {
+        throw runtime_error{"Failed to initialize deflate stream."};
+    }
+
+    ScopeGuard streamGuard{[&stream] { deflateEnd(&stream); }};
+
+    size_t headerSize = result.mPayload.size();
+    result.mPayload.resize(headerSize + deflateBound(&stream, uncompressedSize));
+    stream.next_out = (Bytef*)(result.mPayload.data() + headerSize);
+    stream.avail_out = (uInt)(result.mPayload.size() - headerSize);
+
+    // The payload and the auxiliary segment are fed to deflate back to back;
+    // they never need to be concatenated in memory.
+    stream.next_in = (Bytef*)mPayload.data();
+    stream.avail_in = (uInt)mPayload.size();
+    int zlibResult = deflate(&stream, mAuxiliaryPayload.empty() ? Z_FINISH : Z_NO_FLUSH);
+    if (!mAuxiliaryPayload.empty()) {
+        if (zlibResult != Z_OK) {
+            throw runtime_error{"Failed to compress IPC packet payload."};
+        }
+
+        stream.next_in = (Bytef*)mAuxiliaryPayload.data();
+        stream.avail_in = (uInt)mAuxiliaryPayload.size();
+        zlibResult = deflate(&stream, Z_FINISH);
+    }
+
+    if (zlibResult != Z_STREAM_END) {
+        throw runtime_error{"Failed to compress IPC packet payload."};
+    }
+
+    result.mPayload.resize(headerSize + stream.total_out);
+    *(uint32_t*)result.mPayload.data() = (uint32_t)result.mPayload.size();
+    return result;
+}
+
+IpcPacket IpcPacket::decompress() const {
+    IStream payload{mPayload};
+
+    EType type;
+    payload >> type;
+    if (type != EType::CompressedPacket) {
+        throw runtime_error{"Cannot decompress an IPC packet that is not a CompressedPacket."};
+    }
+
+    uint32_t uncompressedSize;
+    payload >> uncompressedSize;
+    if (uncompressedSize == 0) {
+        throw runtime_error{"CompressedPacket must have a non-zero uncompressed size."};
+    }
+
+    vector<char> data(uncompressedSize);
+
+    z_stream stream = {};
+    if (inflateInit(&stream) != Z_OK) {
+        throw runtime_error{"Failed to initialize inflate stream."};
+    }
+
+    ScopeGuard streamGuard{[&stream] { inflateEnd(&stream); }};
+
+    stream.next_in = (Bytef*)payload.get();
+    stream.avail_in = (uInt)payload.remainingBytes();
+    stream.next_out = (Bytef*)data.data();
+    stream.avail_out = (uInt)data.size();
+    if (inflate(&stream, Z_FINISH) != Z_STREAM_END || stream.total_out != uncompressedSize) {
+        throw runtime_error{"Failed to decompress IPC packet payload."};
+    }
+
+    return IpcPacket{data.data(), data.size()};
+}
+
 IpcPacketOpenImage IpcPacket::interpretAsOpenImage() const {
     IpcPacketOpenImage result;
     IStream payload{mPayload};
@@ -212,10 +536,17 @@ IpcPacketUpdateImage IpcPacket::interpretAsUpdateImage() const {
 
     EType type;
     payload >> type;
-    if (type != EType::UpdateImage && type != EType::UpdateImageV2 && type != EType::UpdateImageV3) {
+    if (type != EType::UpdateImage && type != EType::UpdateImageV2 && type != EType::UpdateImageV3 && type != EType::UpdateImageShm) {
         throw runtime_error{"Cannot interpret IPC packet as UpdateImage."};
     }
 
+    if (type == EType::UpdateImageShm) {
+        payload >> result.shmRingName;
+        payload >> result.shmOffset;
+        payload >> result.shmSize;
+        // The remaining fields follow the UpdateImageV3 layout.
+    }
+
     payload >> result.grabFocus;
     payload >> result.imageName;
 
@@ -245,26 +576,29 @@ IpcPacketUpdateImage IpcPacket::interpretAsUpdateImage() const {
         }
     }
 
-    result.imageData.resize(result.nChannels);
-    for (int32_t i = 0; i < result.nChannels; ++i) {
-        result.imageData[i].resize(nPixels);
-    }
-
     size_t stridedImageDataSize = 0;
     for (int32_t c = 0; c < result.nChannels; ++c) {
         stridedImageDataSize = max(stridedImageDataSize, (size_t)(result.channelOffsets[c] + (nPixels-1) * result.channelStrides[c] + 1));
     }
 
+    if (type == EType::UpdateImageShm) {
+        // The pixel block lives in a shared-memory ring; the receiver
+        // resolves it against the ring announced by shmRingName.
+        if (result.shmSize < stridedImageDataSize * sizeof(float)) {
+            throw runtime_error{"UpdateImage: insufficient image data."};
+        }
+
+        return result;
+    }
+
     if (payload.remainingBytes() < stridedImageDataSize * sizeof(float)) {
         throw runtime_error{"UpdateImage: insufficient image data."};
     }
 
-    const float* stridedImageData = (const float*)payload.get();
-    ThreadPool::global().parallelFor<size_t>(0, nPixels, [&](size_t px) {
-        for (int32_t c = 0; c < result.nChannels; ++c) {
-            result.imageData[c][px] = stridedImageData[result.channelOffsets[c] + px * result.channelStrides[c]];
-        }
-    }, numeric_limits<int>::max());
+    // The strided pixel block is handed out as a view into the payload; the
+    // consumer reads it in place rather than de-striding it into per-channel
+    // copies here.
+    result.stridedImageData = {(const float*)payload.get(), stridedImageDataSize};
 
     return result;
 }
@@ -522,46 +856,185 @@ void Ipc::sendToPrimaryInstance(const IpcPacket& message) {
         throw runtime_error{"Must be a secondary instance to send to the primary instance."};
     }
 
-    int bytesSent = send(mSocketFd, message.data(), (int)message.size(), 0 /* flags */);
-    if (bytesSent != int(message.size())) {
-        throw runtime_error{fmt::format("send() failed: {}", errorString(lastSocketError()))};
+    // Large packets crossing the network are compressed; float pixel data is
+    // what saturates a LAN link, and it deflates well. Loopback traffic skips
+    // this and goes through shared memory or the raw socket instead.
+    if (!isLoopback() && message.type() != IpcPacket::CompressedPacket &&
+        message.size() + message.auxiliaryPayload().size() >= COMPRESSION_THRESHOLD_BYTES) {
+        IpcPacket compressed = message.compress();
+        if (compressed.size() < message.size() + message.auxiliaryPayload().size()) {
+            sendToPrimaryInstance(compressed);
+            return;
+        }
+
+        // Incompressible data is sent as-is.
+    }
+
+    auto auxiliary = message.auxiliaryPayload();
+    if (auxiliary.empty()) {
+        int bytesSent = send(mSocketFd, message.data(), (int)message.size(), 0 /* flags */);
+        if (bytesSent != int(message.size())) {
+            throw runtime_error{fmt::format("send() failed: {}", errorString(lastSocketError()))};
+        }
+
+        return;
+    }
+
+    // When the primary instance runs on the same host, pixel blocks go
+    // through a shared-memory ring and the socket only carries a small
+    // control message referencing them.
+    if (isLoopback() && message.type() == IpcPacket::UpdateImageV3) {
+        if (!mShmRing && !mShmRingCreationFailed) {
+#ifdef _WIN32
+            uint32_t pid = (uint32_t)GetCurrentProcessId();
+#else
+            uint32_t pid = (uint32_t)getpid();
+#endif
+            mShmRing = SharedMemoryRing::create(fmt::format("tev-shm-{}-{}", mPort, pid), SHM_RING_CAPACITY);
+            mShmRingCreationFailed = !mShmRing;
+            if (mShmRingCreationFailed) {
+                tlog::warning() << "Could not create shared-memory ring; falling back to socket transport.";
+            }
+        }
+
+        uint64_t ringOffset;
+        if (mShmRing && mShmRing->push(auxiliary.data(), auxiliary.size(), ringOffset)) {
+            sendToPrimaryInstance(message.toShmReference(mShmRing->name(), ringOffset));
+            return;
+        }
+
+        // Ring unavailable or currently full; fall through to the socket path.
+    }
+
+    // Packets with an auxiliary segment (large pixel blocks) are sent via
+    // scatter-gather I/O such that the two segments never need to be
+    // concatenated in memory.
+    size_t totalSize = message.size() + auxiliary.size();
+#ifdef _WIN32
+    WSABUF buffers[2];
+    buffers[0].buf = const_cast<char*>(message.data());
+    buffers[0].len = (ULONG)message.size();
+    buffers[1].buf = const_cast<char*>(auxiliary.data());
+    buffers[1].len = (ULONG)auxiliary.size();
+
+    DWORD bytesSent = 0;
+    if (WSASend(mSocketFd, buffers, 2, &bytesSent, 0 /* flags */, nullptr, nullptr) == SOCKET_ERROR || (size_t)bytesSent != totalSize) {
+        throw runtime_error{fmt::format("WSASend() failed: {}", errorString(lastSocketError()))};
+    }
+#else
+    struct iovec iov[2];
+    iov[0].iov_base = const_cast<char*>(message.data());
+    iov[0].iov_len = message.size();
+    iov[1].iov_base = const_cast<char*>(auxiliary.data());
+    iov[1].iov_len = auxiliary.size();
+
+    ssize_t bytesSent = writev(mSocketFd, iov, 2);
+    if (bytesSent != (ssize_t)totalSize) {
+        throw runtime_error{fmt::format("writev() failed: {}", errorString(lastSocketError()))};
     }
+#endif
 }
 
-void Ipc::receiveFromSecondaryInstance(function<void(const IpcPacket&)> callback) {
+void Ipc::receiveFromSecondaryInstance(function<void(IpcPacket)> callback) {
     if (!mIsPrimaryInstance) {
         throw runtime_error{"Must be the primary instance to receive from a secondary instance."};
     }
 
-    // Check for new connections.
-    struct sockaddr_in client;
-    socklen_t addrlen = sizeof(client);
-    socket_t fd = accept(mSocketFd, (struct sockaddr*)&client, &addrlen);
-    if (fd == INVALID_SOCKET) {
-        int errorId = lastSocketError();
-        if (errorId == SocketError::WouldBlock) {
-            // no problem; no one is trying to connect
+    // Without readiness information from a preceding waitForData() call,
+    // conservatively poll everything.
+    bool serviceAll = !mReadinessValid;
+
+    // Check for new connections, but only when the listen socket is ready.
+    if (serviceAll || FD_ISSET(mSocketFd, &mReadyFds)) {
+        struct sockaddr_in client;
+        socklen_t addrlen = sizeof(client);
+        socket_t fd = accept(mSocketFd, (struct sockaddr*)&client, &addrlen);
+        if (fd == INVALID_SOCKET) {
+            int errorId = lastSocketError();
+            if (errorId == SocketError::WouldBlock) {
+                // no problem; no one is trying to connect
+            } else {
+                tlog::warning() << "accept() error: " << errorId << " " << errorString(errorId);
+            }
         } else {
-            tlog::warning() << "accept() error: " << errorId << " " << errorString(errorId);
+            uint32_t ip = ntohl(client.sin_addr.s_addr);
+            uint16_t port = ntohs(client.sin_port);
+            auto name = fmt::format("{}.{}.{}.{}:{}", ip >> 24, (ip >> 16) & 0xff, (ip >> 8) & 0xff, ip & 0xff, port);
+            tlog::info() << fmt::format("Client {} (#{}) connected", name, fd);
+            mSocketConnections.push_back(SocketConnection{fd, name});
         }
-    } else {
-        uint32_t ip = ntohl(client.sin_addr.s_addr);
-        uint16_t port = ntohs(client.sin_port);
-        auto name = fmt::format("{}.{}.{}.{}:{}", ip >> 24, (ip >> 16) & 0xff, (ip >> 8) & 0xff, ip & 0xff, port);
-        tlog::info() << fmt::format("Client {} (#{}) connected", name, fd);
-        mSocketConnections.push_back(SocketConnection{fd, name});
     }
 
-    // Service existing connections.
+    // Service only the connections the kernel reported as readable. Each
+    // service call reads at most one buffer's worth of data, so a chatty
+    // connection cannot starve the others within a pass; its remaining data
+    // keeps the socket readable and the next wakeup is immediate.
     for (auto iter = mSocketConnections.begin(); iter != mSocketConnections.end();) {
         auto cur = iter++;
-        cur->service(callback);
+        if (serviceAll || FD_ISSET(cur->fd(), &mReadyFds)) {
+            cur->service(callback);
+        }
 
         // If the connection became closed, stop keeping track of it.
         if (cur->isClosed()) {
             mSocketConnections.erase(cur);
         }
     }
+
+    // Rotate the servicing order so no connection is persistently favored.
+    if (!mSocketConnections.empty()) {
+        mSocketConnections.splice(mSocketConnections.end(), mSocketConnections, mSocketConnections.begin());
+    }
+
+    mReadinessValid = false;
+}
+
+SharedMemoryRing* Ipc::openShmRing(const string& name) {
+    auto it = mOpenedShmRings.find(name);
+    if (it == mOpenedShmRings.end()) {
+        auto ring = SharedMemoryRing::open(name);
+        if (!ring) {
+            tlog::warning() << "Could not open shared-memory ring " << name << "; dropping its image updates.";
+        }
+
+        it = mOpenedShmRings.emplace(name, std::move(ring)).first;
+    }
+
+    return it->second.get();
+}
+
+void Ipc::waitForData(chrono::milliseconds timeout) {
+    if (!mIsPrimaryInstance) {
+        throw runtime_error{"Must be the primary instance to wait for data from a secondary instance."};
+    }
+
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(mSocketFd, &fds);
+
+    socket_t maxFd = mSocketFd;
+    for (const auto& connection : mSocketConnections) {
+        if (!connection.isClosed()) {
+            FD_SET(connection.fd(), &fds);
+            maxFd = max(maxFd, connection.fd());
+        }
+    }
+
+    timeval tv;
+    tv.tv_sec = (long)(timeout.count() / 1000);
+    tv.tv_usec = (long)((timeout.count() % 1000) * 1000);
+
+    // The first argument is ignored on Windows, but required on POSIX systems.
+    if (select((int)maxFd + 1, &fds, nullptr, nullptr, &tv) == SOCKET_ERROR) {
+        tlog::warning() << "select() error: " << errorString(lastSocketError());
+        mReadinessValid = false;
+        return;
+    }
+
+    // Remember which sockets are actually readable such that the next call to
+    // receiveFromSecondaryInstance() only touches those.
+    mReadyFds = fds;
+    mReadinessValid = true;
 }
 
 Ipc::SocketConnection::SocketConnection(Ipc::socket_t fd, const string& name)
@@ -575,72 +1048,73 @@ Ipc::SocketConnection::SocketConnection(Ipc::socket_t fd, const string& name)
     mBuffer.resize(1024 * 1024);
 }
 
-void Ipc::SocketConnection::service(function<void(const IpcPacket&)> callback) {
+void Ipc::SocketConnection::service(function<void(IpcPacket)> callback) {
     if (isClosed()) {
         // Client disconnected, so don't bother.
         return;
     }
 
-    while (true) {
-        // Receive as much data as we can, up to the capacity of 'mBuffer'.
-        size_t maxBytes = mBuffer.size() - mRecvOffset;
-        int bytesReceived = recv(mSocketFd, mBuffer.data() + mRecvOffset, (int)maxBytes, 0);
-        if (bytesReceived == SOCKET_ERROR) {
-            int errorId = lastSocketError();
-            // no more data; this is fine.
-            if (errorId == SocketError::Again || errorId == SocketError::WouldBlock) {
-                break;
-            } else {
-                tlog::warning() << "Error while reading from socket. " << errorString(errorId) << " Connection terminated.";
-                close();
-                return;
-            }
-        }
-
-        TEV_ASSERT(bytesReceived >= 0, "With no error, the number of bytes received should be positive.");
-        mRecvOffset += (size_t)bytesReceived;
-
-        // Since we aren't getting annoying SIGPIPE signals when a client
-        // disconnects, a zero-byte read here is how we know when that happens.
-        if (bytesReceived == 0) {
-            tlog::info() << "Client " << mName << " (#" << mSocketFd << ") disconnected";
+    // Receive at most one buffer's worth of data per call. Draining the
+    // socket completely here would let a single chatty connection starve the
+    // others; leftover data keeps the socket readable, so the caller's next
+    // readiness wakeup returns immediately and servicing resumes.
+    size_t maxBytes = mBuffer.size() - mRecvOffset;
+    int bytesReceived = recv(mSocketFd, mBuffer.data() + mRecvOffset, (int)maxBytes, 0);
+    if (bytesReceived == SOCKET_ERROR) {
+        int errorId = lastSocketError();
+        // no more data; this is fine.
+        if (errorId == SocketError::Again || errorId == SocketError::WouldBlock) {
+            return;
+        } else {
+            tlog::warning() << "Error while reading from socket. " << errorString(errorId) << " Connection terminated.";
             close();
             return;
         }
+    }
 
-        // Go through the buffer and service as many complete messages as
-        // we can find.
-        size_t processedOffset = 0;
-        while (processedOffset + 4 <= mRecvOffset) {
-            // There's at least enough to figure out the next message's length.
-            const char* messagePtr = mBuffer.data() + processedOffset;
-            uint32_t messageLength = *((uint32_t*)messagePtr);
-
-            if (messageLength > mBuffer.size()) {
-                mBuffer.resize(messageLength);
-                break;
-            }
+    TEV_ASSERT(bytesReceived >= 0, "With no error, the number of bytes received should be positive.");
+    mRecvOffset += (size_t)bytesReceived;
 
-            if (processedOffset + messageLength <= mRecvOffset) {
-                // We have a full message.
-                callback(IpcPacket{messagePtr, messageLength});
-                processedOffset += messageLength;
-            } else {
-                // It's a partial message; we'll need to recv() more.
-                break;
-            }
+    // Since we aren't getting annoying SIGPIPE signals when a client
+    // disconnects, a zero-byte read here is how we know when that happens.
+    if (bytesReceived == 0) {
+        tlog::info() << "Client " << mName << " (#" << mSocketFd << ") disconnected";
+        close();
+        return;
+    }
+
+    // Go through the buffer and service as many complete messages as
+    // we can find.
+    size_t processedOffset = 0;
+    while (processedOffset + 4 <= mRecvOffset) {
+        // There's at least enough to figure out the next message's length.
+        const char* messagePtr = mBuffer.data() + processedOffset;
+        uint32_t messageLength = *((uint32_t*)messagePtr);
+
+        if (messageLength > mBuffer.size()) {
+            mBuffer.resize(messageLength);
+            break;
         }
 
-        // TODO: we could save the memcpy by treating 'buffer' as a ring-buffer,
-        // but it's probably not worth the trouble. Revisit when someone throws around
-        // buffers with a size of gigabytes.
-        if (processedOffset > 0) {
-            // There's a partial message; copy it to the start of 'buffer'
-            // and update the offsets accordingly.
-            memmove(mBuffer.data(), mBuffer.data() + processedOffset, mRecvOffset - processedOffset);
-            mRecvOffset -= processedOffset;
+        if (processedOffset + messageLength <= mRecvOffset) {
+            // We have a full message.
+            callback(IpcPacket{messagePtr, messageLength});
+            processedOffset += messageLength;
+        } else {
+            // It's a partial message; we'll need to recv() more.
+            break;
         }
     }
+
+    // TODO: we could save the memcpy by treating 'buffer' as a ring-buffer,
+    // but it's probably not worth the trouble. Revisit when someone throws around
+    // buffers with a size of gigabytes.
+    if (processedOffset > 0) {
+        // There's a partial message; copy it to the start of 'buffer'
+        // and update the offsets accordingly.
+        memmove(mBuffer.data(), mBuffer.data() + processedOffset, mRecvOffset - processedOffset);
+        mRecvOffset -= processedOffset;
+    }
 }
 
 void Ipc::SocketConnection::close() {
@@ -0,0 +1,281 @@
+// This file was developed by Thomas Müller <thomas94@gmx.net>.
+// It is published under the BSD 3-Clause License within the LICENSE file.
+
+// Headless benchmark harness for tev's IPC stack. Run one instance with
+// --serve to act as a synthetic primary instance, then stream tiles at it
+// from a second instance:
+//
+//     tev-ipc-bench --serve
+//     tev-ipc-bench --width 3840 --height 2160 --tile 256 --frames 100
+//
+// The server reports packets/sec, MB/s, and per-packet latency percentiles
+// from receipt to the strided copy into its channel buffers — the same work
+// Image::updateChannel performs — once per second. Pointing the client at a
+// remote host additionally exercises the compressed transport; on the same
+// host, the shared-memory ring is used automatically.
+
+#include <tev/Ipc.h>
+
+#include <args.hxx>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace args;
+using namespace std;
+
+namespace tev {
+
+// A deliberately non-clashing default port such that benchmarks can run next
+// to a regular tev instance.
+static const char* DEFAULT_HOSTNAME = "127.0.0.1:14159";
+
+namespace {
+
+// Destination buffers standing in for an image's channels. Grown lazily to
+// fit whatever region the client updates.
+struct BenchImage {
+    int width = 0, height = 0;
+    vector<vector<float>> channels;
+
+    void fit(int right, int bottom, int nChannels) {
+        if (right <= width && bottom <= height && (size_t)nChannels <= channels.size()) {
+            return;
+        }
+
+        width = max(width, right);
+        height = max(height, bottom);
+        channels.resize(max(channels.size(), (size_t)nChannels));
+        for (auto& channel : channels) {
+            channel.resize((size_t)width * height);
+        }
+    }
+};
+
+void applyUpdate(IpcPacket packet, Ipc& ipc, BenchImage& image) {
+    auto info = packet.interpretAsUpdateImage();
+
+    SharedMemoryRing* ring = nullptr;
+    span<const float> pixels = info.stridedImageData;
+    if (packet.type() == IpcPacket::UpdateImageShm) {
+        ring = ipc.openShmRing(string{info.shmRingName});
+        const char* shmData = ring ? ring->at(info.shmOffset, info.shmSize) : nullptr;
+        if (!shmData) {
+            return;
+        }
+
+        pixels = {(const float*)shmData, (size_t)(info.shmSize / sizeof(float))};
+    }
+
+    image.fit(info.x + info.width, info.y + info.height, info.nChannels);
+
+    // The same strided tile copy Channel::updateTile performs.
+    for (int c = 0; c < info.nChannels; ++c) {
+        const float* src = pixels.data() + info.channelOffsets[c];
+        int64_t stride = info.channelStrides[c];
+        for (int posY = 0; posY < info.height; ++posY) {
+            float* dst = &image.channels[c][(size_t)(info.y + posY) * image.width + info.x];
+            const float* srcRow = src + (int64_t)posY * info.width * stride;
+            for (int posX = 0; posX < info.width; ++posX) {
+                dst[posX] = srcRow[posX * stride];
+            }
+        }
+    }
+
+    if (ring) {
+        ring->pop(info.shmOffset, info.shmSize);
+    }
+}
+
+int serve(const string& hostname) {
+    Ipc ipc{hostname};
+    if (!ipc.isPrimaryInstance()) {
+        tlog::error() << "Another instance is already serving on " << hostname;
+        return 1;
+    }
+
+    BenchImage image;
+    vector<double> latenciesMs;
+    size_t numPackets = 0;
+    size_t numBytes = 0;
+
+    auto lastReport = chrono::steady_clock::now();
+    tlog::info() << "Serving on " << hostname << "; waiting for a client...";
+
+    while (true) {
+        ipc.receiveFromSecondaryInstance([&](IpcPacket packet) {
+            auto receiptTime = chrono::steady_clock::now();
+            numBytes += packet.size();
+
+            try {
+                if (packet.type() == IpcPacket::CompressedPacket) {
+                    packet = packet.decompress();
+                }
+
+                switch (packet.type()) {
+                    case IpcPacket::UpdateImage:
+                    case IpcPacket::UpdateImageV2:
+                    case IpcPacket::UpdateImageV3:
+                    case IpcPacket::UpdateImageShm:
+                        applyUpdate(std::move(packet), ipc, image);
+                        break;
+
+                    default:
+                        // Anything else (e.g. CreateImage) merely counts towards throughput.
+                        break;
+                }
+            } catch (const runtime_error& e) {
+                tlog::warning() << "Malformed packet: " << e.what();
+                return;
+            }
+
+            latenciesMs.push_back(chrono::duration<double, milli>{chrono::steady_clock::now() - receiptTime}.count());
+            ++numPackets;
+        });
+
+        ipc.waitForData(100ms);
+
+        auto now = chrono::steady_clock::now();
+        double elapsedSeconds = chrono::duration<double>{now - lastReport}.count();
+        if (elapsedSeconds >= 1.0 && numPackets > 0) {
+            sort(latenciesMs.begin(), latenciesMs.end());
+            auto percentile = [&](double p) { return latenciesMs[min(latenciesMs.size() - 1, (size_t)(p * latenciesMs.size()))]; };
+
+            tlog::info() << fmt::format(
+                "{:8.0f} packets/s {:8.1f} MB/s   latency p50 {:.3f} ms, p90 {:.3f} ms, p99 {:.3f} ms, max {:.3f} ms",
+                numPackets / elapsedSeconds,
+                numBytes / elapsedSeconds / (1024.0 * 1024.0),
+                percentile(0.50), percentile(0.90), percentile(0.99), latenciesMs.back()
+            );
+
+            latenciesMs.clear();
+            numPackets = 0;
+            numBytes = 0;
+            lastReport = now;
+        }
+    }
+}
+
+int stream(const string& hostname, int width, int height, int nChannels, int tileSize, int numFrames, double packetsPerSecond) {
+    Ipc ipc{hostname};
+    if (ipc.isPrimaryInstance()) {
+        tlog::error() << "No server to connect to on " << hostname << "; start one with --serve first.";
+        return 1;
+    }
+
+    static const vector<string> RGBA_NAMES = {"R", "G", "B", "A"};
+    vector<string> channelNames;
+    for (int c = 0; c < nChannels; ++c) {
+        channelNames.push_back(c < (int)RGBA_NAMES.size() ? RGBA_NAMES[c] : fmt::format("C{}", c));
+    }
+
+    IpcPacket createPacket;
+    createPacket.setCreateImage("ipc-bench", false, width, height, nChannels, channelNames);
+    ipc.sendToPrimaryInstance(createPacket);
+
+    vector<IpcPacket::ChannelDesc> channelDescs;
+    for (int c = 0; c < nChannels; ++c) {
+        channelDescs.push_back({channelNames[c], c, nChannels});
+    }
+
+    vector<float> tileData;
+    size_t numPackets = 0;
+    size_t numBytes = 0;
+
+    auto benchBegin = chrono::steady_clock::now();
+    auto nextSendTime = benchBegin;
+    chrono::duration<double> sendInterval{packetsPerSecond > 0 ? 1.0 / packetsPerSecond : 0.0};
+
+    for (int frame = 0; frame < numFrames; ++frame) {
+        for (int y = 0; y < height; y += tileSize) {
+            for (int x = 0; x < width; x += tileSize) {
+                int tileWidth = min(tileSize, width - x);
+                int tileHeight = min(tileSize, height - y);
+
+                tileData.resize((size_t)tileWidth * tileHeight * nChannels);
+                for (size_t i = 0; i < tileData.size(); ++i) {
+                    tileData[i] = (float)((i + frame) % 256) / 255.0f;
+                }
+
+                IpcPacket packet;
+                packet.setUpdateImage("ipc-bench", false, channelDescs, x, y, tileWidth, tileHeight, tileData);
+                ipc.sendToPrimaryInstance(packet);
+
+                ++numPackets;
+                numBytes += packet.size() + packet.auxiliaryPayload().size();
+
+                if (sendInterval.count() > 0) {
+                    nextSendTime += chrono::duration_cast<chrono::steady_clock::duration>(sendInterval);
+                    this_thread::sleep_until(nextSendTime);
+                }
+            }
+        }
+    }
+
+    double elapsedSeconds = chrono::duration<double>{chrono::steady_clock::now() - benchBegin}.count();
+    tlog::success() << fmt::format(
+        "Sent {} packets ({:.1f} MB) in {:.2f} s: {:.0f} packets/s, {:.1f} MB/s",
+        numPackets,
+        numBytes / (1024.0 * 1024.0),
+        elapsedSeconds,
+        numPackets / elapsedSeconds,
+        numBytes / elapsedSeconds / (1024.0 * 1024.0)
+    );
+
+    return 0;
+}
+
+int mainFunc(int argc, char* argv[]) {
+    ArgumentParser parser{
+        "Benchmark harness for tev's IPC stack.",
+        "Run one instance with --serve, then stream tiles at it from another instance.",
+    };
+
+    Flag serveFlag{parser, "SERVE", "Act as the receiving end and report throughput/latency statistics.", {"serve"}};
+    ValueFlag<string> hostnameFlag{parser, "HOSTNAME", fmt::format("Host and port to serve or connect on. Default is {}.", DEFAULT_HOSTNAME), {"hostname"}};
+    ValueFlag<int> widthFlag{parser, "WIDTH", "Width of the synthetic image. Default is 1920.", {"width"}};
+    ValueFlag<int> heightFlag{parser, "HEIGHT", "Height of the synthetic image. Default is 1080.", {"height"}};
+    ValueFlag<int> channelsFlag{parser, "CHANNELS", "Number of interleaved channels. Default is 4.", {"channels"}};
+    ValueFlag<int> tileFlag{parser, "TILE", "Tile side length in pixels. Default is 256.", {"tile"}};
+    ValueFlag<int> framesFlag{parser, "FRAMES", "Number of full frames to stream. Default is 100.", {"frames"}};
+    ValueFlag<double> rateFlag{parser, "RATE", "Target packets per second; 0 streams as fast as possible. Default is 0.", {"rate"}};
+    HelpFlag helpFlag{parser, "HELP", "Display this help menu.", {'h', "help"}};
+
+    try {
+        parser.ParseCLI(argc, argv);
+    } catch (const Help&) {
+        std::cout << parser;
+        return 0;
+    } catch (const ParseError& e) {
+        std::cerr << e.what() << std::endl << parser;
+        return 1;
+    }
+
+    string hostname = hostnameFlag ? get(hostnameFlag) : DEFAULT_HOSTNAME;
+    if (serveFlag) {
+        return serve(hostname);
+    }
+
+    return stream(
+        hostname,
+        widthFlag ? get(widthFlag) : 1920,
+        heightFlag ? get(heightFlag) : 1080,
+        channelsFlag ? get(channelsFlag) : 4,
+        tileFlag ? get(tileFlag) : 256,
+        framesFlag ? get(framesFlag) : 100,
+        rateFlag ? get(rateFlag) : 0.0
+    );
+}
+
+} // namespace tev
+
+int main(int argc, char* argv[]) {
+    try {
+        return tev::mainFunc(argc, argv);
+    } catch (const std::runtime_error& e) {
+        tlog::error() << e.what();
+        return 1;
+    }
+}
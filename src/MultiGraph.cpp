@@ -8,7 +8,9 @@
 #include <nanogui/theme.h>
 #include <nanogui/opengl.h>
 
+#include <algorithm>
 #include <array>
+#include <cmath>
 
 using namespace nanogui;
 using namespace std;
@@ -26,9 +28,169 @@ Vector2i MultiGraph::preferred_size(NVGcontext *) const {
     return Vector2i(180, 80);
 }
 
+void MultiGraph::updateHistogram() {
+    if (!mHistogramDirty) {
+        return;
+    }
+    mHistogramDirty = false;
+
+    // Displayed resolution; the base histogram is finer so that re-binning
+    // under an arbitrary exposure/offset does not visibly quantize.
+    static const int NUM_BINS = 400;
+
+    int nBaseBins = mNChannels > 0 ? (int)(mBaseHistogram.size() / mNChannels) : 0;
+    if (nBaseBins == 0) {
+        mValues.assign(1, 0.0f);
+        mZeroBin = 0;
+        mGeometryDirty = true;
+        return;
+    }
+
+    // The same symmetric-log warp the statistics pass used to fill the base
+    // bins over [mHistogramMin, mHistogramMax].
+    static const float addition = 0.001f;
+    static const float smallest = log(addition);
+    auto symmetricLog = [](float val) {
+        return val > 0 ? (log(val + addition) - smallest) : -(log(-val + addition) - smallest);
+    };
+    auto symmetricLogInverse = [](float val) {
+        return val > 0 ? (exp(val + smallest) - addition) : -(exp(-val + smallest) - addition);
+    };
+
+    float scale = pow(2.0f, mExposure);
+
+    float baseMinLog = symmetricLog(mHistogramMin);
+    float baseDiffLog = symmetricLog(mHistogramMax) - baseMinLog;
+
+    // The displayed axis spans the transformed value range. Exposure is a
+    // positive scale, so the transform is monotonic and the mapping between
+    // display bins and base bins is an interval per bin.
+    float dispMinLog = symmetricLog(displayedValue(mHistogramMin));
+    float dispDiffLog = symmetricLog(displayedValue(mHistogramMax)) - dispMinLog;
+
+    if (!(baseDiffLog > 0) || !(dispDiffLog > 0)) {
+        mValues.assign((size_t)NUM_BINS * mNChannels, 0.0f);
+        mZeroBin = 0;
+        mGeometryDirty = true;
+        return;
+    }
+
+    // Continuous base-bin coordinate of a displayed value.
+    auto dispValToBaseBin = [&](float dispVal) {
+        float raw = (dispVal - mOffset) / scale;
+        return clamp(nBaseBins * (symmetricLog(raw) - baseMinLog) / baseDiffLog, 0.0f, (float)nBaseBins);
+    };
+
+    auto dispBinToVal = [&](float bin) {
+        return symmetricLogInverse((dispDiffLog * bin / NUM_BINS) + dispMinLog);
+    };
+
+    mValues.assign((size_t)NUM_BINS * mNChannels, 0.0f);
+
+    for (int i = 0; i < mNChannels; ++i) {
+        const float* base = mBaseHistogram.data() + (size_t)i * nBaseBins;
+        float* out = mValues.data() + (size_t)i * NUM_BINS;
+
+        for (int j = 0; j < NUM_BINS; ++j) {
+            float v0 = dispBinToVal((float)j);
+            float v1 = dispBinToVal((float)j + 1);
+
+            // Sum the base counts the display bin covers, taking the two
+            // partially covered end bins fractionally.
+            float b0 = dispValToBaseBin(v0);
+            float b1 = dispValToBaseBin(v1);
+            int ib0 = (int)b0;
+            int ib1 = (int)b1;
+
+            float sum = 0;
+            if (ib0 == ib1) {
+                if (ib0 < nBaseBins) {
+                    sum = base[ib0] * (b1 - b0);
+                }
+            } else {
+                if (ib0 < nBaseBins) {
+                    sum += base[ib0] * (ib0 + 1 - b0);
+                }
+                for (int b = ib0 + 1; b < ib1 && b < nBaseBins; ++b) {
+                    sum += base[b];
+                }
+                if (ib1 < nBaseBins) {
+                    sum += base[ib1] * (b1 - ib1);
+                }
+            }
+
+            // Density in displayed-value space.
+            out[j] = sum / (v1 - v0);
+        }
+    }
+
+    // Normalize the histogram according to the 10th-largest
+    // element to avoid a couple spikes ruining the entire graph.
+    if (mValues.size() > 10) {
+        auto tmp = mValues;
+        size_t idx = tmp.size() - 10;
+        nth_element(begin(tmp), begin(tmp) + idx, end(tmp));
+
+        float norm = 1.0f / (max(tmp[idx], 0.1f) * 1.3f);
+        for (auto& v : mValues) {
+            v *= norm;
+        }
+    }
+
+    // Marker at the displayed position of value zero.
+    mZeroBin = clamp((int)(NUM_BINS * (symmetricLog(displayedValue(0.0f)) - dispMinLog) / dispDiffLog), 0, NUM_BINS - 1);
+
+    mGeometryDirty = true;
+}
+
+void MultiGraph::updateGeometry() {
+    if (!mGeometryDirty && m_size == mCachedSize) {
+        return;
+    }
+    mGeometryDirty = false;
+    mCachedSize = m_size;
+
+    mVertexX.clear();
+    mVertexY.clear();
+
+    size_t nBins = mNChannels > 0 ? mValues.size() / mNChannels : 0;
+    if (nBins < 2) {
+        return;
+    }
+
+    // The widget is far narrower than the histogram has bins, so emit one
+    // vertex per pixel column carrying the column's peak: visually this is
+    // the upper envelope the filled per-bin polyline produced anyway, at a
+    // fraction of the path-building cost per frame.
+    size_t nPoints = min(nBins, (size_t)max(m_size.x() - 4, 2));
+
+    mVertexX.resize(nPoints);
+    mVertexY.resize(nPoints * mNChannels);
+
+    for (size_t p = 0; p < nPoints; ++p) {
+        mVertexX[p] = 2 + p * (m_size.x() - 4) / (float)(nPoints - 1);
+    }
+
+    for (size_t i = 0; i < (size_t)mNChannels; ++i) {
+        for (size_t p = 0; p < nPoints; ++p) {
+            size_t binBegin = p * nBins / nPoints;
+            size_t binEnd = max((p + 1) * nBins / nPoints, binBegin + 1);
+
+            float value = 0;
+            for (size_t j = binBegin; j < binEnd; ++j) {
+                value = max(value, mValues[j + i * nBins]);
+            }
+
+            mVertexY[p + i * nPoints] = (1 - value) * m_size.y();
+        }
+    }
+}
+
 void MultiGraph::draw(NVGcontext *ctx) {
     Widget::draw(ctx);
 
+    updateHistogram();
+
     NVGpaint bg = nvgBoxGradient(ctx,
         m_pos.x() + 1, m_pos.y() + 1 + 1.0f, m_size.x() - 2, m_size.y() - 2,
         3, 4, Color(120, 32), Color(32, 32));
@@ -41,7 +203,9 @@ void MultiGraph::draw(NVGcontext *ctx) {
 
     nvgFill(ctx);
 
-    if (mValues.size() >= 2) {
+    updateGeometry();
+
+    if (!mVertexX.empty()) {
         array<Color, 3> colors = {{
             Color{255, 0, 0, 200},
             Color{0, 255, 0, 200},
@@ -52,17 +216,14 @@ void MultiGraph::draw(NVGcontext *ctx) {
         // Additive blending
         nvgGlobalCompositeBlendFunc(ctx, NVGblendFactor::NVG_SRC_ALPHA, NVGblendFactor::NVG_ONE);
 
-        size_t nBins = mValues.size() / mNChannels;
+        size_t nPoints = mVertexX.size();
 
         for (size_t i = 0; i < (size_t)mNChannels; i++) {
             nvgBeginPath(ctx);
             nvgMoveTo(ctx, m_pos.x(), m_pos.y() + m_size.y());
 
-            for (size_t j = 0; j < (size_t)nBins; j++) {
-                float value = mValues[j + i * nBins];
-                float vx = m_pos.x() + 2 + j * (m_size.x() - 4) / (float)(nBins - 1);
-                float vy = m_pos.y() + (1 - value) * m_size.y();
-                nvgLineTo(ctx, vx, vy);
+            for (size_t p = 0; p < nPoints; p++) {
+                nvgLineTo(ctx, m_pos.x() + mVertexX[p], m_pos.y() + mVertexY[p + i * nPoints]);
             }
 
             auto color = i < colors.size() ? colors[i] : mForegroundColor;
@@ -74,6 +235,7 @@ void MultiGraph::draw(NVGcontext *ctx) {
         nvgRestore(ctx);
 
         if (mZeroBin > 0) {
+            size_t nBins = mValues.size() / mNChannels;
             nvgBeginPath(ctx);
             nvgRect(ctx, m_pos.x() + 1 + mZeroBin * (m_size.x() - 4) / (float)(nBins - 1), m_pos.y() + 15, 4, m_size.y() - 15);
             nvgFillColor(ctx, Color(0, 128));
@@ -89,17 +251,19 @@ void MultiGraph::draw(NVGcontext *ctx) {
         nvgFontSize(ctx, 15.0f);
         nvgTextAlign(ctx, NVG_ALIGN_LEFT | NVG_ALIGN_TOP);
         nvgFillColor(ctx, mTextColor);
-        drawTextWithShadow(ctx, m_pos.x() + 3, m_pos.y() + 1, fmt::format("{:.3f}", mMinimum));
+        // The axis labels describe the displayed (exposure/offset-applied)
+        // value range, matching the re-binned curve.
+        drawTextWithShadow(ctx, m_pos.x() + 3, m_pos.y() + 1, fmt::format("{:.3f}", displayedValue(mMinimum)));
 
         nvgTextAlign(ctx, NVG_ALIGN_MIDDLE | NVG_ALIGN_TOP);
         nvgFillColor(ctx, mTextColor);
-        string meanString = fmt::format("{:.3f}", mMean);
+        string meanString = fmt::format("{:.3f}", displayedValue(mMean));
         float textWidth = nvgTextBounds(ctx, 0, 0, meanString.c_str(), nullptr, nullptr);
         drawTextWithShadow(ctx, m_pos.x() + m_size.x() / 2 - textWidth / 2, m_pos.y() + 1, meanString);
 
         nvgTextAlign(ctx, NVG_ALIGN_RIGHT | NVG_ALIGN_TOP);
         nvgFillColor(ctx, mTextColor);
-        drawTextWithShadow(ctx, m_pos.x() + m_size.x() - 3, m_pos.y() + 1, fmt::format("{:.3f}", mMaximum));
+        drawTextWithShadow(ctx, m_pos.x() + m_size.x() - 3, m_pos.y() + 1, fmt::format("{:.3f}", displayedValue(mMaximum)));
 
         if (!mCaption.empty()) {
             nvgFontSize(ctx, 14.0f);
@@ -3,6 +3,110 @@
 
 #include <tev/Task.h>
 
+#include <cstdlib>
+
 namespace tev {
 
+namespace {
+
+// Smallest size class; also determines the alignment of pooled blocks.
+const size_t MIN_BLOCK_SIZE = 64;
+
+// Blocks larger than the largest size class bypass the pool entirely.
+const size_t NUM_SIZE_CLASSES = 7; // 64, 128, ..., 4096 bytes
+const uint32_t UNPOOLED_SIZE_CLASS = (uint32_t)-1;
+
+// How many free blocks each thread may hoard per size class before
+// excess blocks are returned to the system allocator.
+const size_t MAX_FREE_BLOCKS_PER_CLASS = 64;
+
+// Every block is prefixed by this header such that free() can tell which
+// freelist the block belongs to, no matter which thread frees it.
+struct alignas(std::max_align_t) BlockHeader {
+    uint32_t sizeClass;
+};
+
+struct FreeBlock {
+    FreeBlock* next;
+};
+
+struct Freelists {
+    FreeBlock* head[NUM_SIZE_CLASSES] = {};
+    size_t count[NUM_SIZE_CLASSES] = {};
+
+    ~Freelists() {
+        for (size_t i = 0; i < NUM_SIZE_CLASSES; ++i) {
+            while (head[i]) {
+                FreeBlock* next = head[i]->next;
+                ::free(head[i]);
+                head[i] = next;
+            }
+        }
+    }
+};
+
+thread_local Freelists tFreelists;
+
+size_t sizeClassOf(size_t size) {
+    size_t sizeClass = 0;
+    size_t classSize = MIN_BLOCK_SIZE;
+    while (classSize < size) {
+        classSize *= 2;
+        ++sizeClass;
+    }
+
+    return sizeClass;
+}
+
+size_t sizeOfClass(size_t sizeClass) {
+    return MIN_BLOCK_SIZE << sizeClass;
+}
+
+}
+
+void* CoroutineFramePool::alloc(size_t size) {
+    size += sizeof(BlockHeader);
+
+    size_t sizeClass = sizeClassOf(size);
+    if (sizeClass >= NUM_SIZE_CLASSES) {
+        auto* header = (BlockHeader*)::malloc(size);
+        if (!header) {
+            throw std::bad_alloc{};
+        }
+
+        header->sizeClass = UNPOOLED_SIZE_CLASS;
+        return header + 1;
+    }
+
+    BlockHeader* header;
+    if (tFreelists.head[sizeClass]) {
+        header = (BlockHeader*)tFreelists.head[sizeClass];
+        tFreelists.head[sizeClass] = tFreelists.head[sizeClass]->next;
+        --tFreelists.count[sizeClass];
+    } else {
+        header = (BlockHeader*)::malloc(sizeOfClass(sizeClass));
+        if (!header) {
+            throw std::bad_alloc{};
+        }
+    }
+
+    header->sizeClass = (uint32_t)sizeClass;
+    return header + 1;
+}
+
+void CoroutineFramePool::free(void* ptr) noexcept {
+    auto* header = (BlockHeader*)ptr - 1;
+
+    uint32_t sizeClass = header->sizeClass;
+    if (sizeClass == UNPOOLED_SIZE_CLASS || tFreelists.count[sizeClass] >= MAX_FREE_BLOCKS_PER_CLASS) {
+        ::free(header);
+        return;
+    }
+
+    auto* block = (FreeBlock*)header;
+    block->next = tFreelists.head[sizeClass];
+    tFreelists.head[sizeClass] = block;
+    ++tFreelists.count[sizeClass];
+}
+
 }
@@ -2,6 +2,7 @@
 // It is published under the BSD 3-Clause License within the LICENSE file.
 
 #include <tev/ThreadPool.h>
+#include <tev/Trace.h>
 
 #include <chrono>
 
@@ -9,6 +10,11 @@ using namespace std;
 
 namespace tev {
 
+// Which worker queue (if any) the current thread owns. Lets enqueueTask
+// push onto the local queue without any cross-thread coordination.
+static thread_local ThreadPool* tLocalPool = nullptr;
+static thread_local size_t tLocalWorkerId = (size_t)-1;
+
 ThreadPool::ThreadPool()
 : ThreadPool{thread::hardware_concurrency()} {
 }
@@ -26,30 +32,91 @@ ThreadPool::~ThreadPool() {
     shutdownThreads(mThreads.size());
 }
 
+void ThreadPool::push(QueuedTask&& task) {
+    size_t queueId;
+    if (tLocalPool == this) {
+        queueId = tLocalWorkerId;
+    } else {
+        queueId = mNextQueue++ % mWorkerQueues.size();
+    }
+
+    {
+        auto& queue = mWorkerQueues[queueId];
+        lock_guard lock{queue.mutex};
+        queue.tasks.push(std::move(task));
+    }
+
+    ++mNumPendingTasks;
+
+    // Only touch the wakeup mutex when a worker is actually asleep. Workers
+    // increment the sleeper count under this mutex before re-checking the
+    // pending count, so no wakeup can fall between their check and their wait.
+    if (mNumSleepingWorkers > 0) {
+        lock_guard lock{mWakeupMutex};
+        mWorkerCondition.notify_one();
+    }
+}
+
+bool ThreadPool::tryPop(size_t workerId, QueuedTask& task) {
+    // First drain the worker's own queue; then try to steal
+    // from the neighbors in round-robin order.
+    size_t numQueues = mWorkerQueues.size();
+    for (size_t i = 0; i < numQueues; ++i) {
+        auto& queue = mWorkerQueues[(workerId + i) % numQueues];
+
+        unique_lock lock{queue.mutex, try_to_lock};
+        if (i != 0 && !lock.owns_lock()) {
+            // Don't wait on queues another thread is already busy with.
+            continue;
+        }
+
+        if (!lock.owns_lock()) {
+            lock.lock();
+        }
+
+        if (queue.tasks.empty()) {
+            continue;
+        }
+
+        task = {queue.tasks.top().priority, std::move(const_cast<QueuedTask&>(queue.tasks.top()).fun)};
+        queue.tasks.pop();
+        --mNumPendingTasks;
+        return true;
+    }
+
+    return false;
+}
+
 void ThreadPool::startThreads(size_t num) {
     mNumThreads += num;
     for (size_t i = mThreads.size(); i < mNumThreads; ++i) {
+        mWorkerQueues.emplace_back();
         mThreads.emplace_back([this, i] {
+            tLocalPool = this;
+            tLocalWorkerId = i;
+
             while (true) {
-                unique_lock lock{mTaskQueueMutex};
+                QueuedTask task;
+                if (!tryPop(i, task)) {
+                    // Nothing to do anywhere; sleep until new work arrives
+                    unique_lock lock{mWakeupMutex};
+                    ++mNumSleepingWorkers;
+                    while (i < mNumThreads && mNumPendingTasks == 0) {
+                        mWorkerCondition.wait(lock);
+                    }
+                    --mNumSleepingWorkers;
 
-                // look for a work item
-                while (i < mNumThreads && mTaskQueue.empty()) {
-                    // if there are none wait for notification
-                    mWorkerCondition.wait(lock);
-                }
+                    if (i >= mNumThreads) {
+                        break;
+                    }
 
-                if (i >= mNumThreads) {
-                    break;
+                    continue;
                 }
 
-                function<void()> task{move(mTaskQueue.top().fun)};
-                mTaskQueue.pop();
-
-                // Unlock the lock, so we can process the task without blocking other threads
-                lock.unlock();
-
-                task();
+                {
+                    trace::Span span{"pool: task"};
+                    task.fun();
+                }
 
                 mNumTasksInSystem--;
 
@@ -69,7 +136,7 @@ void ThreadPool::shutdownThreads(size_t num) {
     auto numToClose = min(num, mNumThreads);
 
     {
-        lock_guard lock{mTaskQueueMutex};
+        lock_guard lock{mWakeupMutex};
         mNumThreads -= numToClose;
     }
 
@@ -102,11 +169,14 @@ void ThreadPool::waitUntilFinishedFor(const chrono::microseconds Duration) {
 }
 
 void ThreadPool::flushQueue() {
-    lock_guard lock{mTaskQueueMutex};
-
-    mNumTasksInSystem -= mTaskQueue.size();
-    while (!mTaskQueue.empty()) {
-        mTaskQueue.pop();
+    for (auto& queue : mWorkerQueues) {
+        lock_guard lock{queue.mutex};
+
+        mNumTasksInSystem -= queue.tasks.size();
+        mNumPendingTasks -= queue.tasks.size();
+        while (!queue.tasks.empty()) {
+            queue.tasks.pop();
+        }
     }
 }
 
@@ -0,0 +1,101 @@
+// This file was developed by Thomas Müller <thomas94@gmx.net>.
+// It is published under the BSD 3-Clause License within the LICENSE file.
+
+#include <tev/Trace.h>
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+using namespace std;
+
+namespace tev {
+
+namespace trace {
+
+namespace {
+
+struct Event {
+    const char* name;
+    chrono::steady_clock::time_point begin;
+    chrono::steady_clock::time_point end;
+    int threadId;
+};
+
+atomic<bool> sEnabled{false};
+
+// The spans tev records are coarse (milliseconds of decoding, statistics, or
+// texture work), so a single locked vector suffices; per-thread buffers would
+// only pay off at far finer granularity.
+mutex sEventMutex;
+vector<Event> sEvents;
+
+int currentThreadId() {
+    static atomic<int> sNextThreadId{0};
+    static thread_local int tThreadId = sNextThreadId++;
+    return tThreadId;
+}
+
+} // namespace
+
+bool enabled() {
+    return sEnabled.load(memory_order_relaxed);
+}
+
+void setEnabled(bool enabled) {
+    sEnabled = enabled;
+}
+
+void clear() {
+    lock_guard lock{sEventMutex};
+    sEvents.clear();
+}
+
+void record(const char* name, chrono::steady_clock::time_point begin, chrono::steady_clock::time_point end) {
+    if (!enabled()) {
+        return;
+    }
+
+    lock_guard lock{sEventMutex};
+    sEvents.push_back({name, begin, end, currentThreadId()});
+}
+
+void dumpToFile(const fs::path& path) {
+    vector<Event> events;
+    {
+        lock_guard lock{sEventMutex};
+        events = sEvents;
+    }
+
+    sort(begin(events), end(events), [](const Event& a, const Event& b) { return a.begin < b.begin; });
+
+    ofstream file{path};
+    if (!file) {
+        throw runtime_error{fmt::format("Could not open {} for writing.", toString(path))};
+    }
+
+    // Timestamps are microseconds relative to the earliest recorded event;
+    // Chrome's trace viewer only cares about their relative placement.
+    auto epoch = events.empty() ? chrono::steady_clock::time_point{} : events.front().begin;
+
+    file << "[\n";
+    for (size_t i = 0; i < events.size(); ++i) {
+        const auto& event = events[i];
+        file << fmt::format(
+            "{{\"name\":\"{}\",\"ph\":\"X\",\"ts\":{:.3f},\"dur\":{:.3f},\"pid\":0,\"tid\":{}}}{}\n",
+            event.name,
+            chrono::duration<double, micro>{event.begin - epoch}.count(),
+            chrono::duration<double, micro>{event.end - event.begin}.count(),
+            event.threadId,
+            i + 1 < events.size() ? "," : ""
+        );
+    }
+
+    file << "]\n";
+}
+
+}
+
+}
@@ -9,17 +9,65 @@ using namespace std;
 
 namespace tev {
 
-UberShader::UberShader(RenderPass* renderPass) {
+UberShader::UberShader(RenderPass* renderPass)
+: mRenderPass{renderPass} {
+    // A few kilobytes each; uploading every map up front makes runtime
+    // colormap switches free and copies nothing per frame.
+    for (int i = 0; i < EColorMap::NumColorMaps; ++i) {
+        const auto& fcd = colormap::data(static_cast<EColorMap>(i));
+
+        mColorMaps[i] = new Texture{
+            Texture::PixelFormat::RGBA,
+            Texture::ComponentFormat::Float32,
+            Vector2i{(int)fcd.size() / 4, 1}
+        };
+        mColorMaps[i]->upload((uint8_t*)fcd.data());
+    }
+
+    // Compile the variant that draws the plain checkerboard right away such
+    // that shader errors surface on startup rather than on first draw.
+    mShader = variantShader(ETonemap::SRGB, EMetric::Error, false);
+}
+
+UberShader::~UberShader() { }
+
+Shader* UberShader::variantShader(ETonemap tonemap, EMetric metric, bool hasReference) {
+#if defined(NANOGUI_USE_METAL)
+    // The Metal backend keeps a single shader with runtime branches: its
+    // argument binding is validated against the function signature, so
+    // specializing arguments away per variant buys little compared to the
+    // GL backends, where uniform branches are costly on older hardware.
+    int key = 0;
+#else
+    int key = (static_cast<int>(tonemap) << 4) | (static_cast<int>(metric) << 1) | (hasReference ? 1 : 0);
+#endif
+
+    auto iter = mShaders.find(key);
+    if (iter != mShaders.end()) {
+        return iter->second.get();
+    }
+
+    nanogui::ref<Shader> shader;
     try {
 #if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
 #   if defined(NANOGUI_USE_OPENGL)
     std::string preamble =
-        R"(#version 110)";
+        R"(#version 110
+        )";
 #   elif defined(NANOGUI_USE_GLES)
     std::string preamble =
         R"(#version 100
-        precision highp float;)";
+        precision highp float;
+        )";
 #   endif
+        // Specializing the tonemap, metric, and reference presence at compile
+        // time keeps the per-fragment code free of uniform branches, which
+        // older GPUs execute poorly.
+        preamble +=
+            "#define TONEMAP " + std::to_string(static_cast<int>(tonemap)) + "\n" +
+            "#define METRIC " + std::to_string(static_cast<int>(metric)) + "\n" +
+            "#define HAS_REFERENCE " + std::to_string(hasReference ? 1 : 0) + "\n";
+
         auto vertexShader = preamble +
             R"(
             uniform vec2 pixelSize;
@@ -28,19 +76,25 @@ UberShader::UberShader(RenderPass* renderPass) {
             uniform vec2 imageScale;
             uniform vec2 imageOffset;
 
+            #if HAS_REFERENCE
             uniform vec2 referenceScale;
             uniform vec2 referenceOffset;
+            #endif
 
             attribute vec2 position;
 
             varying vec2 checkerUv;
             varying vec2 imageUv;
+            #if HAS_REFERENCE
             varying vec2 referenceUv;
+            #endif
 
             void main() {
                 checkerUv = position / (pixelSize * checkerSize);
                 imageUv = position * imageScale + imageOffset;
+            #if HAS_REFERENCE
                 referenceUv = position * referenceScale + referenceOffset;
+            #endif
 
                 gl_Position = vec4(position, 1.0, 1.0);
             })";
@@ -61,23 +115,28 @@ UberShader::UberShader(RenderPass* renderPass) {
             uniform sampler2D image;
             uniform bool hasImage;
 
+            #if HAS_REFERENCE
             uniform sampler2D reference;
-            uniform bool hasReference;
+            #endif
 
+            #if TONEMAP == FALSE_COLOR
             uniform sampler2D colormap;
+            #endif
 
             uniform float exposure;
             uniform float offset;
+            #if TONEMAP == GAMMA
             uniform float gamma;
+            #endif
             uniform bool clipToLdr;
-            uniform int tonemap;
-            uniform int metric;
 
             uniform vec4 bgColor;
 
             varying vec2 checkerUv;
             varying vec2 imageUv;
+            #if HAS_REFERENCE
             varying vec2 referenceUv;
+            #endif
 
             float average(vec3 col) {
                 return (col.r + col.g + col.b) / 3.0;
@@ -87,10 +146,12 @@ UberShader::UberShader(RenderPass* renderPass) {
                 return pow(2.0, exposure) * col + offset;
             }
 
+            #if TONEMAP == FALSE_COLOR
             vec3 falseColor(float v) {
                 v = clamp(v, 0.0, 1.0);
                 return texture2D(colormap, vec2(v, 0.5)).rgb;
             }
+            #endif
 
             float linear(float sRGB) {
                 float outSign = sign(sRGB);
@@ -115,35 +176,39 @@ UberShader::UberShader(RenderPass* renderPass) {
             }
 
             vec3 applyTonemap(vec3 col, vec4 background) {
-                if (tonemap == SRGB) {
-                    col = col +
-                        (vec3(linear(background.r), linear(background.g), linear(background.b)) - offset) * background.a;
-                    return vec3(sRGB(col.r), sRGB(col.g), sRGB(col.b));
-                } else if (tonemap == GAMMA) {
-                    col = col + (pow(background.rgb, vec3(gamma)) - offset) * background.a;
-                    return sign(col) * pow(abs(col), vec3(1.0 / gamma));
-                } else if (tonemap == FALSE_COLOR) {
-                    return falseColor(log2(average(col)+0.03125) / 10.0 + 0.5) + (background.rgb - falseColor(0.0)) * background.a;
-                } else if (tonemap == POS_NEG) {
-                    return vec3(-average(min(col, vec3(0.0))) * 2.0, average(max(col, vec3(0.0))) * 2.0, 0.0) + background.rgb * background.a;
-                }
+            #if TONEMAP == SRGB
+                col = col +
+                    (vec3(linear(background.r), linear(background.g), linear(background.b)) - offset) * background.a;
+                return vec3(sRGB(col.r), sRGB(col.g), sRGB(col.b));
+            #elif TONEMAP == GAMMA
+                col = col + (pow(background.rgb, vec3(gamma)) - offset) * background.a;
+                return sign(col) * pow(abs(col), vec3(1.0 / gamma));
+            #elif TONEMAP == FALSE_COLOR
+                return falseColor(log2(average(col)+0.03125) / 10.0 + 0.5) + (background.rgb - falseColor(0.0)) * background.a;
+            #elif TONEMAP == POS_NEG
+                return vec3(-average(min(col, vec3(0.0))) * 2.0, average(max(col, vec3(0.0))) * 2.0, 0.0) + background.rgb * background.a;
+            #else
                 return vec3(0.0);
+            #endif
             }
 
+            #if HAS_REFERENCE
             vec3 applyMetric(vec3 col, vec3 reference) {
-                if (metric == ERROR) {
-                    return col;
-                } else if (metric == ABSOLUTE_ERROR) {
-                    return abs(col);
-                } else if (metric == SQUARED_ERROR) {
-                    return col * col;
-                } else if (metric == RELATIVE_ABSOLUTE_ERROR) {
-                    return abs(col) / (reference + vec3(0.01));
-                } else if (metric == RELATIVE_SQUARED_ERROR) {
-                    return col * col / (reference * reference + vec3(0.01));
-                }
+            #if METRIC == ERROR
+                return col;
+            #elif METRIC == ABSOLUTE_ERROR
+                return abs(col);
+            #elif METRIC == SQUARED_ERROR
+                return col * col;
+            #elif METRIC == RELATIVE_ABSOLUTE_ERROR
+                return abs(col) / (reference + vec3(0.01));
+            #elif METRIC == RELATIVE_SQUARED_ERROR
+                return col * col / (reference * reference + vec3(0.01));
+            #else
                 return vec3(0.0);
+            #endif
             }
+            #endif
 
             vec4 sample(sampler2D sampler, vec2 uv) {
                 vec4 color = texture2D(sampler, uv);
@@ -165,15 +230,7 @@ UberShader::UberShader(RenderPass* renderPass) {
                 }
 
                 vec4 imageVal = sample(image, imageUv);
-                if (!hasReference) {
-                    gl_FragColor = vec4(
-                        applyTonemap(applyExposureAndOffset(imageVal.rgb), vec4(checker, 1.0 - imageVal.a)),
-                        1.0
-                    );
-                    gl_FragColor.rgb = clamp(gl_FragColor.rgb, clipToLdr ? 0.0 : -64.0, clipToLdr ? 1.0 : 64.0);
-                    return;
-                }
-
+            #if HAS_REFERENCE
                 vec4 referenceVal = sample(reference, referenceUv);
 
                 vec3 difference = imageVal.rgb - referenceVal.rgb;
@@ -182,6 +239,12 @@ UberShader::UberShader(RenderPass* renderPass) {
                     applyTonemap(applyExposureAndOffset(applyMetric(difference, referenceVal.rgb)), vec4(checker, 1.0 - alpha)),
                     1.0
                 );
+            #else
+                gl_FragColor = vec4(
+                    applyTonemap(applyExposureAndOffset(imageVal.rgb), vec4(checker, 1.0 - imageVal.a)),
+                    1.0
+                );
+            #endif
 
                 gl_FragColor.rgb = clamp(gl_FragColor.rgb, clipToLdr ? 0.0 : -64.0, clipToLdr ? 1.0 : 64.0);
             })";
@@ -374,9 +437,20 @@ UberShader::UberShader(RenderPass* renderPass) {
             })";
 #endif
 
-        mShader = new Shader{renderPass, "ubershader", vertexShader, fragmentShader};
+        // Persisting compiled program binaries across runs (glGetProgramBinary /
+        // Metal binary archives keyed by driver and source hash) would shave the
+        // remaining compile off our cold start, but nanogui::Shader compiles and
+        // reflects the program inside its constructor with no way to supply a
+        // prebuilt binary, so such a cache has to live in nanogui. Until then we
+        // keep startup cheap by compiling only this one variant eagerly and rely
+        // on the driver's own shader cache for repeat launches.
+        shader = new Shader{mRenderPass, "ubershader", vertexShader, fragmentShader};
     } catch (const runtime_error& e) {
         tlog::error() << fmt::format("Unable to compile shader: {}", e.what());
+
+        // Fall back to the most recently used variant; better to draw with the
+        // wrong settings than not at all.
+        return mShader.get();
     }
 
     // 2 Triangles
@@ -391,21 +465,13 @@ UberShader::UberShader(RenderPass* renderPass) {
         -1.f, 1.f,
     };
 
-    mShader->set_buffer("indices", VariableType::UInt32, {3*2}, indices);
-    mShader->set_buffer("position", VariableType::Float32, {4, 2}, positions);
-
-    const auto& fcd = colormap::turbo();
+    shader->set_buffer("indices", VariableType::UInt32, {3*2}, indices);
+    shader->set_buffer("position", VariableType::Float32, {4, 2}, positions);
 
-    mColorMap = new Texture{
-        Texture::PixelFormat::RGBA,
-        Texture::ComponentFormat::Float32,
-        Vector2i{(int)fcd.size() / 4, 1}
-    };
-    mColorMap->upload((uint8_t*)fcd.data());
+    mShaders[key] = shader;
+    return shader.get();
 }
 
-UberShader::~UberShader() { }
-
 void UberShader::draw(const Vector2f& pixelSize, const Vector2f& checkerSize) {
     draw(
         pixelSize, checkerSize,
@@ -448,11 +514,58 @@ void UberShader::draw(
     bool clipToLdr,
     ETonemap tonemap,
     EMetric metric
+) {
+    draw(
+        pixelSize, checkerSize,
+        Box2f{Vector2f{-1.0f}, Vector2f{1.0f}},
+        textureImage, transformImage,
+        textureReference, transformReference,
+        exposure, offset, gamma, clipToLdr,
+        tonemap, metric
+    );
+}
+
+void UberShader::draw(
+    const Vector2f& pixelSize,
+    const Vector2f& checkerSize,
+    const Box2f& ndcRect,
+    Texture* textureImage,
+    const Matrix3f& transformImage,
+    float exposure,
+    float offset,
+    float gamma,
+    bool clipToLdr,
+    ETonemap tonemap
+) {
+    draw(
+        pixelSize, checkerSize,
+        ndcRect,
+        textureImage, transformImage,
+        nullptr, Matrix3f{0.0f},
+        exposure, offset, gamma, clipToLdr,
+        tonemap, EMetric::Error
+    );
+}
+
+void UberShader::draw(
+    const Vector2f& pixelSize,
+    const Vector2f& checkerSize,
+    const Box2f& ndcRect,
+    Texture* textureImage,
+    const Matrix3f& transformImage,
+    Texture* textureReference,
+    const Matrix3f& transformReference,
+    float exposure,
+    float offset,
+    float gamma,
+    bool clipToLdr,
+    ETonemap tonemap,
+    EMetric metric
 ) {
     bool hasImage = textureImage;
     if (!hasImage) {
         // Just to have _some_ valid texture to bind. Will be ignored.
-        textureImage = mColorMap.get();
+        textureImage = mColorMaps[mColorMap].get();
     }
 
     bool hasReference = textureReference;
@@ -461,13 +574,31 @@ void UberShader::draw(
         textureReference = textureImage;
     }
 
+    mShader = variantShader(tonemap, metric, hasReference);
+
     bindCheckerboardData(pixelSize, checkerSize);
     bindImageData(textureImage, transformImage, exposure, offset, gamma, tonemap);
+#if defined(NANOGUI_USE_METAL)
+    // The Metal shader keeps its runtime branches, so every argument must be
+    // bound even when it ends up being ignored.
     bindReferenceData(textureReference, transformReference, metric);
-    mShader->set_uniform("hasImage", hasImage);
     mShader->set_uniform("hasReference", hasReference);
+#else
+    if (hasReference) {
+        bindReferenceData(textureReference, transformReference, metric);
+    }
+#endif
+    mShader->set_uniform("hasImage", hasImage);
     mShader->set_uniform("clipToLdr", clipToLdr);
 
+    float positions[2*4] = {
+        ndcRect.min.x(), ndcRect.min.y(),
+        ndcRect.max.x(), ndcRect.min.y(),
+        ndcRect.max.x(), ndcRect.max.y(),
+        ndcRect.min.x(), ndcRect.max.y(),
+    };
+    mShader->set_buffer("position", VariableType::Float32, {4, 2}, positions);
+
     mShader->begin();
     mShader->draw_array(Shader::PrimitiveType::Triangle, 0, 6, true);
     mShader->end();
@@ -493,10 +624,22 @@ void UberShader::bindImageData(
 
     mShader->set_uniform("exposure", exposure);
     mShader->set_uniform("offset", offset);
+
+#if defined(NANOGUI_USE_METAL)
     mShader->set_uniform("gamma", gamma);
     mShader->set_uniform("tonemap", static_cast<int>(tonemap));
+    mShader->set_texture("colormap", mColorMaps[mColorMap].get());
+#else
+    // Only the variant that uses these declares them; setting them on any
+    // other variant would fail the uniform lookup.
+    if (tonemap == ETonemap::Gamma) {
+        mShader->set_uniform("gamma", gamma);
+    }
 
-    mShader->set_texture("colormap", mColorMap.get());
+    if (tonemap == ETonemap::FalseColor) {
+        mShader->set_texture("colormap", mColorMaps[mColorMap].get());
+    }
+#endif
 }
 
 void UberShader::bindReferenceData(
@@ -508,7 +651,12 @@ void UberShader::bindReferenceData(
     mShader->set_uniform("referenceScale", Vector2f{transformReference.m[0][0], transformReference.m[1][1]});
     mShader->set_uniform("referenceOffset", Vector2f{transformReference.m[2][0], transformReference.m[2][1]});
 
+#if defined(NANOGUI_USE_METAL)
     mShader->set_uniform("metric", static_cast<int>(metric));
+#else
+    // The metric is baked into the shader variant.
+    (void)metric;
+#endif
 }
 
 }
@@ -3,8 +3,208 @@
 
 #include <tev/VectorGraphics.h>
 
+#include <atomic>
+#include <tuple>
+
 using namespace std;
 
 namespace tev {
 
+// Generations are drawn from one process-wide counter such that no two
+// batch states ever share one; the shader's upload cache can then compare
+// generations alone without worrying about batches being destroyed and
+// reallocated at the same address.
+static size_t nextVgBatchGeneration() {
+    static atomic<size_t> sGeneration{0};
+    return ++sGeneration;
+}
+
+VgBatch::VgBatch() {
+    clear();
+}
+
+void VgBatch::clear() {
+    mSegmentA.clear();
+    mSegmentB.clear();
+    mSegmentParam.clear();
+    mSegmentColor.clear();
+
+    mTrianglePos.clear();
+    mTriangleColor.clear();
+
+    mCircleCenter.clear();
+    mCircleRadius.clear();
+    mCircleCorner.clear();
+    mCircleRing.clear();
+    mCircleColor.clear();
+
+    mFillColor = {0.0f, 0.0f, 0.0f, -1.0f};
+    mStrokeColor = {0.0f, 0.0f, 0.0f, -1.0f};
+    mColorStack.clear();
+
+    mPathPolylines.clear();
+    mPathRects.clear();
+    mPathCircles.clear();
+
+    mSupported = true;
+    bumpGeneration();
+}
+
+void VgBatch::append(const vector<VgCommand>& commands) {
+    if (!mSupported) {
+        // Already fallen back to NanoVG replay; the appended commands are
+        // part of the image's command list and get replayed from there.
+        return;
+    }
+
+    for (const auto& command : commands) {
+        const float* f = command.data.data();
+        switch (command.type) {
+            case VgCommand::EType::Save: mColorStack.emplace_back(mFillColor, mStrokeColor); break;
+            case VgCommand::EType::Restore: {
+                if (mColorStack.empty()) {
+                    tlog::warning() << "Malformed vector graphics commands: restore before save";
+                    break;
+                }
+
+                tie(mFillColor, mStrokeColor) = mColorStack.back();
+                mColorStack.pop_back();
+            } break;
+            case VgCommand::EType::FillColor: mFillColor = {f[0], f[1], f[2], f[3]}; break;
+            case VgCommand::EType::StrokeColor: mStrokeColor = {f[0], f[1], f[2], f[3]}; break;
+            case VgCommand::EType::BeginPath: {
+                mPathPolylines.clear();
+                mPathRects.clear();
+                mPathCircles.clear();
+            } break;
+            case VgCommand::EType::ClosePath: {
+                if (!mPathPolylines.empty()) {
+                    mPathPolylines.back().closed = true;
+                }
+            } break;
+            case VgCommand::EType::MoveTo: mPathPolylines.push_back({{{f[0], f[1]}}, false}); break;
+            case VgCommand::EType::LineTo: {
+                if (mPathPolylines.empty()) {
+                    // A lineTo without a preceding moveTo starts a subpath of its own.
+                    mPathPolylines.push_back({{{f[0], f[1]}}, false});
+                } else if (mPathPolylines.back().closed) {
+                    // NanoVG continues in a fresh subpath starting at the close target.
+                    mPathPolylines.push_back({{mPathPolylines.back().points.front(), {f[0], f[1]}}, false});
+                } else {
+                    mPathPolylines.back().points.push_back({f[0], f[1]});
+                }
+            } break;
+            case VgCommand::EType::Rect: mPathRects.push_back({f[0], f[1], f[2], f[3]}); break;
+            case VgCommand::EType::Circle: mPathCircles.push_back({f[0], f[1], f[2], f[2]}); break;
+            case VgCommand::EType::Ellipse: mPathCircles.push_back({f[0], f[1], f[2], f[3]}); break;
+            case VgCommand::EType::Fill: {
+                if (!mPathPolylines.empty()) {
+                    // Filling a free-form path requires winding-rule
+                    // tessellation, which we leave to NanoVG.
+                    markUnsupported();
+                    return;
+                }
+
+                for (const auto& r : mPathRects) {
+                    emitTriangle({r[0], r[1]}, {r[0] + r[2], r[1]}, {r[0] + r[2], r[1] + r[3]}, mFillColor);
+                    emitTriangle({r[0] + r[2], r[1] + r[3]}, {r[0], r[1] + r[3]}, {r[0], r[1]}, mFillColor);
+                }
+
+                for (const auto& c : mPathCircles) {
+                    emitCircle({c[0], c[1]}, c[2], c[3], false, mFillColor);
+                }
+            } break;
+            case VgCommand::EType::Stroke: {
+                for (const auto& subpath : mPathPolylines) {
+                    for (size_t i = 1; i < subpath.points.size(); ++i) {
+                        emitSegment(subpath.points[i - 1], subpath.points[i], mStrokeColor);
+                    }
+
+                    if (subpath.closed && subpath.points.size() > 2) {
+                        emitSegment(subpath.points.back(), subpath.points.front(), mStrokeColor);
+                    }
+                }
+
+                for (const auto& r : mPathRects) {
+                    emitSegment({r[0], r[1]}, {r[0] + r[2], r[1]}, mStrokeColor);
+                    emitSegment({r[0] + r[2], r[1]}, {r[0] + r[2], r[1] + r[3]}, mStrokeColor);
+                    emitSegment({r[0] + r[2], r[1] + r[3]}, {r[0], r[1] + r[3]}, mStrokeColor);
+                    emitSegment({r[0], r[1] + r[3]}, {r[0], r[1]}, mStrokeColor);
+                }
+
+                for (const auto& c : mPathCircles) {
+                    if (c[2] != c[3]) {
+                        // A constant-width elliptical ring has no closed-form
+                        // coverage; let NanoVG flatten it.
+                        markUnsupported();
+                        return;
+                    }
+
+                    emitCircle({c[0], c[1]}, c[2], c[3], true, mStrokeColor);
+                }
+            } break;
+            default: {
+                markUnsupported();
+                return;
+            }
+        }
+    }
+
+    bumpGeneration();
+}
+
+void VgBatch::emitSegment(const VgCommand::Pos& a, const VgCommand::Pos& b, const Color& color) {
+    // Two triangles spanning the segment; (side, end) selects the corner.
+    static constexpr float corners[6][2] = {
+        {-1.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f},
+        {1.0f, 1.0f}, {-1.0f, 1.0f}, {-1.0f, 0.0f},
+    };
+
+    for (const auto& corner : corners) {
+        mSegmentA.insert(mSegmentA.end(), {a.x, a.y});
+        mSegmentB.insert(mSegmentB.end(), {b.x, b.y});
+        mSegmentParam.insert(mSegmentParam.end(), {corner[0], corner[1]});
+        mSegmentColor.insert(mSegmentColor.end(), color.begin(), color.end());
+    }
+}
+
+void VgBatch::emitTriangle(const VgCommand::Pos& a, const VgCommand::Pos& b, const VgCommand::Pos& c, const Color& color) {
+    mTrianglePos.insert(mTrianglePos.end(), {a.x, a.y, b.x, b.y, c.x, c.y});
+    for (int i = 0; i < 3; ++i) {
+        mTriangleColor.insert(mTriangleColor.end(), color.begin(), color.end());
+    }
+}
+
+void VgBatch::emitCircle(const VgCommand::Pos& center, float rx, float ry, bool ring, const Color& color) {
+    static constexpr float corners[6][2] = {
+        {-1.0f, -1.0f}, {1.0f, -1.0f}, {1.0f, 1.0f},
+        {1.0f, 1.0f}, {-1.0f, 1.0f}, {-1.0f, -1.0f},
+    };
+
+    for (const auto& corner : corners) {
+        mCircleCenter.insert(mCircleCenter.end(), {center.x, center.y});
+        mCircleRadius.insert(mCircleRadius.end(), {rx, ry});
+        mCircleCorner.insert(mCircleCorner.end(), {corner[0], corner[1]});
+        mCircleRing.push_back(ring ? 1.0f : 0.0f);
+        mCircleColor.insert(mCircleColor.end(), color.begin(), color.end());
+    }
+}
+
+void VgBatch::markUnsupported() {
+    mSupported = false;
+
+    // The vertex arrays won't be drawn anymore; release their memory. The
+    // command list itself lives on in the owning image and is replayed
+    // through NanoVG instead.
+    mSegmentA = {}; mSegmentB = {}; mSegmentParam = {}; mSegmentColor = {};
+    mTrianglePos = {}; mTriangleColor = {};
+    mCircleCenter = {}; mCircleRadius = {}; mCircleCorner = {}; mCircleRing = {}; mCircleColor = {};
+
+    bumpGeneration();
+}
+
+void VgBatch::bumpGeneration() {
+    mGeneration = nextVgBatchGeneration();
+}
+
 }
@@ -0,0 +1,400 @@
+// This file was developed by Thomas Müller <thomas94@gmx.net>.
+// It is published under the BSD 3-Clause License within the LICENSE file.
+
+#include <tev/VectorGraphicsShader.h>
+
+using namespace nanogui;
+using namespace std;
+
+namespace tev {
+
+VectorGraphicsShader::VectorGraphicsShader(RenderPass* renderPass)
+: mRenderPass{renderPass} {
+    try {
+#if defined(NANOGUI_USE_OPENGL) || defined(NANOGUI_USE_GLES)
+#   if defined(NANOGUI_USE_OPENGL)
+    std::string preamble =
+        R"(#version 110
+        )";
+#   elif defined(NANOGUI_USE_GLES)
+    std::string preamble =
+        R"(#version 100
+        precision highp float;
+        )";
+#   endif
+        // All three vertex shaders consume display-window-space vertex data
+        // and the same transform uniforms; a command stream that never set a
+        // color is tagged with alpha -1 and picks up `defaultColor` here.
+        auto segmentVertexShader = preamble +
+            R"(
+            uniform vec2 transformScale;
+            uniform vec2 transformOffset;
+            uniform vec2 canvasSize;
+            uniform float strokeWidth;
+            uniform vec4 defaultColor;
+
+            attribute vec2 posA;
+            attribute vec2 posB;
+            attribute vec2 param;
+            attribute vec4 color;
+
+            varying vec4 vColor;
+
+            void main() {
+                vec2 a = posA * transformScale + transformOffset;
+                vec2 b = posB * transformScale + transformOffset;
+
+                // The perpendicular expansion happens in screen space such
+                // that stroke width stays constant under pan and zoom,
+                // matching the immediate-mode NanoVG path.
+                vec2 dir = (b - a) * canvasSize;
+                float len = length(dir);
+                dir = len > 0.0 ? dir / len : vec2(1.0, 0.0);
+                vec2 normal = vec2(-dir.y, dir.x);
+
+                vec2 p = mix(a, b, param.y) + normal * (param.x * strokeWidth / canvasSize);
+
+                vColor = color.a < 0.0 ? defaultColor : color;
+                gl_Position = vec4(p, 1.0, 1.0);
+            })";
+
+        auto segmentFragmentShader = preamble +
+            R"(
+            varying vec4 vColor;
+
+            void main() {
+                gl_FragColor = vColor;
+            })";
+
+        auto triangleVertexShader = preamble +
+            R"(
+            uniform vec2 transformScale;
+            uniform vec2 transformOffset;
+            uniform vec4 defaultColor;
+
+            attribute vec2 position;
+            attribute vec4 color;
+
+            varying vec4 vColor;
+
+            void main() {
+                vColor = color.a < 0.0 ? defaultColor : color;
+                gl_Position = vec4(position * transformScale + transformOffset, 1.0, 1.0);
+            })";
+
+        auto triangleFragmentShader = preamble +
+            R"(
+            varying vec4 vColor;
+
+            void main() {
+                gl_FragColor = vColor;
+            })";
+
+        auto circleVertexShader = preamble +
+            R"(
+            uniform vec2 transformScale;
+            uniform vec2 transformOffset;
+            uniform vec2 canvasSize;
+            uniform float strokeWidth;
+            uniform vec4 defaultColor;
+
+            attribute vec2 center;
+            attribute vec2 radius;
+            attribute vec2 corner;
+            attribute float ring;
+            attribute vec4 color;
+
+            varying vec2 vCircle;
+            varying float vHalfRing;
+            varying float vAaUnit;
+            varying vec4 vColor;
+
+            void main() {
+                // The canvas transform has no rotation and zooms uniformly,
+                // so pixels per display-window unit is the same along both axes.
+                float scalePx = abs(transformScale.x) * canvasSize.x * 0.5;
+                float radiusPx = max(min(abs(radius.x), abs(radius.y)) * scalePx, 0.0001);
+
+                // Pad the quad by the outer half of the ring plus one pixel
+                // of antialiasing such that neither gets clipped.
+                float padPx = (ring > 0.5 ? 0.5 * strokeWidth : 0.0) + 1.0;
+                float extent = 1.0 + padPx / radiusPx;
+
+                vCircle = corner * extent;
+                vHalfRing = ring > 0.5 ? 0.5 * strokeWidth / radiusPx : 0.0;
+                vAaUnit = 1.0 / radiusPx;
+                vColor = color.a < 0.0 ? defaultColor : color;
+
+                vec2 p = center + corner * radius * extent;
+                gl_Position = vec4(p * transformScale + transformOffset, 1.0, 1.0);
+            })";
+
+        auto circleFragmentShader = preamble +
+            R"(
+            varying vec2 vCircle;
+            varying float vHalfRing;
+            varying float vAaUnit;
+            varying vec4 vColor;
+
+            void main() {
+                // Signed distance to the disc respectively ring boundary, in
+                // units of the radius; vAaUnit converts to pixels for a
+                // one-pixel antialiasing ramp.
+                float d = length(vCircle);
+                float dist = vHalfRing > 0.0 ? abs(d - 1.0) - vHalfRing : d - 1.0;
+                float alpha = clamp(0.5 - dist / vAaUnit, 0.0, 1.0);
+                gl_FragColor = vec4(vColor.rgb, vColor.a * alpha);
+            })";
+#elif defined(NANOGUI_USE_METAL)
+        auto segmentVertexShader =
+            R"(using namespace metal;
+
+            struct VertexOut {
+                float4 position [[position]];
+                float4 color;
+            };
+
+            vertex VertexOut vertex_main(
+                const device packed_float2* posA,
+                const device packed_float2* posB,
+                const device packed_float2* param,
+                const device packed_float4* color,
+                const constant float2& transformScale,
+                const constant float2& transformOffset,
+                const constant float2& canvasSize,
+                const constant float& strokeWidth,
+                const constant float4& defaultColor,
+                uint id [[vertex_id]]
+            ) {
+                float2 a = float2(posA[id]) * transformScale + transformOffset;
+                float2 b = float2(posB[id]) * transformScale + transformOffset;
+                float2 param_ = float2(param[id]);
+
+                // The perpendicular expansion happens in screen space such
+                // that stroke width stays constant under pan and zoom,
+                // matching the immediate-mode NanoVG path.
+                float2 dir = (b - a) * canvasSize;
+                float len = length(dir);
+                dir = len > 0.0f ? dir / len : float2(1.0f, 0.0f);
+                float2 normal = float2(-dir.y, dir.x);
+
+                float2 p = mix(a, b, param_.y) + normal * (param_.x * strokeWidth / canvasSize);
+
+                VertexOut vert;
+                vert.position = float4(p, 1.0f, 1.0f);
+                float4 c = float4(color[id]);
+                vert.color = c.a < 0.0f ? defaultColor : c;
+                return vert;
+            })";
+
+        auto segmentFragmentShader =
+            R"(using namespace metal;
+
+            struct VertexOut {
+                float4 position [[position]];
+                float4 color;
+            };
+
+            fragment float4 fragment_main(VertexOut vert [[stage_in]]) {
+                return vert.color;
+            })";
+
+        auto triangleVertexShader =
+            R"(using namespace metal;
+
+            struct VertexOut {
+                float4 position [[position]];
+                float4 color;
+            };
+
+            vertex VertexOut vertex_main(
+                const device packed_float2* position,
+                const device packed_float4* color,
+                const constant float2& transformScale,
+                const constant float2& transformOffset,
+                const constant float4& defaultColor,
+                uint id [[vertex_id]]
+            ) {
+                VertexOut vert;
+                vert.position = float4(float2(position[id]) * transformScale + transformOffset, 1.0f, 1.0f);
+                float4 c = float4(color[id]);
+                vert.color = c.a < 0.0f ? defaultColor : c;
+                return vert;
+            })";
+
+        auto triangleFragmentShader =
+            R"(using namespace metal;
+
+            struct VertexOut {
+                float4 position [[position]];
+                float4 color;
+            };
+
+            fragment float4 fragment_main(VertexOut vert [[stage_in]]) {
+                return vert.color;
+            })";
+
+        auto circleVertexShader =
+            R"(using namespace metal;
+
+            struct VertexOut {
+                float4 position [[position]];
+                float2 circleUv;
+                float halfRing;
+                float aaUnit;
+                float4 color;
+            };
+
+            vertex VertexOut vertex_main(
+                const device packed_float2* center,
+                const device packed_float2* radius,
+                const device packed_float2* corner,
+                const device float* ring,
+                const device packed_float4* color,
+                const constant float2& transformScale,
+                const constant float2& transformOffset,
+                const constant float2& canvasSize,
+                const constant float& strokeWidth,
+                const constant float4& defaultColor,
+                uint id [[vertex_id]]
+            ) {
+                float2 radius_ = float2(radius[id]);
+                float2 corner_ = float2(corner[id]);
+
+                // The canvas transform has no rotation and zooms uniformly,
+                // so pixels per display-window unit is the same along both axes.
+                float scalePx = abs(transformScale.x) * canvasSize.x * 0.5f;
+                float radiusPx = max(min(abs(radius_.x), abs(radius_.y)) * scalePx, 0.0001f);
+
+                // Pad the quad by the outer half of the ring plus one pixel
+                // of antialiasing such that neither gets clipped.
+                float padPx = (ring[id] > 0.5f ? 0.5f * strokeWidth : 0.0f) + 1.0f;
+                float extent = 1.0f + padPx / radiusPx;
+
+                VertexOut vert;
+                vert.circleUv = corner_ * extent;
+                vert.halfRing = ring[id] > 0.5f ? 0.5f * strokeWidth / radiusPx : 0.0f;
+                vert.aaUnit = 1.0f / radiusPx;
+                float4 c = float4(color[id]);
+                vert.color = c.a < 0.0f ? defaultColor : c;
+
+                float2 p = float2(center[id]) + corner_ * radius_ * extent;
+                vert.position = float4(p * transformScale + transformOffset, 1.0f, 1.0f);
+                return vert;
+            })";
+
+        auto circleFragmentShader =
+            R"(using namespace metal;
+
+            struct VertexOut {
+                float4 position [[position]];
+                float2 circleUv;
+                float halfRing;
+                float aaUnit;
+                float4 color;
+            };
+
+            fragment float4 fragment_main(VertexOut vert [[stage_in]]) {
+                // Signed distance to the disc respectively ring boundary, in
+                // units of the radius; aaUnit converts to pixels for a
+                // one-pixel antialiasing ramp.
+                float d = length(vert.circleUv);
+                float dist = vert.halfRing > 0.0f ? abs(d - 1.0f) - vert.halfRing : d - 1.0f;
+                float alpha = clamp(0.5f - dist / vert.aaUnit, 0.0f, 1.0f);
+                return float4(vert.color.rgb, vert.color.a * alpha);
+            })";
+#endif
+
+        mSegmentShader = new Shader{mRenderPass, "vg_segments", segmentVertexShader, segmentFragmentShader, Shader::BlendMode::AlphaBlend};
+        mTriangleShader = new Shader{mRenderPass, "vg_triangles", triangleVertexShader, triangleFragmentShader, Shader::BlendMode::AlphaBlend};
+        mCircleShader = new Shader{mRenderPass, "vg_circles", circleVertexShader, circleFragmentShader, Shader::BlendMode::AlphaBlend};
+    } catch (const runtime_error& e) {
+        // Leave the shaders null; draw() then does nothing and the vector
+        // graphics overlay falls back to the NanoVG replay path.
+        tlog::error() << fmt::format("Unable to compile vector graphics shader: {}", e.what());
+    }
+}
+
+VectorGraphicsShader::~VectorGraphicsShader() { }
+
+void VectorGraphicsShader::draw(
+    const VgBatch& batch,
+    const Vector2f& transformScale,
+    const Vector2f& transformOffset,
+    const Vector2f& canvasSize,
+    float strokeWidth,
+    const Color& defaultColor
+) {
+    if (!batch.supported() || batch.empty()) {
+        return;
+    }
+
+    uploadIfChanged(batch);
+
+    if (mTriangleShader && mNumTriangleVertices > 0) {
+        mTriangleShader->set_uniform("transformScale", transformScale);
+        mTriangleShader->set_uniform("transformOffset", transformOffset);
+        mTriangleShader->set_uniform("defaultColor", defaultColor);
+
+        mTriangleShader->begin();
+        mTriangleShader->draw_array(Shader::PrimitiveType::Triangle, 0, mNumTriangleVertices, false);
+        mTriangleShader->end();
+    }
+
+    if (mCircleShader && mNumCircleVertices > 0) {
+        mCircleShader->set_uniform("transformScale", transformScale);
+        mCircleShader->set_uniform("transformOffset", transformOffset);
+        mCircleShader->set_uniform("canvasSize", canvasSize);
+        mCircleShader->set_uniform("strokeWidth", strokeWidth);
+        mCircleShader->set_uniform("defaultColor", defaultColor);
+
+        mCircleShader->begin();
+        mCircleShader->draw_array(Shader::PrimitiveType::Triangle, 0, mNumCircleVertices, false);
+        mCircleShader->end();
+    }
+
+    if (mSegmentShader && mNumSegmentVertices > 0) {
+        mSegmentShader->set_uniform("transformScale", transformScale);
+        mSegmentShader->set_uniform("transformOffset", transformOffset);
+        mSegmentShader->set_uniform("canvasSize", canvasSize);
+        mSegmentShader->set_uniform("strokeWidth", strokeWidth);
+        mSegmentShader->set_uniform("defaultColor", defaultColor);
+
+        mSegmentShader->begin();
+        mSegmentShader->draw_array(Shader::PrimitiveType::Triangle, 0, mNumSegmentVertices, false);
+        mSegmentShader->end();
+    }
+}
+
+void VectorGraphicsShader::uploadIfChanged(const VgBatch& batch) {
+    if (batch.generation() == mBoundGeneration) {
+        return;
+    }
+
+    mNumSegmentVertices = batch.segmentA().size() / 2;
+    if (mSegmentShader && mNumSegmentVertices > 0) {
+        mSegmentShader->set_buffer("posA", VariableType::Float32, {mNumSegmentVertices, 2}, batch.segmentA().data());
+        mSegmentShader->set_buffer("posB", VariableType::Float32, {mNumSegmentVertices, 2}, batch.segmentB().data());
+        mSegmentShader->set_buffer("param", VariableType::Float32, {mNumSegmentVertices, 2}, batch.segmentParam().data());
+        mSegmentShader->set_buffer("color", VariableType::Float32, {mNumSegmentVertices, 4}, batch.segmentColor().data());
+    }
+
+    mNumTriangleVertices = batch.trianglePos().size() / 2;
+    if (mTriangleShader && mNumTriangleVertices > 0) {
+        mTriangleShader->set_buffer("position", VariableType::Float32, {mNumTriangleVertices, 2}, batch.trianglePos().data());
+        mTriangleShader->set_buffer("color", VariableType::Float32, {mNumTriangleVertices, 4}, batch.triangleColor().data());
+    }
+
+    mNumCircleVertices = batch.circleCenter().size() / 2;
+    if (mCircleShader && mNumCircleVertices > 0) {
+        mCircleShader->set_buffer("center", VariableType::Float32, {mNumCircleVertices, 2}, batch.circleCenter().data());
+        mCircleShader->set_buffer("radius", VariableType::Float32, {mNumCircleVertices, 2}, batch.circleRadius().data());
+        mCircleShader->set_buffer("corner", VariableType::Float32, {mNumCircleVertices, 2}, batch.circleCorner().data());
+        mCircleShader->set_buffer("ring", VariableType::Float32, {mNumCircleVertices, 1}, batch.circleRing().data());
+        mCircleShader->set_buffer("color", VariableType::Float32, {mNumCircleVertices, 4}, batch.circleColor().data());
+    }
+
+    mBoundGeneration = batch.generation();
+}
+
+}
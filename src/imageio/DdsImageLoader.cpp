@@ -6,6 +6,8 @@
 
 #include <DirectXTex.h>
 
+#include <array>
+
 using namespace nanogui;
 using namespace std;
 
@@ -194,10 +196,49 @@ Task<vector<ImageData>> DdsImageLoader::load(istream& iStream, const fs::path&,
             throw invalid_argument{fmt::format("Unsupported DXGI format: {}", static_cast<int>(metadata.format))};
     }
 
-    // Use DirectXTex to either decompress or convert to the target floating point format.
+    // Use DirectXTex to either decompress or convert to the target format.
+    // Keeping BC data compressed all the way to the GPU is not an option in
+    // tev: pixel probing, statistics, and tonemapping all read decoded
+    // channels, and nanogui textures only accept uncompressed formats. What
+    // can be avoided is DirectXTex widening every block to float32 RGBA —
+    // a 16x inflation for BC7 — before a single pixel reaches the viewer:
+    // decode to the block format's natural output instead and widen (and
+    // linearize) in parallel ourselves.
+    bool decodedTo8Bit = false;
+    bool decodedToHalf = false;
     if (DirectX::IsCompressed(metadata.format)) {
+        DXGI_FORMAT decompFormat;
+        switch (metadata.format) {
+            case DXGI_FORMAT_BC6H_TYPELESS:
+            case DXGI_FORMAT_BC6H_UF16:
+            case DXGI_FORMAT_BC6H_SF16:
+                decompFormat = DXGI_FORMAT_R16G16B16A16_FLOAT;
+                decodedToHalf = true;
+                break;
+            case DXGI_FORMAT_BC1_TYPELESS:
+            case DXGI_FORMAT_BC1_UNORM:
+            case DXGI_FORMAT_BC1_UNORM_SRGB:
+            case DXGI_FORMAT_BC2_TYPELESS:
+            case DXGI_FORMAT_BC2_UNORM:
+            case DXGI_FORMAT_BC2_UNORM_SRGB:
+            case DXGI_FORMAT_BC3_TYPELESS:
+            case DXGI_FORMAT_BC3_UNORM:
+            case DXGI_FORMAT_BC3_UNORM_SRGB:
+            case DXGI_FORMAT_BC7_TYPELESS:
+            case DXGI_FORMAT_BC7_UNORM:
+            case DXGI_FORMAT_BC7_UNORM_SRGB:
+                decompFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+                decodedTo8Bit = true;
+                break;
+            default:
+                // One- and two-channel formats (BC4/BC5) inflate little;
+                // decode those to floats directly.
+                decompFormat = format;
+                break;
+        }
+
         DirectX::ScratchImage decompImage;
-        if (DirectX::Decompress(*scratchImage.GetImage(0, 0, 0), format, decompImage) != S_OK) {
+        if (DirectX::Decompress(*scratchImage.GetImage(0, 0, 0), decompFormat, decompImage) != S_OK) {
             throw invalid_argument{"Failed to decompress DDS image."};
         }
         std::swap(scratchImage, decompImage);
@@ -209,7 +250,11 @@ Task<vector<ImageData>> DdsImageLoader::load(istream& iStream, const fs::path&,
         std::swap(scratchImage, convertedImage);
     }
 
-    resultData.channels = makeNChannels(numChannels, { (int)metadata.width, (int)metadata.height });
+    // 8-bit and half sources lose nothing from half-precision channel
+    // storage, which halves the resident footprint of large texture sets.
+    EPixelFormat pixelFormat =
+        Channel::halfPrecisionStorage() && (decodedTo8Bit || decodedToHalf) ? EPixelFormat::F16 : EPixelFormat::F32;
+    resultData.channels = makeNChannels(numChannels, { (int)metadata.width, (int)metadata.height }, pixelFormat);
 
     auto numPixels = (size_t)metadata.width * metadata.height;
     if (numPixels == 0) {
@@ -218,7 +263,40 @@ Task<vector<ImageData>> DdsImageLoader::load(istream& iStream, const fs::path&,
 
     bool isFloat = DirectX::FormatDataType(metadata.format) == DirectX::FORMAT_TYPE_FLOAT;
 
-    if (isFloat || numChannels < 3) {
+    if (decodedTo8Bit) {
+        // The same sRGB-by-convention reasoning as in the generic path below
+        // applies; a 256-entry table is far cheaper than pow() per pixel.
+        array<float, 256> srgbToLinearTable;
+        for (int i = 0; i < 256; ++i) {
+            srgbToLinearTable[i] = toLinear(i / 255.0f);
+        }
+
+        auto typedData = reinterpret_cast<const uint8_t*>(scratchImage.GetPixels());
+        co_await ThreadPool::global().parallelForAsync<size_t>(0, numPixels, [&](size_t i) {
+            size_t baseIdx = i * 4;
+            for (int c = 0; c < numChannels; ++c) {
+                float val = c == 3 ? (typedData[baseIdx + 3] / 255.0f) : srgbToLinearTable[typedData[baseIdx + c]];
+                if (pixelFormat == EPixelFormat::F16) {
+                    resultData.channels[c].halfData()[i] = floatToHalf(val);
+                } else {
+                    resultData.channels[c].at(i) = val;
+                }
+            }
+        }, priority);
+    } else if (decodedToHalf) {
+        // BC6H holds linear half floats, which match F16 storage bit for bit.
+        auto typedData = reinterpret_cast<const uint16_t*>(scratchImage.GetPixels());
+        co_await ThreadPool::global().parallelForAsync<size_t>(0, numPixels, [&](size_t i) {
+            size_t baseIdx = i * 4;
+            for (int c = 0; c < numChannels; ++c) {
+                if (pixelFormat == EPixelFormat::F16) {
+                    resultData.channels[c].halfData()[i] = typedData[baseIdx + c];
+                } else {
+                    resultData.channels[c].at(i) = halfToFloat(typedData[baseIdx + c]);
+                }
+            }
+        }, priority);
+    } else if (isFloat || numChannels < 3) {
         assert(!DirectX::IsSRGB(metadata.format));
         // Assume that the image data is already in linear space.
         auto typedData = reinterpret_cast<float*>(scratchImage.GetPixels());
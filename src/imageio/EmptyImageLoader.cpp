@@ -51,8 +51,11 @@ Task<vector<ImageData>> EmptyImageLoader::load(istream& iStream, const fs::path&
 
         string channelName = channelNameData.data();
 
-        data.channels.emplace_back(Channel{channelName, size});
-        data.channels.back().setZero();
+        // Channels of a freshly created image are all zero; defer their buffer
+        // allocation until the first UpdateImage write materializes them. This
+        // makes creating e.g. dozens of multi-AOV placeholder images free
+        // rather than costing gigabytes of zeroed memory up front.
+        data.channels.emplace_back(Channel{channelName, size, EPixelFormat::F32, true});
     }
 
     data.hasPremultipliedAlpha = true;
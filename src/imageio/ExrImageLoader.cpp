@@ -13,9 +13,17 @@
 #include <Iex.h>
 
 #include <istream>
+#include <memory>
 
 #include <errno.h>
 
+#ifndef _WIN32
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
 using namespace nanogui;
 using namespace std;
 
@@ -75,6 +83,118 @@ private:
     istream& mStream;
 };
 
+// Memory-mapped input stream that lets OpenEXR decompress straight out of
+// the page cache without any intermediate buffered copies.
+class MmapIStream: public Imf::IStream
+{
+public:
+    MmapIStream(const fs::path& path)
+    : Imf::IStream{toString(path).c_str()} {
+#ifdef _WIN32
+        mFile = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (mFile == INVALID_HANDLE_VALUE) {
+            throw runtime_error{fmt::format("Could not open {} for memory mapping.", path)};
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(mFile, &size) || size.QuadPart == 0) {
+            CloseHandle(mFile);
+            throw runtime_error{fmt::format("Could not obtain size of {}.", path)};
+        }
+
+        mSize = (size_t)size.QuadPart;
+
+        mMapping = CreateFileMappingW(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mMapping) {
+            CloseHandle(mFile);
+            throw runtime_error{fmt::format("Could not create file mapping of {}.", path)};
+        }
+
+        mData = (char*)MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0);
+        if (!mData) {
+            CloseHandle(mMapping);
+            CloseHandle(mFile);
+            throw runtime_error{fmt::format("Could not map view of {}.", path)};
+        }
+#else
+        mFd = open(path.c_str(), O_RDONLY);
+        if (mFd < 0) {
+            throw runtime_error{fmt::format("Could not open {} for memory mapping: {}", path, errorString(errno))};
+        }
+
+        struct stat sb;
+        if (fstat(mFd, &sb) < 0 || sb.st_size == 0) {
+            close(mFd);
+            throw runtime_error{fmt::format("Could not obtain size of {}.", path)};
+        }
+
+        mSize = (size_t)sb.st_size;
+
+        mData = (char*)mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, mFd, 0);
+        if (mData == MAP_FAILED) {
+            close(mFd);
+            throw runtime_error{fmt::format("Could not memory-map {}: {}", path, errorString(errno))};
+        }
+#endif
+    }
+
+    ~MmapIStream() override {
+#ifdef _WIN32
+        UnmapViewOfFile(mData);
+        CloseHandle(mMapping);
+        CloseHandle(mFile);
+#else
+        munmap(mData, mSize);
+        close(mFd);
+#endif
+    }
+
+    bool isMemoryMapped() const override {
+        return true;
+    }
+
+    char* readMemoryMapped(int n) override {
+        if (mPos + n > mSize) {
+            throw IEX_NAMESPACE::InputExc("Unexpected end of file.");
+        }
+
+        char* result = mData + mPos;
+        mPos += n;
+        return result;
+    }
+
+    bool read(char c[/*n*/], int n) override {
+        if (mPos + n > mSize) {
+            throw IEX_NAMESPACE::InputExc("Unexpected end of file.");
+        }
+
+        memcpy(c, mData + mPos, n);
+        mPos += n;
+        return mPos < mSize;
+    }
+
+    Imf::Int64 tellg() override {
+        return mPos;
+    }
+
+    void seekg(Imf::Int64 pos) override {
+        mPos = pos;
+    }
+
+    void clear() override {}
+
+private:
+#ifdef _WIN32
+    HANDLE mFile = INVALID_HANDLE_VALUE;
+    HANDLE mMapping = nullptr;
+#else
+    int mFd = -1;
+#endif
+    char* mData = nullptr;
+    size_t mSize = 0;
+    size_t mPos = 0;
+};
+
 bool ExrImageLoader::canLoadFile(istream& iStream) const {
     // Taken from http://www.openexr.com/ReadingAndWritingImageFiles.pdf
     char b[4];
@@ -108,26 +228,47 @@ public:
     }
 
     template <typename T>
-    Task<void> copyToTyped(Channel& channel, int priority) const {
+    Task<void> copyToTyped(Channel& channel, int yBegin, int yEnd, int priority) const {
         int width = channel.size().x();
         int widthSubsampled = width/mImfChannel.ySampling;
 
         auto data = reinterpret_cast<const T*>(mData.data());
-        co_await ThreadPool::global().parallelForAsync<int>(0, channel.size().y(), [&, data](int y) {
+        co_await ThreadPool::global().parallelForAsync<int>(yBegin, yEnd, [&, data](int y) {
             for (int x = 0; x < width; ++x) {
                 channel.at({x, y}) = data[x/mImfChannel.xSampling + (y/mImfChannel.ySampling) * widthSubsampled];
             }
         }, priority);
     }
 
-    Task<void> copyTo(Channel& channel, int priority) const {
+    // For half-precision channels that keep half-precision storage,
+    // the raw bits can be copied over without any conversion.
+    Task<void> copyToHalf(Channel& channel, int yBegin, int yEnd, int priority) const {
+        int width = channel.size().x();
+        int widthSubsampled = width/mImfChannel.ySampling;
+
+        auto data = reinterpret_cast<const uint16_t*>(mData.data());
+        auto& dst = channel.halfData();
+        co_await ThreadPool::global().parallelForAsync<int>(yBegin, yEnd, [&, data](int y) {
+            for (int x = 0; x < width; ++x) {
+                dst[x + (size_t)y * width] = data[x/mImfChannel.xSampling + (y/mImfChannel.ySampling) * widthSubsampled];
+            }
+        }, priority);
+    }
+
+    // Copies the given range of scanlines (in channel space) into the channel.
+    Task<void> copyTo(Channel& channel, int yBegin, int yEnd, int priority) const {
         switch (mImfChannel.type) {
             case Imf::HALF:
-                co_await copyToTyped<::half>(channel, priority); break;
+                if (channel.format() == EPixelFormat::F16) {
+                    co_await copyToHalf(channel, yBegin, yEnd, priority);
+                } else {
+                    co_await copyToTyped<::half>(channel, yBegin, yEnd, priority);
+                }
+                break;
             case Imf::FLOAT:
-                co_await copyToTyped<float>(channel, priority); break;
+                co_await copyToTyped<float>(channel, yBegin, yEnd, priority); break;
             case Imf::UINT:
-                co_await copyToTyped<uint32_t>(channel, priority); break;
+                co_await copyToTyped<uint32_t>(channel, yBegin, yEnd, priority); break;
             default:
                 throw runtime_error("Invalid pixel type encountered.");
         }
@@ -137,6 +278,15 @@ public:
         return mPartId;
     }
 
+    // The cheapest in-memory representation that is faithful to the source data.
+    EPixelFormat preferredPixelFormat() const {
+        if (Channel::halfPrecisionStorage() && mImfChannel.type == Imf::HALF) {
+            return EPixelFormat::F16;
+        }
+
+        return EPixelFormat::F32;
+    }
+
     const string& name() const {
         return mName;
     }
@@ -167,8 +317,23 @@ private:
 Task<vector<ImageData>> ExrImageLoader::load(istream& iStream, const fs::path& path, const string& channelSelector, int priority) const {
     vector<ImageData> result;
 
-    StdIStream stdIStream{iStream, toString(path).c_str()};
-    Imf::MultiPartInputFile multiPartFile{stdIStream};
+    // Prefer a zero-copy memory-mapped stream when the source is a real file.
+    // Loads from stdin or other non-file streams fall back to the adapter below.
+    unique_ptr<Imf::IStream> imfIStream;
+    std::error_code ec;
+    if (fs::is_regular_file(path, ec)) {
+        try {
+            imfIStream = make_unique<MmapIStream>(path);
+        } catch (const runtime_error& e) {
+            tlog::warning() << e.what() << " Falling back to buffered reading.";
+        }
+    }
+
+    if (!imfIStream) {
+        imfIStream = make_unique<StdIStream>(iStream, toString(path).c_str());
+    }
+
+    Imf::MultiPartInputFile multiPartFile{*imfIStream};
     int numParts = multiPartFile.parts();
 
     if (numParts <= 0) {
@@ -180,6 +345,10 @@ Task<vector<ImageData>> ExrImageLoader::load(istream& iStream, const fs::path& p
 
     vector<RawChannel> rawChannels;
 
+    // Compiled once up front; the selector is matched against every channel
+    // of every part.
+    FuzzyMatcher channelMatcher{channelSelector};
+
     // Load all parts that match the channel selector
     for (int partIdx = 0; partIdx < numParts; ++partIdx) {
         Imf::InputPart part{multiPartFile, partIdx};
@@ -205,7 +374,7 @@ Task<vector<ImageData>> ExrImageLoader::load(istream& iStream, const fs::path& p
         bool matched = false;
         for (Imf::ChannelList::ConstIterator c = imfChannels.begin(); c != imfChannels.end(); ++c) {
             string name = channelName(c);
-            if (matchesFuzzy(name, channelSelector)) {
+            if (channelMatcher.matches(name)) {
                 rawChannels.emplace_back(parts.size(), name, c.name(), c.channel(), size);
                 matched = true;
             }
@@ -262,7 +431,6 @@ Task<vector<ImageData>> ExrImageLoader::load(istream& iStream, const fs::path& p
         }
 
         part.setFrameBuffer(frameBuffers.at(partIdx));
-        part.readPixels(dataWindow.min.y, dataWindow.max.y);
 
         data.hasPremultipliedAlpha = true;
         if (part.header().hasName()) {
@@ -300,17 +468,53 @@ Task<vector<ImageData>> ExrImageLoader::load(istream& iStream, const fs::path& p
         auto& rawChannel = rawChannels.at(i);
         auto& data = result.at(rawChannel.partId());
         channelMapping.emplace_back(data.channels.size());
-        data.channels.emplace_back(Channel{rawChannel.name(), rawChannel.size()});
+        data.channels.emplace_back(Channel{rawChannel.name(), rawChannel.size(), rawChannel.preferredPixelFormat()});
     }
 
+    // Decode scanlines in chunks rather than in one blocking shot. Copying each
+    // freshly decoded chunk into its channels overlaps with decompression of the
+    // next chunk, so the top of an 8K image is available long before the bottom
+    // has even been read from disk.
+    static const int CHUNK_HEIGHT = 256;
+
+    // readPixels() throws on truncated or corrupt files — routine input given
+    // that watched files get rewritten in place. Copy tasks already in flight
+    // write into `result`'s channel buffers, so no exception may unwind past
+    // them before they are drained; since co_await is not allowed inside a
+    // catch block, the error is stashed and rethrown after the join.
+    exception_ptr decodeError;
+
     vector<Task<void>> tasks;
-    for (size_t i = 0; i < rawChannels.size(); ++i) {
-        auto& rawChannel = rawChannels.at(i);
-        tasks.emplace_back(rawChannel.copyTo(result.at(rawChannel.partId()).channels.at(channelMapping.at(i)), priority));
+    try {
+        for (size_t partIdx = 0; partIdx < parts.size(); ++partIdx) {
+            auto& part = parts.at(partIdx);
+            Imath::Box2i dw = part.header().dataWindow();
+
+            for (int y = dw.min.y; y <= dw.max.y; y += CHUNK_HEIGHT) {
+                int yEnd = min(y + CHUNK_HEIGHT - 1, dw.max.y);
+                part.readPixels(y, yEnd);
+
+                for (size_t i = 0; i < rawChannels.size(); ++i) {
+                    auto& rawChannel = rawChannels.at(i);
+                    if (rawChannel.partId() != partIdx) {
+                        continue;
+                    }
+
+                    tasks.emplace_back(rawChannel.copyTo(
+                        result.at(partIdx).channels.at(channelMapping.at(i)),
+                        y - dw.min.y, yEnd - dw.min.y + 1, priority
+                    ));
+                }
+            }
+        }
+    } catch (...) {
+        decodeError = current_exception();
     }
 
-    for (auto& task : tasks) {
-        co_await task;
+    co_await whenAll(tasks);
+
+    if (decodeError) {
+        rethrow_exception(decodeError);
     }
 
     co_return result;
@@ -4,11 +4,13 @@
 #include <tev/imageio/ExrImageSaver.h>
 
 #include <ImfChannelList.h>
+#include <ImfFloatAttribute.h>
 #include <ImfOutputFile.h>
 #include <ImfInputPart.h>
 #include <ImfMultiPartInputFile.h>
 #include <Iex.h>
 
+#include <algorithm>
 #include <ostream>
 #include <string>
 #include <vector>
@@ -58,21 +60,38 @@ private:
     ostream& mStream;
 };
 
-void ExrImageSaver::save(ostream& oStream, const fs::path& path, const vector<float>& data, const Vector2i& imageSize, int nChannels) const {
-    vector<string> channelNames = {
-        "R", "G", "B", "A",
-    };
+static const vector<string> EXR_CHANNEL_NAMES = {
+    "R", "G", "B", "A",
+};
 
+static Imf::Header makeHeader(const Vector2i& imageSize, int nChannels, EExrCompression compression, float dwaQuality) {
+    Imf::Header header{imageSize.x(), imageSize.y()};
+    switch (compression) {
+        case EExrCompression::Zip: header.compression() = Imf::ZIP_COMPRESSION; break;
+        case EExrCompression::Piz: header.compression() = Imf::PIZ_COMPRESSION; break;
+        case EExrCompression::Dwaa:
+            header.compression() = Imf::DWAA_COMPRESSION;
+            header.insert("dwaCompressionLevel", Imf::FloatAttribute{dwaQuality});
+            break;
+    }
+
+    for (int i = 0; i < nChannels; ++i) {
+        header.channels().insert(EXR_CHANNEL_NAMES[i], Imf::Channel(Imf::FLOAT));
+    }
+
+    return header;
+}
+
+void ExrImageSaver::save(ostream& oStream, const fs::path& path, const vector<float>& data, const Vector2i& imageSize, int nChannels) const {
     if (nChannels <= 0 || nChannels > 4) {
         throw invalid_argument{fmt::format("Invalid number of channels {}.", nChannels)};
     }
 
-    Imf::Header header{imageSize.x(), imageSize.y()};
+    Imf::Header header = makeHeader(imageSize, nChannels, mCompression, mDwaQuality);
     Imf::FrameBuffer frameBuffer;
 
     for (int i = 0; i < nChannels; ++i) {
-        header.channels().insert(channelNames[i], Imf::Channel(Imf::FLOAT));
-        frameBuffer.insert(channelNames[i], Imf::Slice(
+        frameBuffer.insert(EXR_CHANNEL_NAMES[i], Imf::Slice(
             Imf::FLOAT, // Type
             (char*)(data.data() + i), // Base pointer
             sizeof(float) * nChannels, // x-stride in bytes
@@ -80,10 +99,50 @@ void ExrImageSaver::save(ostream& oStream, const fs::path& path, const vector<fl
         ));
     }
 
+    // The slices point directly into the caller's interleaved data, so
+    // writePixels streams scanline blocks straight from it with no
+    // intermediate copy and compresses them on OpenEXR's global thread pool.
     StdOStream imfOStream{oStream, toString(path).c_str()};
     Imf::OutputFile file{imfOStream, header};
     file.setFrameBuffer(frameBuffer);
     file.writePixels(imageSize.y());
 }
 
+void ExrImageSaver::save(ostream& oStream, const fs::path& path, const RowSource& rowSource, const Vector2i& imageSize, int nChannels) const {
+    if (nChannels <= 0 || nChannels > 4) {
+        throw invalid_argument{fmt::format("Invalid number of channels {}.", nChannels)};
+    }
+
+    Imf::Header header = makeHeader(imageSize, nChannels, mCompression, mDwaQuality);
+
+    StdOStream imfOStream{oStream, toString(path).c_str()};
+    Imf::OutputFile file{imfOStream, header};
+
+    // Pull batches of scanlines through `rowSource` right before they are
+    // compressed; only one batch is ever staged in memory.
+    constexpr int BATCH_SIZE_ROWS = 512;
+    vector<float> batch((size_t)imageSize.x() * min(BATCH_SIZE_ROWS, imageSize.y()) * nChannels);
+
+    for (int beginRow = 0; beginRow < imageSize.y(); beginRow += BATCH_SIZE_ROWS) {
+        int numRows = min(BATCH_SIZE_ROWS, imageSize.y() - beginRow);
+        rowSource(batch.data(), beginRow, numRows);
+
+        Imf::FrameBuffer frameBuffer;
+        for (int i = 0; i < nChannels; ++i) {
+            // The base pointer is offset backwards such that OpenEXR's
+            // addressing of rows [beginRow, beginRow + numRows) lands within
+            // the batch buffer.
+            frameBuffer.insert(EXR_CHANNEL_NAMES[i], Imf::Slice(
+                Imf::FLOAT, // Type
+                (char*)(batch.data() + i) - (size_t)beginRow * sizeof(float) * imageSize.x() * nChannels, // Base pointer
+                sizeof(float) * nChannels, // x-stride in bytes
+                sizeof(float) * imageSize.x() * nChannels // y-stride in bytes
+            ));
+        }
+
+        file.setFrameBuffer(frameBuffer);
+        file.writePixels(numRows);
+    }
+}
+
 }
@@ -36,16 +36,16 @@ const vector<unique_ptr<ImageLoader>>& ImageLoader::getLoaders() {
     return imageLoaders;
 }
 
-vector<Channel> ImageLoader::makeNChannels(int numChannels, const Vector2i& size) {
+vector<Channel> ImageLoader::makeNChannels(int numChannels, const Vector2i& size, EPixelFormat format) {
     vector<Channel> channels;
     if (numChannels > 1) {
         const vector<string> channelNames = {"R", "G", "B", "A"};
         for (int c = 0; c < numChannels; ++c) {
             string name = c < (int)channelNames.size() ? channelNames[c] : to_string(c);
-            channels.emplace_back(name, size);
+            channels.emplace_back(name, size, format);
         }
     } else {
-        channels.emplace_back("L", size);
+        channels.emplace_back("L", size, format);
     }
 
     return channels;
@@ -17,7 +17,8 @@ bool QoiImageLoader::canLoadFile(istream& iStream) const {
     char b[4];
     iStream.read(b, sizeof(b));
 
-    bool result = !!iStream && iStream.gcount() == sizeof(b) && string(b, sizeof(b)) == "qoif";
+    // "qoic" is tev's own chunked container of QOI stripes; see QoiImageSaver.
+    bool result = !!iStream && iStream.gcount() == sizeof(b) && (string(b, sizeof(b)) == "qoif" || string(b, sizeof(b)) == "qoic");
 
     iStream.clear();
     iStream.seekg(0);
@@ -32,7 +33,7 @@ Task<vector<ImageData>> QoiImageLoader::load(istream& iStream, const fs::path&,
     iStream.read(magic, 4);
     string magicString(magic, 4);
 
-    if (magicString != "qoif") {
+    if (magicString != "qoif" && magicString != "qoic") {
         throw invalid_argument{fmt::format("Invalid magic QOI string {}", magicString)};
     }
 
@@ -44,12 +45,98 @@ Task<vector<ImageData>> QoiImageLoader::load(istream& iStream, const fs::path&,
     iStream.read(data.data(), dataSize);
 
     qoi_desc desc;
-    void* decodedData = qoi_decode(data.data(), static_cast<int>(dataSize), &desc, 0);
+    void* decodedData = nullptr;
+    ScopeGuard decodedDataGuard{[&decodedData] { free(decodedData); }};
+
+    vector<unsigned char> chunkedPixels;
+    unsigned char* typedData;
+
+    if (magicString == "qoic") {
+        // tev's chunked container (see QoiImageSaver): a little-endian uint32
+        // stripe count and per-stripe byte sizes, followed by each horizontal
+        // stripe as a self-contained plain QOI stream. The stripes are
+        // independent, so they decode in parallel on the thread pool.
+        auto readUint32 = [&](size_t offset) {
+            auto bytes = reinterpret_cast<const unsigned char*>(data.data()) + offset;
+            return (uint32_t)bytes[0] | ((uint32_t)bytes[1] << 8) | ((uint32_t)bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+        };
+
+        auto readUint32BigEndian = [&](size_t offset) {
+            auto bytes = reinterpret_cast<const unsigned char*>(data.data()) + offset;
+            return ((uint32_t)bytes[0] << 24) | ((uint32_t)bytes[1] << 16) | ((uint32_t)bytes[2] << 8) | (uint32_t)bytes[3];
+        };
+
+        if (dataSize < 8) {
+            throw invalid_argument{"Truncated chunked QOI container."};
+        }
+
+        size_t numStripes = readUint32(4);
+        size_t indexEnd = 8 + numStripes * 4;
+        if (numStripes == 0 || dataSize < indexEnd) {
+            throw invalid_argument{"Truncated chunked QOI container."};
+        }
+
+        // Validate the stripe headers up front such that the full image can be
+        // allocated in one piece before any stripe is decoded. The QOI header
+        // is 14 bytes: magic, big-endian width and height, channels, colorspace.
+        vector<size_t> stripeOffsets(numStripes);
+        vector<size_t> stripeRowOffsets(numStripes);
+        size_t offset = indexEnd;
+        size_t totalHeight = 0;
+        for (size_t i = 0; i < numStripes; ++i) {
+            size_t stripeSize = readUint32(8 + i * 4);
+            if (offset + stripeSize > dataSize || stripeSize < 14 || string(data.data() + offset, 4) != "qoif") {
+                throw invalid_argument{"Invalid stripe in chunked QOI container."};
+            }
+
+            uint32_t stripeWidth = readUint32BigEndian(offset + 4);
+            uint32_t stripeHeight = readUint32BigEndian(offset + 8);
+            unsigned char stripeChannels = data[offset + 12];
+            if (i == 0) {
+                desc = {stripeWidth, 0, stripeChannels, (unsigned char)data[offset + 13]};
+            } else if (stripeWidth != desc.width || stripeChannels != desc.channels) {
+                throw invalid_argument{"Mismatched stripes in chunked QOI container."};
+            }
+
+            stripeOffsets[i] = offset;
+            stripeRowOffsets[i] = totalHeight;
+            totalHeight += stripeHeight;
+            offset += stripeSize;
+        }
+
+        desc.height = (unsigned int)totalHeight;
+        chunkedPixels.resize((size_t)desc.width * desc.height * desc.channels);
+
+        atomic<bool> failed{false};
+        co_await ThreadPool::global().parallelForAsync<size_t>(0, numStripes, [&](size_t i) {
+            size_t stripeSize = readUint32(8 + i * 4);
+            qoi_desc stripeDesc;
+            void* stripeData = qoi_decode(data.data() + stripeOffsets[i], static_cast<int>(stripeSize), &stripeDesc, 0);
+            if (!stripeData) {
+                failed = true;
+                return;
+            }
 
-    ScopeGuard decodedDataGuard{[decodedData] { free(decodedData); }};
+            memcpy(
+                chunkedPixels.data() + stripeRowOffsets[i] * desc.width * desc.channels,
+                stripeData,
+                (size_t)stripeDesc.width * stripeDesc.height * stripeDesc.channels
+            );
+            free(stripeData);
+        }, priority);
+
+        if (failed) {
+            throw invalid_argument{"Failed to decode data from the QOI format."};
+        }
+
+        typedData = chunkedPixels.data();
+    } else {
+        decodedData = qoi_decode(data.data(), static_cast<int>(dataSize), &desc, 0);
+        if (!decodedData) {
+            throw invalid_argument{"Failed to decode data from the QOI format."};
+        }
 
-    if (!decodedData) {
-        throw invalid_argument{"Failed to decode data from the QOI format."};
+        typedData = reinterpret_cast<unsigned char*>(decodedData);
     }
 
     Vector2i size{static_cast<int>(desc.width), static_cast<int>(desc.height)};
@@ -68,7 +155,6 @@ Task<vector<ImageData>> QoiImageLoader::load(istream& iStream, const fs::path&,
 
     if (desc.colorspace == QOI_LINEAR) {
         co_await ThreadPool::global().parallelForAsync<size_t>(0, numPixels, [&](size_t i) {
-            auto typedData = reinterpret_cast<unsigned char*>(decodedData);
             size_t baseIdx = i * numChannels;
             for (int c = 0; c < numChannels; ++c) {
                 resultData.channels[c].at(i) = (typedData[baseIdx + c]) / 255.0f;
@@ -76,7 +162,6 @@ Task<vector<ImageData>> QoiImageLoader::load(istream& iStream, const fs::path&,
         }, priority);
     } else {
         co_await ThreadPool::global().parallelForAsync<size_t>(0, numPixels, [&](size_t i) {
-            auto typedData = reinterpret_cast<unsigned char*>(decodedData);
             size_t baseIdx = i * numChannels;
             for (int c = 0; c < numChannels; ++c) {
                 if (c == 3) {
@@ -2,10 +2,12 @@
 // It is published under the BSD 3-Clause License within the LICENSE file.
 
 #include <tev/imageio/QoiImageSaver.h>
+#include <tev/ThreadPool.h>
 
 #define QOI_NO_STDIO
 #include <qoi.h>
 
+#include <limits>
 #include <ostream>
 #include <vector>
 
@@ -20,22 +22,89 @@ void QoiImageSaver::save(ostream& oStream, const fs::path&, const vector<char>&
         throw invalid_argument{fmt::format("Invalid number of channels {}.", nChannels)};
     }
 
-    const qoi_desc desc{
-        .width = static_cast<unsigned int>(imageSize.x()),
-        .height = static_cast<unsigned int>(imageSize.y()),
-        .channels = static_cast<unsigned char>(nChannels),
-        .colorspace = QOI_SRGB,
-    };
-    int sizeInBytes = 0;
-    void *encodedData = qoi_encode(data.data(), &desc, &sizeInBytes);
+    // Large canvases (5K screenshots and up) take noticeably long to push
+    // through the single-threaded reference qoi encoder. Above this threshold
+    // we therefore write a chunked container: the magic "qoic", a little-endian
+    // uint32 stripe count, the byte size of each stripe, and then each
+    // horizontal stripe as a self-contained plain QOI stream, encoded in
+    // parallel. Only tev reads this container, so smaller images — where the
+    // encode is fast anyway — keep the plain, universally readable QOI format.
+    constexpr size_t CHUNKED_THRESHOLD_PIXELS = 1 << 21;
+    constexpr int MIN_STRIPE_HEIGHT = 64;
+
+    auto numPixels = (size_t)imageSize.x() * imageSize.y();
+    if (numPixels < CHUNKED_THRESHOLD_PIXELS) {
+        const qoi_desc desc{
+            .width = static_cast<unsigned int>(imageSize.x()),
+            .height = static_cast<unsigned int>(imageSize.y()),
+            .channels = static_cast<unsigned char>(nChannels),
+            .colorspace = QOI_SRGB,
+        };
+        int sizeInBytes = 0;
+        void *encodedData = qoi_encode(data.data(), &desc, &sizeInBytes);
+
+        ScopeGuard encodedDataGuard{[encodedData] { free(encodedData); }};
+
+        if (!encodedData) {
+            throw invalid_argument{"Failed to encode data into the QOI format."};
+        }
+
+        oStream.write(reinterpret_cast<char*>(encodedData), sizeInBytes);
+        return;
+    }
+
+    int numStripes = (int)min(ThreadPool::global().numThreads(), (size_t)((imageSize.y() + MIN_STRIPE_HEIGHT - 1) / MIN_STRIPE_HEIGHT));
+    numStripes = max(numStripes, 1);
+    int stripeHeight = (imageSize.y() + numStripes - 1) / numStripes;
+    numStripes = (imageSize.y() + stripeHeight - 1) / stripeHeight;
 
-    ScopeGuard encodedDataGuard{[encodedData] { free(encodedData); }};
+    vector<vector<char>> stripes(numStripes);
+    ThreadPool::global().parallelFor(0, numStripes, [&](int i) {
+        int beginRow = i * stripeHeight;
+        int numRows = min(stripeHeight, imageSize.y() - beginRow);
 
-    if (!encodedData) {
-        throw invalid_argument{"Failed to encode data into the QOI format."};
+        const qoi_desc desc{
+            .width = static_cast<unsigned int>(imageSize.x()),
+            .height = static_cast<unsigned int>(numRows),
+            .channels = static_cast<unsigned char>(nChannels),
+            .colorspace = QOI_SRGB,
+        };
+        int sizeInBytes = 0;
+        void* encodedData = qoi_encode(data.data() + (size_t)beginRow * imageSize.x() * nChannels, &desc, &sizeInBytes);
+        if (!encodedData) {
+            // Failure is signalled by the stripe staying empty.
+            return;
+        }
+
+        ScopeGuard encodedDataGuard{[encodedData] { free(encodedData); }};
+        stripes[i].assign(reinterpret_cast<char*>(encodedData), reinterpret_cast<char*>(encodedData) + sizeInBytes);
+    }, numeric_limits<int>::max());
+
+    for (const auto& stripe : stripes) {
+        if (stripe.empty()) {
+            throw invalid_argument{"Failed to encode data into the QOI format."};
+        }
     }
 
-    oStream.write(reinterpret_cast<char*>(encodedData), sizeInBytes);
+    auto writeUint32 = [&](uint32_t value) {
+        char bytes[4] = {
+            (char)(value & 0xff),
+            (char)((value >> 8) & 0xff),
+            (char)((value >> 16) & 0xff),
+            (char)((value >> 24) & 0xff),
+        };
+        oStream.write(bytes, sizeof(bytes));
+    };
+
+    oStream.write("qoic", 4);
+    writeUint32((uint32_t)numStripes);
+    for (const auto& stripe : stripes) {
+        writeUint32((uint32_t)stripe.size());
+    }
+
+    for (const auto& stripe : stripes) {
+        oStream.write(stripe.data(), stripe.size());
+    }
 }
 
 }
@@ -6,6 +6,8 @@
 
 #include <stb_image.h>
 
+#include <array>
+
 using namespace nanogui;
 using namespace std;
 
@@ -61,7 +63,10 @@ Task<vector<ImageData>> StbiImageLoader::load(istream& iStream, const fs::path&,
 
     ScopeGuard dataGuard{[data] { stbi_image_free(data); }};
 
-    resultData.channels = makeNChannels(numChannels, size);
+    // 8-bit sources lose nothing from half-precision channel storage, which
+    // halves the resident footprint when loading whole directories of photos.
+    EPixelFormat pixelFormat = !isHdr && Channel::halfPrecisionStorage() ? EPixelFormat::F16 : EPixelFormat::F32;
+    resultData.channels = makeNChannels(numChannels, size, pixelFormat);
     int alphaChannelIndex = 3;
 
     auto numPixels = (size_t)size.x() * size.y();
@@ -74,14 +79,43 @@ Task<vector<ImageData>> StbiImageLoader::load(istream& iStream, const fs::path&,
             }
         }, priority);
     } else {
-        co_await ThreadPool::global().parallelForAsync<size_t>(0, numPixels, [&](size_t i) {
-            auto typedData = reinterpret_cast<unsigned char*>(data);
-            size_t baseIdx = i * numChannels;
+        // 8-bit data only takes 256 distinct values, so the sRGB-to-linear
+        // pow() — and, for half-precision storage, the float-to-half
+        // conversion — is precomputed into tables once per image rather than
+        // evaluated per pixel. The row loops below then reduce to table
+        // gathers and deinterleaving stores, which is what LDR load time is
+        // dominated by once stbi has done its part.
+        array<float, 256> srgbToLinearTable, unormTable;
+        for (int i = 0; i < 256; ++i) {
+            srgbToLinearTable[i] = toLinear(i / 255.0f);
+            unormTable[i] = i / 255.0f;
+        }
+
+        array<uint16_t, 256> srgbToLinearTableHalf, unormTableHalf;
+        if (pixelFormat == EPixelFormat::F16) {
+            for (int i = 0; i < 256; ++i) {
+                srgbToLinearTableHalf[i] = floatToHalf(srgbToLinearTable[i]);
+                unormTableHalf[i] = floatToHalf(unormTable[i]);
+            }
+        }
+
+        auto typedData = reinterpret_cast<const unsigned char*>(data);
+        co_await ThreadPool::global().parallelForAsync<int>(0, size.y(), [&](int y) {
+            size_t rowBase = (size_t)y * size.x();
+            const unsigned char* src = typedData + rowBase * numChannels;
             for (int c = 0; c < numChannels; ++c) {
-                if (c == alphaChannelIndex) {
-                    resultData.channels[c].at(i) = (typedData[baseIdx + c]) / 255.0f;
+                if (pixelFormat == EPixelFormat::F16) {
+                    const auto& table = c == alphaChannelIndex ? unormTableHalf : srgbToLinearTableHalf;
+                    uint16_t* dst = resultData.channels[c].halfData().data() + rowBase;
+                    for (int x = 0; x < size.x(); ++x) {
+                        dst[x] = table[src[(size_t)x * numChannels + c]];
+                    }
                 } else {
-                    resultData.channels[c].at(i) = toLinear((typedData[baseIdx + c]) / 255.0f);
+                    const auto& table = c == alphaChannelIndex ? unormTable : srgbToLinearTable;
+                    float* dst = &resultData.channels[c].at(rowBase);
+                    for (int x = 0; x < size.x(); ++x) {
+                        dst[x] = table[src[(size_t)x * numChannels + c]];
+                    }
                 }
             }
         }, priority);
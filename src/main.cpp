@@ -2,9 +2,13 @@
 // It is published under the BSD 3-Clause License within the LICENSE file.
 
 #include <tev/Image.h>
+#include <tev/ImageCanvas.h>
 #include <tev/ImageViewer.h>
 #include <tev/Ipc.h>
 #include <tev/ThreadPool.h>
+#include <tev/Trace.h>
+
+#include <tev/imageio/ImageSaver.h>
 
 #include <args.hxx>
 #include <ImfThreading.h>
@@ -17,7 +21,9 @@
 #endif
 
 #include <chrono>
+#include <fstream>
 #include <iostream>
+#include <mutex>
 #include <thread>
 
 using namespace args;
@@ -49,90 +55,181 @@ void redrawWindow() {
     }
 }
 
-void handleIpcPacket(const IpcPacket& packet, const std::shared_ptr<BackgroundImagesLoader>& imagesLoader) {
-    switch (packet.type()) {
-        case IpcPacket::OpenImage:
-        case IpcPacket::OpenImageV2: {
-            auto info = packet.interpretAsOpenImage();
-            imagesLoader->enqueue(toPath(info.imagePath), ensureUtf8(info.channelSelector), info.grabFocus);
-            break;
+// Aggregation stage between Ipc and ImageViewer: a progressive renderer can
+// stream far more UpdateImage tiles per second than tev can display, and one
+// UI-thread task per tile drowns the main loop. Arriving packets are queued
+// here and drained in a single task per frame; dirty regions coalesce in
+// Image::updateChannel and statistics invalidation (via the image viewer's
+// bump set) fires at most once per frame no matter the tile rate.
+//
+// Every image-mutating packet flows through this queue, not just updates:
+// a renderer restart interleaves CreateImage resets with tiles of the old
+// and new frame, and applying them in any order other than arrival order
+// would blit fresh tiles onto a stale image (or stale tiles onto a fresh
+// one).
+static struct {
+    mutex mutex;
+    vector<shared_ptr<IpcPacket>> packets;
+    bool drainScheduled = false;
+} sPendingImagePackets;
+
+// Applies a previously queued UpdateImage packet. Must run on the UI thread.
+static void applyUpdateImagePacket(const IpcPacket& packet, const shared_ptr<Ipc>& ipc) {
+    trace::Span span{"ipc: image update"};
+
+    auto info = packet.interpretAsUpdateImage();
+
+    SharedMemoryRing* ring = nullptr;
+    span<const float> pixels = info.stridedImageData;
+    if (packet.type() == IpcPacket::UpdateImageShm) {
+        ring = ipc->openShmRing(string{info.shmRingName});
+        const char* shmData = ring ? ring->at(info.shmOffset, info.shmSize) : nullptr;
+        if (!shmData) {
+            return;
         }
 
+        pixels = {(const float*)shmData, (size_t)(info.shmSize / sizeof(float))};
+    }
+
+    string imageString = ensureUtf8(string{info.imageName});
+    for (int i = 0; i < info.nChannels; ++i) {
+        sImageViewer->updateImage(
+            imageString, info.grabFocus, string{info.channelNames[i]}, info.x, info.y, info.width, info.height,
+            pixels.data() + info.channelOffsets[i], info.channelStrides[i]
+        );
+    }
+
+    // Release the ring space only once the pixels have been copied into
+    // their channels.
+    if (ring) {
+        ring->pop(info.shmOffset, info.shmSize);
+    }
+}
+
+// Applies a previously queued image-mutating packet. Must run on the UI thread.
+static void applyImagePacket(const IpcPacket& packet, const shared_ptr<Ipc>& ipc) {
+    switch (packet.type()) {
         case IpcPacket::ReloadImage: {
-            while (!imageViewerIsReady) { }
             auto info = packet.interpretAsReloadImage();
-            sImageViewer->scheduleToUiThread([&, info] {
-                sImageViewer->reloadImage(ensureUtf8(info.imageName), info.grabFocus);
-            });
-
-            sImageViewer->redraw();
+            sImageViewer->reloadImage(ensureUtf8(info.imageName), info.grabFocus);
             break;
         }
 
         case IpcPacket::CloseImage: {
-            while (!imageViewerIsReady) { }
             auto info = packet.interpretAsCloseImage();
-            sImageViewer->scheduleToUiThread([&, info] {
-                sImageViewer->removeImage(ensureUtf8(info.imageName));
-            });
-
-            sImageViewer->redraw();
+            sImageViewer->removeImage(ensureUtf8(info.imageName));
             break;
         }
 
         case IpcPacket::UpdateImage:
         case IpcPacket::UpdateImageV2:
-        case IpcPacket::UpdateImageV3: {
-            while (!imageViewerIsReady) { }
-            auto info = packet.interpretAsUpdateImage();
-            sImageViewer->scheduleToUiThread([&, info] {
-                string imageString = ensureUtf8(info.imageName);
-                for (int i = 0; i < info.nChannels; ++i) {
-                    sImageViewer->updateImage(imageString, info.grabFocus, info.channelNames[i], info.x, info.y, info.width, info.height, info.imageData[i]);
-                }
-            });
-
-            sImageViewer->redraw();
+        case IpcPacket::UpdateImageV3:
+        case IpcPacket::UpdateImageShm: {
+            applyUpdateImagePacket(packet, ipc);
             break;
         }
 
         case IpcPacket::CreateImage: {
-            while (!imageViewerIsReady) { }
             auto info = packet.interpretAsCreateImage();
-            sImageViewer->scheduleToUiThread([&, info] {
-                stringstream imageStream;
-                imageStream
-                    << "empty" << " "
-                    << info.width << " "
-                    << info.height << " "
-                    << info.nChannels << " "
-                    ;
-                for (int i = 0; i < info.nChannels; ++i) {
-                    // The following lines encode strings by prefixing their length.
-                    // The reason for using this encoding is to allow  arbitrary characters,
-                    // including whitespaces, in the channel names.
-                    imageStream << info.channelNames[i].length() << info.channelNames[i];
-                }
+            stringstream imageStream;
+            imageStream
+                << "empty" << " "
+                << info.width << " "
+                << info.height << " "
+                << info.nChannels << " "
+                ;
+            for (int i = 0; i < info.nChannels; ++i) {
+                // The following lines encode strings by prefixing their length.
+                // The reason for using this encoding is to allow  arbitrary characters,
+                // including whitespaces, in the channel names.
+                imageStream << info.channelNames[i].length() << info.channelNames[i];
+            }
 
-                auto images = tryLoadImage(toPath(info.imageName), imageStream, "").get();
-                if (!images.empty()) {
-                    sImageViewer->replaceImage(ensureUtf8(info.imageName), images.front(), info.grabFocus);
-                    TEV_ASSERT(images.size() == 1, "IPC CreateImage should never create more than 1 image at once.");
-                }
-            });
+            auto images = tryLoadImage(toPath(info.imageName), imageStream, "").get();
+            if (!images.empty()) {
+                sImageViewer->replaceImage(ensureUtf8(info.imageName), images.front(), info.grabFocus);
+                TEV_ASSERT(images.size() == 1, "IPC CreateImage should never create more than 1 image at once.");
+            }
+            break;
+        }
+
+        case IpcPacket::VectorGraphics: {
+            auto info = packet.interpretAsVectorGraphics();
+            sImageViewer->updateImageVectorGraphics(ensureUtf8(info.imageName), info.grabFocus, info.append, info.commands);
+            break;
+        }
+
+        default: {
+            throw runtime_error{fmt::format("Non-image packet type {} in image packet queue", (int)packet.type())};
+        }
+    }
+}
 
-            sImageViewer->redraw();
+void handleIpcPacket(IpcPacket packet, const std::shared_ptr<Ipc>& ipc, const std::shared_ptr<BackgroundImagesLoader>& imagesLoader) {
+    trace::Span span{"ipc: packet"};
+
+    switch (packet.type()) {
+        case IpcPacket::OpenImage:
+        case IpcPacket::OpenImageV2: {
+            auto info = packet.interpretAsOpenImage();
+            imagesLoader->enqueue(toPath(info.imagePath), ensureUtf8(info.channelSelector), info.grabFocus);
             break;
         }
 
+        case IpcPacket::ReloadImage:
+        case IpcPacket::CloseImage:
+        case IpcPacket::UpdateImage:
+        case IpcPacket::UpdateImageV2:
+        case IpcPacket::UpdateImageV3:
+        case IpcPacket::UpdateImageShm:
+        case IpcPacket::CreateImage:
         case IpcPacket::VectorGraphics: {
             while (!imageViewerIsReady) { }
-            auto info = packet.interpretAsVectorGraphics();
-            sImageViewer->scheduleToUiThread([&, info] {
-                sImageViewer->updateImageVectorGraphics(ensureUtf8(info.imageName), info.grabFocus, info.append, info.commands);
-            });
+            // Ownership of the packet moves into the pending queue and
+            // interpretation — which for updates references the packet's
+            // payload (or a shared-memory ring) rather than copying each
+            // channel's pixels — happens on the UI thread when the queue is
+            // drained. At most one drain task is in flight at a time.
+            bool shallScheduleDrain;
+            {
+                lock_guard lock{sPendingImagePackets.mutex};
+                sPendingImagePackets.packets.push_back(make_shared<IpcPacket>(std::move(packet)));
+                shallScheduleDrain = !sPendingImagePackets.drainScheduled;
+                sPendingImagePackets.drainScheduled = true;
+            }
 
-            sImageViewer->redraw();
+            if (shallScheduleDrain) {
+                sImageViewer->scheduleToUiThread([ipc] {
+                    vector<shared_ptr<IpcPacket>> packets;
+                    {
+                        lock_guard lock{sPendingImagePackets.mutex};
+                        packets.swap(sPendingImagePackets.packets);
+                        sPendingImagePackets.drainScheduled = false;
+                    }
+
+                    for (const auto& packet : packets) {
+                        // Interpretation runs here rather than on the IPC
+                        // thread, so it needs the same handler that wraps
+                        // handleIpcPacket there: a malformed packet from a
+                        // buggy client must produce a warning, not unwind
+                        // the UI main loop.
+                        try {
+                            applyImagePacket(*packet, ipc);
+                        } catch (const runtime_error& e) {
+                            tlog::warning() << "Malformed IPC packet: " << e.what();
+                        }
+                    }
+                });
+
+                sImageViewer->redraw();
+            }
+            break;
+        }
+
+        case IpcPacket::CompressedPacket: {
+            // Decompressing here keeps inflate work on the IPC thread rather
+            // than the UI thread.
+            handleIpcPacket(packet.decompress(), ipc, imagesLoader);
             break;
         }
 
@@ -142,6 +239,233 @@ void handleIpcPacket(const IpcPacket& packet, const std::shared_ptr<BackgroundIm
     }
 }
 
+// Display and output settings of the headless batch mode. One immutable copy
+// is shared by all in-flight frame tasks.
+struct BatchSettings {
+    float exposure = 0;
+    float offset = 0;
+    float gamma = 2.2f;
+    ETonemap tonemap = ETonemap::SRGB;
+    bool emitStats = false;
+    fs::path thumbnailDir; // Empty if no thumbnails were requested.
+    int thumbnailSize = 256;
+};
+
+static string jsonEscaped(const string& str) {
+    string result;
+    result.reserve(str.size());
+    for (char c : str) {
+        switch (c) {
+            case '"': result += "\\\""; break;
+            case '\\': result += "\\\\"; break;
+            default:
+                if ((unsigned char)c < 0x20) {
+                    result += fmt::format("\\u{:04x}", (int)(unsigned char)c);
+                } else {
+                    result += c;
+                }
+        }
+    }
+
+    return result;
+}
+
+// JSON has no representation for non-finite numbers; emit null instead so a
+// frame of NaNs does not corrupt the whole stats document.
+static string jsonNumber(float value) {
+    return isfinite(value) ? fmt::format("{}", value) : "null";
+}
+
+// Box-averages interleaved RGBA bytes such that the longer image axis becomes
+// at most `maxDim` pixels. Aspect ratio is preserved; images that already fit
+// pass through unchanged.
+static vector<char> downscaleLdrImage(vector<char>&& data, const nanogui::Vector2i& size, int maxDim, nanogui::Vector2i& outSize) {
+    int longerAxis = max(size.x(), size.y());
+    if (longerAxis <= maxDim) {
+        outSize = size;
+        return std::move(data);
+    }
+
+    outSize = {max(size.x() * maxDim / longerAxis, 1), max(size.y() * maxDim / longerAxis, 1)};
+
+    vector<char> result(4 * (size_t)outSize.x() * outSize.y());
+    ThreadPool::global().parallelFor(0, outSize.y(), [&](int y) {
+        int yBegin = y * size.y() / outSize.y(), yEnd = max((y + 1) * size.y() / outSize.y(), yBegin + 1);
+        for (int x = 0; x < outSize.x(); ++x) {
+            int xBegin = x * size.x() / outSize.x(), xEnd = max((x + 1) * size.x() / outSize.x(), xBegin + 1);
+
+            uint32_t sum[4] = {};
+            for (int sy = yBegin; sy < yEnd; ++sy) {
+                for (int sx = xBegin; sx < xEnd; ++sx) {
+                    const char* pixel = data.data() + 4 * ((size_t)sy * size.x() + sx);
+                    for (int c = 0; c < 4; ++c) {
+                        sum[c] += (unsigned char)pixel[c];
+                    }
+                }
+            }
+
+            uint32_t count = (uint32_t)(yEnd - yBegin) * (xEnd - xBegin);
+            char* pixel = result.data() + 4 * ((size_t)y * outSize.x() + x);
+            for (int c = 0; c < 4; ++c) {
+                pixel[c] = (char)(unsigned char)((sum[c] + count / 2) / count);
+            }
+        }
+    }, std::numeric_limits<int>::max());
+
+    return result;
+}
+
+static Task<void> saveBatchThumbnail(shared_ptr<Image> image, fs::path path, const BatchSettings& settings) {
+    for (const auto& saver : ImageSaver::getSavers()) {
+        if (!saver->canSaveFile(path)) {
+            continue;
+        }
+
+        const auto* ldrSaver = dynamic_cast<const TypedImageSaver<char>*>(saver.get());
+        if (!ldrSaver) {
+            continue;
+        }
+
+        // Thumbnails are rendered for the image's first channel group — the
+        // same group the viewer would select upon opening the image.
+        const string& groupName = image->channelGroups().empty() ? "" : image->channelGroups().front().name;
+        auto rowSource = ImageCanvas::ldrImageDataRowSource(
+            image, nullptr, groupName, EMetric::Error, settings.exposure, settings.offset, settings.gamma,
+            settings.tonemap, EColorMap::Turbo, !saver->hasPremultipliedAlpha(), std::numeric_limits<int>::max()
+        );
+
+        if (!rowSource) {
+            throw invalid_argument{"Image has no channels to save."};
+        }
+
+        vector<char> data(4 * (size_t)image->size().x() * image->size().y());
+        rowSource(data.data(), 0, image->size().y());
+
+        nanogui::Vector2i thumbnailSize;
+        data = downscaleLdrImage(std::move(data), image->size(), settings.thumbnailSize, thumbnailSize);
+
+        co_await ThreadPool::globalIo().enqueueCoroutine(std::numeric_limits<int>::max());
+
+        ofstream f{path, ios_base::binary};
+        if (!f) {
+            throw invalid_argument{fmt::format("Could not open file {}", path)};
+        }
+
+        ldrSaver->save(f, path, data, thumbnailSize, 4);
+        co_return;
+    }
+
+    throw invalid_argument{fmt::format("No save routine for image type {} found.", path.extension())};
+}
+
+// Loads one file and emits its statistics JSON and/or thumbnails. Errors are
+// logged rather than propagated: one bad frame must not kill a batch job.
+static Task<void> batchProcessFile(fs::path path, string channelSelector, shared_ptr<const BatchSettings> settings, string* statsJson) {
+    try {
+        auto images = co_await tryLoadImage(path, channelSelector);
+
+        vector<string> imageJsons;
+        for (size_t i = 0; i < images.size(); ++i) {
+            const auto& image = images[i];
+
+            if (settings->emitStats) {
+                vector<string> groupJsons;
+                for (const auto& group : image->channelGroups()) {
+                    auto stats = co_await ImageCanvas::computeCanvasStatistics(
+                        image, nullptr, group.name, EMetric::Error, Box2i{image->size()}, 1, std::numeric_limits<int>::max()
+                    );
+
+                    groupJsons.push_back(fmt::format(
+                        "{{\"name\":\"{}\",\"n_channels\":{},\"minimum\":{},\"mean\":{},\"maximum\":{}}}",
+                        jsonEscaped(group.name), stats->nChannels, jsonNumber(stats->minimum), jsonNumber(stats->mean), jsonNumber(stats->maximum)
+                    ));
+                }
+
+                imageJsons.push_back(fmt::format(
+                    "{{\"name\":\"{}\",\"width\":{},\"height\":{},\"groups\":[{}]}}",
+                    jsonEscaped(image->name()), image->size().x(), image->size().y(), join(groupJsons, ",")
+                ));
+            }
+
+            if (!settings->thumbnailDir.empty()) {
+                string base = image->shortName();
+                if (auto dot = base.find_last_of('.'); dot != string::npos) {
+                    base = base.substr(0, dot);
+                }
+
+                // Multi-part files yield several images per path; suffix all
+                // but the first with their index to keep filenames unique.
+                fs::path thumbnailPath = settings->thumbnailDir / toPath(i == 0 ? base + ".png" : fmt::format("{}.{}.png", base, i));
+                co_await saveBatchThumbnail(image, thumbnailPath, *settings);
+            }
+        }
+
+        *statsJson = join(imageJsons, ",");
+    } catch (const exception& e) {
+        tlog::error() << fmt::format("Failed to process {}: {}", path, e.what());
+    }
+}
+
+// Headless batch mode: loads the given images without ever initializing GLFW,
+// nanogui, or IPC, then emits per-channel-group statistics as JSON and/or
+// tonemapped LDR thumbnails. Startup cost is just the thread pools, so
+// render-farm automation can afford to invoke this once per frame.
+static int batchMain(const vector<pair<fs::path, string>>& files, const shared_ptr<const BatchSettings>& settings, const string& statsTarget) {
+    if (files.empty()) {
+        tlog::error() << "Batch mode requires at least one image file.";
+        return -4;
+    }
+
+    if (!settings->thumbnailDir.empty()) {
+        fs::create_directories(settings->thumbnailDir);
+    }
+
+    // One eagerly started task per file: frames fan out across the thread
+    // pool, while awaiting them in submission order keeps the JSON output
+    // deterministic regardless of completion order.
+    vector<string> statsJsons(files.size());
+    vector<Task<void>> tasks;
+    tasks.reserve(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        tasks.push_back(batchProcessFile(files[i].first, files[i].second, settings, &statsJsons[i]));
+    }
+
+    waitAll(tasks);
+
+    if (settings->emitStats) {
+        string json = "[";
+        bool first = true;
+        for (const auto& statsJson : statsJsons) {
+            if (statsJson.empty()) {
+                continue;
+            }
+
+            if (!first) {
+                json += ",";
+            }
+
+            first = false;
+            json += statsJson;
+        }
+
+        json += "]\n";
+
+        if (statsTarget == "-") {
+            cout << json;
+        } else {
+            ofstream f{toPath(statsTarget)};
+            if (!f) {
+                tlog::error() << fmt::format("Could not open file {}", statsTarget);
+                return -4;
+            }
+
+            f << json;
+        }
+    }
+
+    return 0;
+}
+
 int mainFunc(const vector<string>& arguments) {
     ArgumentParser parser{
         "tev — The EXR Viewer\n"
@@ -174,6 +498,14 @@ int mainFunc(const vector<string>& arguments) {
         {'g', "gamma"},
     };
 
+    Flag halfFlag{
+        parser,
+        "HALF",
+        "Store image channels with half-float (16-bit) precision in memory when the source data "
+        "is half precision, halving RAM usage for large image collections.",
+        {"half"},
+    };
+
     HelpFlag helpFlag{
         parser,
         "HELP",
@@ -197,6 +529,15 @@ int mainFunc(const vector<string>& arguments) {
         {"ldr"},
     };
 
+    ValueFlag<float> maxMemoryFlag{
+        parser,
+        "MAX MEMORY",
+        "Memory budget for loaded images in gibibytes. When the budget is exceeded, the least "
+        "recently viewed images' pixel data and textures are evicted and transparently reloaded "
+        "from disk on the next access. Default is 0 (no budget).",
+        {"max-memory"},
+    };
+
     Flag maximizeFlagOn{parser, "MAXIMIZE", "Maximize the window on startup. (Default if images are supplied.)", {"max", "maximize"}};
     Flag maximizeFlagOff{parser, "NO MAXIMIZE", "Do not maximize the window on startup. (Default if no images are supplied.)", {"no-max", "no-maximize"}};
 
@@ -244,6 +585,30 @@ int mainFunc(const vector<string>& arguments) {
         {'r', "recursive"},
     };
 
+    ValueFlag<string> statsFlag{
+        parser,
+        "STATS FILE",
+        "Run headlessly — without opening a window or initializing graphics — and write "
+        "per-channel-group statistics (minimum, mean, maximum) of the supplied images "
+        "as JSON to STATS FILE. Pass '-' to write to standard output.",
+        {"stats"},
+    };
+
+    ValueFlag<string> thumbnailsFlag{
+        parser,
+        "THUMBNAIL DIR",
+        "Run headlessly and save a tonemapped PNG thumbnail of each supplied image to "
+        "THUMBNAIL DIR, honoring EXPOSURE, OFFSET, GAMMA, and TONEMAP.",
+        {"thumbnails"},
+    };
+
+    ValueFlag<int> thumbnailSizeFlag{
+        parser,
+        "THUMBNAIL SIZE",
+        "Maximum extent in pixels of thumbnails generated via THUMBNAIL DIR. Default is 256.",
+        {"thumbnail-size"},
+    };
+
     Flag versionFlag{
         parser,
         "VERSION",
@@ -294,6 +659,44 @@ int mainFunc(const vector<string>& arguments) {
         return 0;
     }
 
+    if (halfFlag) {
+        Channel::setHalfPrecisionStorage(true);
+    }
+
+    // The headless batch mode never touches IPC, GLFW, or nanogui: farm-side
+    // automation invokes tev once per frame and cares about startup latency,
+    // not about a window.
+    if (statsFlag || thumbnailsFlag) {
+        // Size OpenEXR's internal pool like our own, such that EXR loads
+        // parallelize their decompression work across all cores.
+        Imf::setGlobalThreadCount((int)ThreadPool::global().numThreads());
+
+        auto settings = make_shared<BatchSettings>();
+        if (exposureFlag) { settings->exposure = get(exposureFlag); }
+        if (offsetFlag)   { settings->offset = get(offsetFlag); }
+        if (gammaFlag)    { settings->gamma = get(gammaFlag); }
+        if (tonemapFlag)  { settings->tonemap = toTonemap(get(tonemapFlag)); }
+
+        settings->emitStats = (bool)statsFlag;
+        if (thumbnailsFlag) { settings->thumbnailDir = toPath(get(thumbnailsFlag)); }
+        if (thumbnailSizeFlag) { settings->thumbnailSize = max(get(thumbnailSizeFlag), 1); }
+
+        // Resolve the ':'-prefixed channel selector convention of the
+        // positional arguments, exactly as the windowed mode does below.
+        vector<pair<fs::path, string>> files;
+        string channelSelector;
+        for (auto imageFile : get(imageFiles)) {
+            if (!imageFile.empty() && imageFile[0] == ':') {
+                channelSelector = imageFile.substr(1);
+                continue;
+            }
+
+            files.emplace_back(toPath(imageFile), channelSelector);
+        }
+
+        return batchMain(files, settings, statsFlag ? get(statsFlag) : "");
+    }
+
     auto ipc = hostnameFlag ? make_shared<Ipc>(get(hostnameFlag)) : make_shared<Ipc>();
 
     // If we don't have any images to load, create new windows regardless of flag.
@@ -343,7 +746,9 @@ int mainFunc(const vector<string>& arguments) {
         return 0;
     }
 
-    Imf::setGlobalThreadCount(thread::hardware_concurrency());
+    // Size OpenEXR's internal pool like our own, such that EXR loads and
+    // saves parallelize their compression work across all cores.
+    Imf::setGlobalThreadCount((int)ThreadPool::global().numThreads());
 
     shared_ptr<BackgroundImagesLoader> imagesLoader = make_shared<BackgroundImagesLoader>();
     if (recursiveFlag) {
@@ -396,15 +801,18 @@ int mainFunc(const vector<string>& arguments) {
                     continue;
                 }
 
-                ipc->receiveFromSecondaryInstance([&](const IpcPacket& packet) {
+                ipc->receiveFromSecondaryInstance([&](IpcPacket packet) {
                     try {
-                        handleIpcPacket(packet, imagesLoader);
+                        handleIpcPacket(std::move(packet), ipc, imagesLoader);
                     } catch (const runtime_error& e) {
                         tlog::warning() << "Malformed IPC packet: " << e.what();
                     }
                 });
 
-                this_thread::sleep_for(10ms);
+                // Rather than polling on a fixed interval, sleep in the kernel until
+                // a packet (or connection) actually arrives. The timeout merely bounds
+                // how long it takes to notice the shutdown flag.
+                ipc->waitForData(100ms);
             }
         } catch (const runtime_error& e) {
             tlog::warning() << "Uncaught exception in IPC thread: " << e.what();
@@ -508,6 +916,7 @@ int mainFunc(const vector<string>& arguments) {
     if (exposureFlag) { sImageViewer->setExposure(get(exposureFlag)); }
     if (filterFlag)   { sImageViewer->setFilter(get(filterFlag)); }
     if (gammaFlag)    { sImageViewer->setGamma(get(gammaFlag)); }
+    if (maxMemoryFlag) { sImageViewer->setMemoryBudget((size_t)(get(maxMemoryFlag) * 1024 * 1024 * 1024)); }
     if (metricFlag)   { sImageViewer->setMetric(toMetric(get(metricFlag))); }
     if (offsetFlag)   { sImageViewer->setOffset(get(offsetFlag)); }
     if (tonemapFlag)  { sImageViewer->setTonemap(toTonemap(get(tonemapFlag))); }
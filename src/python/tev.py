@@ -216,11 +216,17 @@ class Ipc:
         Updates the pixel values of a specified image region and a specified set of channels.
         The `image` parameter must be laid out in row-major format, i.e. from most to least
         significant: [row][col][channel], where the channel axis is optional.
+
+        A C-contiguous little-endian float32 numpy array is sent without any conversion
+        or copy on the Python side; pass `perform_tiling=False` to ship a full frame as
+        a single such packet. Other dtypes and layouts are converted per tile first.
     """
     def update_image(self, name: str, image, channel_names = ["R", "G", "B", "A"], x = 0, y = 0, grab_focus = False, perform_tiling = True):
         if self._socket is None:
             raise Exception("Communication was not started")
 
+        image = np.asarray(image)
+
         # Break down image into tiles of manageable size for typical TCP packets
         tile_size = [128, 128] if perform_tiling else image.shape[0:2]
 
@@ -240,8 +246,13 @@ class Ipc:
                     ...
                 ]
 
-                tile_dense = np.full_like(tile, 0.0, dtype="<f")
-                tile_dense[...] = tile[...]
+                # Fast path: a tile that is already densely packed little-endian
+                # float32 matches the wire layout described by channel_offsets and
+                # channel_strides, so its buffer is appended as-is.
+                if tile.dtype == np.dtype("<f4") and tile.flags["C_CONTIGUOUS"]:
+                    tile_dense = tile
+                else:
+                    tile_dense = np.ascontiguousarray(tile, dtype="<f4")
 
                 data_bytes = bytearray()
                 data_bytes.extend(struct.pack("<I", 0)) # reserved for length
@@ -265,10 +276,21 @@ class Ipc:
                 for channel_stride in channel_strides:
                     data_bytes.extend(struct.pack("<q", channel_stride))
 
-                data_bytes.extend(tile_dense.tobytes()) # data
-
-                data_bytes[0:4] = struct.pack("<I", len(data_bytes))
-                self._socket.sendall(data_bytes)
+                data_bytes[0:4] = struct.pack("<I", len(data_bytes) + tile_dense.nbytes)
+
+                pixel_bytes = memoryview(tile_dense).cast("B")
+                if hasattr(self._socket, "sendmsg"):
+                    # Scatter-gather send; header and pixel buffer are never
+                    # concatenated in memory.
+                    sent = self._socket.sendmsg([data_bytes, pixel_bytes])
+                    if sent < len(data_bytes) + pixel_bytes.nbytes:
+                        # Rare short send (e.g. interrupted by a signal);
+                        # finish off the remainder.
+                        remainder = (bytes(data_bytes) + pixel_bytes.tobytes())[sent:]
+                        self._socket.sendall(remainder)
+                else:
+                    # Windows lacks sendmsg; pay one concatenation copy instead.
+                    self._socket.sendall(bytes(data_bytes) + pixel_bytes.tobytes())
 
     """
         Draws vector graphics over the specified image. The vector graphics are